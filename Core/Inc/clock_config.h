@@ -32,8 +32,30 @@ extern "C" {
 #define USE_HSI_84MHZ    1
 /* Default: 168MHz HSE configuration */
 
+/* 1: clock_perf_set() scales HCLK at runtime, 0: it stays at the boot clock */
+#define USE_CLOCK_PERF   1
+
+/* Exported types ------------------------------------------------------------*/
+/* CLOCK_PERF_HIGH is the configuration above. CLOCK_PERF_LOW divides HCLK
+ * down to the APB1 clock and runs both APB buses undivided, so PCLK1 (SPI2,
+ * USART2) keeps its rate and only PCLK2 and the APB1 timers slow down. */
+typedef enum {
+  CLOCK_PERF_LOW = 0,
+  CLOCK_PERF_HIGH,
+  CLOCK_PERF_COUNT
+} clock_perf_t;
+
+typedef struct {
+  uint32_t ms[CLOCK_PERF_COUNT];  /* time spent at each level */
+  uint32_t switches;
+} clock_perf_stats_t;
+
 /* Exported functions prototypes ---------------------------------------------*/
 void SystemClock_Config(void);
+void clock_perf_init(void (*on_change)(void));
+void clock_perf_set(clock_perf_t level);
+clock_perf_t clock_perf_get(void);
+void clock_perf_take_stats(clock_perf_stats_t *stats);
 
 #ifdef __cplusplus
 }
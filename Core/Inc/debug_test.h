@@ -0,0 +1,39 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file           : debug_test.h
+  * @brief          : Self-test helpers shared by the module tests
+  ******************************************************************************
+  * @attention
+  *
+  * A module test is built with its <MODULE>_TEST switch and returns 0 when it
+  * passes, or the __LINE__ of the first check that failed. The firmware
+  * reports the result with debug_test_report(), the host runner in tests/
+  * turns it into an exit code. Only depends on the C library so that the
+  * modules without LVGL can use it.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __DEBUG_TEST_H__
+#define __DEBUG_TEST_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported macro ------------------------------------------------------------*/
+/* Leave the test with the failing line number */
+#define TEST_CHECK(c)   do{ if(!(c)) return __LINE__; }while(0)
+
+/* Exported functions prototypes ---------------------------------------------*/
+void debug_test_report(const char * name, uint32_t failed_line);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DEBUG_TEST_H__ */
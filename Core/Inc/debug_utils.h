@@ -25,6 +25,7 @@ extern "C" {
 
 /* Includes ------------------------------------------------------------------*/
 #include "lvgl.h"
+#include "debug_test.h"
 
 /* Exported functions prototypes ---------------------------------------------*/
 void my_log_cb(lv_log_level_t level, const char * buf);
@@ -0,0 +1,39 @@
+/**
+  ******************************************************************************
+  * @file           : idle.h
+  * @brief          : Low power wait of the main loop
+  ******************************************************************************
+  */
+
+#ifndef __IDLE_H__
+#define __IDLE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "idle_sched.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* 1: stop the 1 ms tick while nothing is due, 0: WFI until the next tick */
+#define USE_TICKLESS_IDLE       1
+
+#define IDLE_MIN_TICKLESS_MS    3       /* shorter waits keep the tick */
+#define IDLE_MAX_SLEEP_MS       60000   /* longest tickless wait */
+
+/* Exported functions prototypes ---------------------------------------------*/
+void idle_init(void);
+void idle_wait(uint32_t lv_next);
+void idle_notify(void);
+void idle_clock_prepare(void);
+void idle_clock_update(void);
+void idle_take_stats(idle_sched_stats_t *stats);
+void idle_wake_irq_handler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __IDLE_H__ */
@@ -0,0 +1,76 @@
+/**
+  ******************************************************************************
+  * @file           : idle_sched.h
+  * @brief          : Sleep decision of the main loop
+  ******************************************************************************
+  * Decides how long the main loop may sleep and in which mode, and turns
+  * the time measured by the wake timer back into 1 ms ticks. No hardware
+  * access: the caller feeds the deadlines and the measured times, so it
+  * runs the same on the host with a simulated clock.
+  ******************************************************************************
+  */
+
+#ifndef __IDLE_SCHED_H__
+#define __IDLE_SCHED_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* 1: idle_sched_test() is built, it runs a countdown on a simulated clock */
+#ifndef IDLE_SCHED_TEST
+#define IDLE_SCHED_TEST     0
+#endif
+
+/* Deadline of a source that has nothing scheduled, same value as
+ * LV_NO_TIMER_READY and TIMER_NO_DEADLINE */
+#define IDLE_NO_DEADLINE    UINT32_MAX
+
+/* Length of a tick in wake timer units */
+#define IDLE_TICK_US        1000U
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum {
+  IDLE_RUN = 0,       /* something is due, don't sleep */
+  IDLE_SLEEP,         /* WFI, the next tick wakes the CPU */
+  IDLE_TICKLESS       /* WFI with the tick stopped until the deadline or an IRQ */
+} idle_mode_t;
+
+typedef struct {
+  uint32_t sleeps;        /* IDLE_SLEEP waits */
+  uint32_t tickless;      /* IDLE_TICKLESS waits */
+  uint32_t early;         /* tickless waits cut short by an interrupt */
+  uint32_t slept;         /* ticks spent in tickless waits */
+} idle_sched_stats_t;
+
+typedef struct {
+  uint32_t min_tickless;  /* shorter waits keep the tick running */
+  uint32_t max_sleep;     /* longest tickless wait, also used with no deadline */
+  uint32_t planned;       /* ticks of the current tickless wait */
+  uint32_t start_us;      /* part of a tick already gone when it started */
+  uint32_t carry_us;      /* part of a tick left over by the last one */
+  idle_sched_stats_t stats;
+} idle_sched_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void idle_sched_init(idle_sched_t *s, uint32_t min_tickless, uint32_t max_sleep);
+idle_mode_t idle_sched_plan(idle_sched_t *s, uint32_t lv_next, uint32_t timer_next, bool pending);
+uint32_t idle_sched_wake_us(idle_sched_t *s, uint32_t phase_us);
+uint32_t idle_sched_account(idle_sched_t *s, uint32_t slept_us);
+uint32_t idle_sched_tick_restart(idle_sched_t *s, uint32_t phase_us);
+void idle_sched_take_stats(idle_sched_t *s, idle_sched_stats_t *stats);
+
+#if IDLE_SCHED_TEST
+uint32_t idle_sched_test(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __IDLE_SCHED_H__ */
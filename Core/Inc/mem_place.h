@@ -0,0 +1,38 @@
+/**
+  ******************************************************************************
+  * @file           : mem_place.h
+  * @brief          : Section attributes for CCMRAM and DMA buffer placement
+  ******************************************************************************
+  * CCMRAM (0x10000000, 64 KB) is zero-wait for the CPU but sits outside the
+  * bus matrix, the DMA controllers can't reach it. Put CPU-only data there
+  * and tag every DMA source and destination with DMA_BUFFER. Give these
+  * objects a global, unique name and add a check for it to both linker
+  * scripts (STM32F407VGTX_FLASH.ld, STM32F407VGTX_RAM.ld): the link then
+  * fails if one of them ends up in CCMRAM.
+  ******************************************************************************
+  */
+
+#ifndef __MEM_PLACE_H__
+#define __MEM_PLACE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Initialized data in CCMRAM, copied from flash by the startup code */
+#define CCM_DATA        __attribute__((section(".ccmram")))
+
+/* Zero-initialized data in CCMRAM, cleared by the startup code */
+#define CCM_BSS         __attribute__((section(".ccmbss")))
+
+/* CCMRAM left as it is at reset, for buffers that are set up before use */
+#define CCM_NOINIT      __attribute__((section(".ccmnoinit")))
+
+/* DMA source or destination, kept in main SRAM and not cleared at reset */
+#define DMA_BUFFER      __attribute__((section(".dma_buffer")))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MEM_PLACE_H__ */
@@ -17,11 +17,22 @@
   */
 
 /* Includes ------------------------------------------------------------------*/
+#include <string.h>
 #include "clock_config.h"
 #include "main.h"
+#include "idle.h"
+
+/* Private variables ---------------------------------------------------------*/
+static RCC_ClkInitTypeDef perf_clk[CLOCK_PERF_COUNT];
+static uint32_t perf_latency[CLOCK_PERF_COUNT];
+static clock_perf_t perf_level = CLOCK_PERF_HIGH;
+static uint32_t perf_since;
+static clock_perf_stats_t perf_stats;
+static void (*perf_on_change)(void);
 
 /* Private function prototypes -----------------------------------------------*/
 static void Configure_Power_And_Voltage(void);
+static uint32_t Perf_AHB_Divider(uint32_t apb_div);
 static HAL_StatusTypeDef Configure_HSI_16MHz(void);
 static HAL_StatusTypeDef Configure_HSE_84MHz(void);
 static HAL_StatusTypeDef Configure_HSE_168MHz(void);
@@ -153,6 +164,23 @@ static HAL_StatusTypeDef Configure_HSE_168MHz(void)
   return HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_5);
 }
 
+/**
+  * @brief  AHB divider that brings HCLK down to what an APB divider makes of it
+  * @param  apb_div: RCC_HCLK_DIVx
+  * @retval RCC_SYSCLK_DIVx
+  */
+static uint32_t Perf_AHB_Divider(uint32_t apb_div)
+{
+  switch (apb_div)
+  {
+    case RCC_HCLK_DIV2:  return RCC_SYSCLK_DIV2;
+    case RCC_HCLK_DIV4:  return RCC_SYSCLK_DIV4;
+    case RCC_HCLK_DIV8:  return RCC_SYSCLK_DIV8;
+    case RCC_HCLK_DIV16: return RCC_SYSCLK_DIV16;
+    default:             return RCC_SYSCLK_DIV1;
+  }
+}
+
 /* Exported functions --------------------------------------------------------*/
 
 /**
@@ -175,4 +203,103 @@ void SystemClock_Config(void)
   {
     Error_Handler();
   }
-}
\ No newline at end of file
+}
+
+/**
+  * @brief  Set up the performance levels from the clock configured at boot,
+  *         which is CLOCK_PERF_HIGH
+  * @param  on_change: called with interrupts disabled after HCLK changed,
+  *         for the peripherals on PCLK2 and the APB1 timers (can be NULL)
+  * @retval None
+  */
+void clock_perf_init(void (*on_change)(void))
+{
+  RCC_ClkInitTypeDef *low = &perf_clk[CLOCK_PERF_LOW];
+  uint32_t hclk_low;
+
+  HAL_RCC_GetClockConfig(&perf_clk[CLOCK_PERF_HIGH], &perf_latency[CLOCK_PERF_HIGH]);
+  perf_clk[CLOCK_PERF_HIGH].ClockType = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+
+  *low = perf_clk[CLOCK_PERF_HIGH];
+  perf_latency[CLOCK_PERF_LOW] = perf_latency[CLOCK_PERF_HIGH];
+
+  /* Only the undivided AHB of all three configurations is scaled */
+  if (USE_CLOCK_PERF && low->AHBCLKDivider == RCC_SYSCLK_DIV1)
+  {
+    low->AHBCLKDivider = Perf_AHB_Divider(low->APB1CLKDivider);
+    low->APB1CLKDivider = RCC_HCLK_DIV1;
+    low->APB2CLKDivider = RCC_HCLK_DIV1;
+
+    /* One wait state per 30 MHz at 2.7 V - 3.6 V */
+    hclk_low = HAL_RCC_GetPCLK1Freq();
+    perf_latency[CLOCK_PERF_LOW] = (hclk_low - 1U) / 30000000U;
+  }
+
+  perf_on_change = on_change;
+  perf_level = CLOCK_PERF_HIGH;
+  perf_since = HAL_GetTick();
+}
+
+/**
+  * @brief  Switch the performance level. The SysTick reload, the idle wake
+  *         timer and what on_change updates follow the new HCLK.
+  * @param  level: the new level
+  * @retval None
+  */
+void clock_perf_set(clock_perf_t level)
+{
+  uint32_t now;
+
+  if (level == perf_level || level >= CLOCK_PERF_COUNT)
+  {
+    return;
+  }
+
+  __disable_irq();
+
+  /* HAL_RCC_ClockConfig() restarts the SysTick through HAL_InitTick() */
+  idle_clock_prepare();
+  if (HAL_RCC_ClockConfig(&perf_clk[level], perf_latency[level]) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  idle_clock_update();
+
+  if (perf_on_change)
+  {
+    perf_on_change();
+  }
+
+  __enable_irq();
+
+  now = HAL_GetTick();
+  perf_stats.ms[perf_level] += now - perf_since;
+  perf_stats.switches++;
+  perf_since = now;
+  perf_level = level;
+}
+
+/**
+  * @brief  Get the current performance level
+  * @retval the level
+  */
+clock_perf_t clock_perf_get(void)
+{
+  return perf_level;
+}
+
+/**
+  * @brief  Copy the time spent at each level since the last call and clear it
+  * @param  stats: store them here
+  * @retval None
+  */
+void clock_perf_take_stats(clock_perf_stats_t *stats)
+{
+  uint32_t now = HAL_GetTick();
+
+  perf_stats.ms[perf_level] += now - perf_since;
+  perf_since = now;
+
+  *stats = perf_stats;
+  memset(&perf_stats, 0, sizeof(perf_stats));
+}
@@ -85,4 +85,21 @@ void create_touch_cursor(void)
 
     // Attach cursor as user data
     lv_timer_create(touch_cursor_cb, 30, cursor);
+}
+
+/**
+  * @brief  Log the result of a built-in self test and stop on a failure
+  * @param  name: Test name
+  * @param  failed_line: 0 if the test passed, else the line of the failed check
+  * @retval None
+  */
+void debug_test_report(const char * name, uint32_t failed_line)
+{
+    if(failed_line == 0) {
+        LV_LOG_USER("%s passed", name);
+    }
+    else {
+        LV_LOG_USER("%s FAILED at line %lu", name, (unsigned long)failed_line);
+    }
+    LV_ASSERT_MSG(failed_line == 0, name);
 }
\ No newline at end of file
@@ -0,0 +1,229 @@
+/**
+  ******************************************************************************
+  * @file           : idle.c
+  * @brief          : Low power wait of the main loop
+  ******************************************************************************
+  * The main loop sleeps in WFI until the next LVGL timer or countdown event.
+  * For longer waits the SysTick interrupt is switched off and the 32 bit
+  * TIM2, counting microseconds, wakes the CPU instead. The time it measured
+  * is added to the HAL and LVGL ticks on wakeup. The F407 has no LPTIM and
+  * its timers stop in Stop mode, so this is Sleep mode: the clocks and DMA
+  * keep running and any interrupt, a touch for one, ends the wait at once.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "idle.h"
+#include "main.h"
+#include "lvgl.h"
+#include "timer.h"
+
+/* Private define ------------------------------------------------------------*/
+#define IDLE_WAKE_TIM           TIM2
+#define IDLE_WAKE_TIM_IRQn      TIM2_IRQn
+
+/* Private variables ---------------------------------------------------------*/
+static idle_sched_t sched;
+static volatile bool notified;
+static uint32_t clock_phase_us;
+
+/* Private function prototypes -----------------------------------------------*/
+static void idle_timer_config(void);
+static uint32_t idle_tick_suspend(void);
+static void idle_tickless(void);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Set up the wake timer
+  * @retval None
+  */
+void idle_init(void)
+{
+  idle_sched_init(&sched, IDLE_MIN_TICKLESS_MS, IDLE_MAX_SLEEP_MS);
+
+  __HAL_RCC_TIM2_CLK_ENABLE();
+  idle_timer_config();
+
+  /* Only wakes WFI, the handler has nothing to do */
+  HAL_NVIC_SetPriority(IDLE_WAKE_TIM_IRQn, 3, 0);
+  HAL_NVIC_EnableIRQ(IDLE_WAKE_TIM_IRQn);
+
+#ifdef DEBUG
+  /* Keep the debugger connected while the core sleeps */
+  HAL_DBGMCU_EnableDBGSleepMode();
+#endif
+}
+
+/**
+  * @brief  Sleep until something is due
+  * @param  lv_next: return value of lv_timer_handler()
+  * @retval None
+  */
+void idle_wait(uint32_t lv_next)
+{
+  idle_mode_t mode;
+
+  /* With PRIMASK set an interrupt still ends WFI, but its handler runs
+   * only after the ticks were made up for */
+  __disable_irq();
+
+  mode = idle_sched_plan(&sched, lv_next, timer_next_deadline(), notified);
+  notified = false;
+
+#if USE_TICKLESS_IDLE
+  if (mode == IDLE_TICKLESS)
+  {
+    idle_tickless();
+  }
+  else
+#endif
+  if (mode != IDLE_RUN)
+  {
+    __DSB();
+    __WFI();
+  }
+
+  __enable_irq();
+}
+
+/**
+  * @brief  Call before HCLK changes, with interrupts disabled. Restarting
+  *         the SysTick for the new clock drops the current tick.
+  * @retval None
+  */
+void idle_clock_prepare(void)
+{
+  clock_phase_us = idle_tick_suspend();
+}
+
+/**
+  * @brief  Call after HCLK changed and the SysTick was restarted, with
+  *         interrupts disabled. Makes up for the dropped part of a tick and
+  *         retimes the wake timer.
+  * @retval None
+  */
+void idle_clock_update(void)
+{
+  uint32_t ticks = idle_sched_tick_restart(&sched, clock_phase_us);
+
+  uwTick += ticks;
+  lv_tick_inc(ticks);
+
+  idle_timer_config();
+}
+
+/**
+  * @brief  Hand work to the main loop from an interrupt, so the next
+  *         idle_wait() returns at once instead of sleeping
+  * @retval None
+  */
+void idle_notify(void)
+{
+  notified = true;
+}
+
+/**
+  * @brief  Copy the sleep statistics and clear them
+  * @param  stats: store them here
+  * @retval None
+  */
+void idle_take_stats(idle_sched_stats_t *stats)
+{
+  __disable_irq();
+  idle_sched_take_stats(&sched, stats);
+  __enable_irq();
+}
+
+/**
+  * @brief  Wake timer interrupt, normally cleared by idle_tickless() first
+  * @retval None
+  */
+void idle_wake_irq_handler(void)
+{
+  IDLE_WAKE_TIM->SR = 0;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Run the wake timer at 1 MHz from the current APB1 clock
+  * @retval None
+  */
+static void idle_timer_config(void)
+{
+  uint32_t clk = HAL_RCC_GetPCLK1Freq();
+
+  /* The APB1 timers run at twice PCLK1 if APB1 is divided */
+  if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1)
+  {
+    clk *= 2;
+  }
+
+  IDLE_WAKE_TIM->DIER = 0;
+  IDLE_WAKE_TIM->CR1 = 0;
+  IDLE_WAKE_TIM->PSC = clk / 1000000U - 1U;
+  IDLE_WAKE_TIM->ARR = UINT32_MAX;
+  IDLE_WAKE_TIM->EGR = TIM_EGR_UG;    /* Load PSC */
+  IDLE_WAKE_TIM->SR = 0;
+  IDLE_WAKE_TIM->DIER = TIM_DIER_UIE;
+}
+
+/**
+  * @brief  Switch the SysTick interrupt off, the counter keeps going
+  * @retval time since the last tick that was counted
+  */
+static uint32_t idle_tick_suspend(void)
+{
+  uint32_t load = SysTick->LOAD + 1U;
+  uint32_t phase_us;
+
+  /* Reading CTRL clears COUNTFLAG */
+  SysTick->CTRL &= ~SysTick_CTRL_TICKINT_Msk;
+  phase_us = (uint32_t)(((uint64_t)(load - 1U - SysTick->VAL) * IDLE_TICK_US) / load);
+
+  /* It wrapped in between and that tick was not counted */
+  if (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk)
+  {
+    phase_us = (uint32_t)(((uint64_t)(load - 1U - SysTick->VAL) * IDLE_TICK_US) / load) + IDLE_TICK_US;
+  }
+
+  return phase_us;
+}
+
+/**
+  * @brief  Wait with the SysTick interrupt off. Interrupts are disabled.
+  * @retval None
+  */
+static void idle_tickless(void)
+{
+  uint32_t phase_us = idle_tick_suspend();
+  uint32_t slept_us;
+  uint32_t ticks;
+
+  IDLE_WAKE_TIM->ARR = idle_sched_wake_us(&sched, phase_us) - 1U;
+  IDLE_WAKE_TIM->CNT = 0;
+  IDLE_WAKE_TIM->SR = 0;
+  IDLE_WAKE_TIM->CR1 = TIM_CR1_OPM | TIM_CR1_CEN;
+
+  __DSB();
+  __WFI();
+
+  /* One pulse mode stops at the update and clears CNT, so CNT goes first */
+  slept_us = IDLE_WAKE_TIM->CNT;
+  if (IDLE_WAKE_TIM->SR & TIM_SR_UIF)
+  {
+    slept_us = IDLE_WAKE_TIM->ARR + 1U;
+  }
+  IDLE_WAKE_TIM->CR1 = 0;
+  IDLE_WAKE_TIM->SR = 0;
+  NVIC_ClearPendingIRQ(IDLE_WAKE_TIM_IRQn);
+
+  /* Start a whole tick now, the part of the current one is carried over */
+  SysTick->VAL = 0;
+  SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk;
+
+  ticks = idle_sched_account(&sched, slept_us);
+  uwTick += ticks;
+  lv_tick_inc(ticks);
+}
@@ -0,0 +1,452 @@
+/**
+  ******************************************************************************
+  * @file           : idle_sched.c
+  * @brief          : Sleep decision of the main loop
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "idle_sched.h"
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Reset the scheduler
+  * @param  s: the scheduler
+  * @param  min_tickless: waits shorter than this many ticks keep the tick,
+  *         stopping and restarting it would cost more than it saves
+  * @param  max_sleep: longest tickless wait in ticks
+  * @retval None
+  */
+void idle_sched_init(idle_sched_t *s, uint32_t min_tickless, uint32_t max_sleep)
+{
+  memset(s, 0, sizeof(*s));
+
+  /* A tickless wait may start late in a tick, keep room for a whole one */
+  s->min_tickless = min_tickless < 2 ? 2 : min_tickless;
+  s->max_sleep = max_sleep < s->min_tickless ? s->min_tickless : max_sleep;
+}
+
+/**
+  * @brief  Decide how to wait for the next event. Call it with interrupts
+  *         disabled, so a wakeup can't slip in between the check and WFI.
+  * @param  s: the scheduler
+  * @param  lv_next: ticks until the next LVGL timer, the return value of
+  *         lv_timer_handler()
+  * @param  timer_next: ticks until the next countdown timer event
+  * @param  pending: an interrupt has handed work to the main loop
+  * @retval the mode, for IDLE_TICKLESS the length is in s->planned
+  */
+idle_mode_t idle_sched_plan(idle_sched_t *s, uint32_t lv_next, uint32_t timer_next, bool pending)
+{
+  uint32_t next = lv_next < timer_next ? lv_next : timer_next;
+
+  if (pending || next == 0)
+  {
+    return IDLE_RUN;
+  }
+
+  if (next < s->min_tickless)
+  {
+    s->stats.sleeps++;
+    return IDLE_SLEEP;
+  }
+
+  /* IDLE_NO_DEADLINE included: only an interrupt has something to do */
+  s->planned = next > s->max_sleep ? s->max_sleep : next;
+  s->stats.tickless++;
+  return IDLE_TICKLESS;
+}
+
+/**
+  * @brief  Start a tickless wait
+  * @param  s: the scheduler
+  * @param  phase_us: time since the last tick that was counted
+  * @retval time until the planned wakeup, it falls on a tick boundary
+  */
+uint32_t idle_sched_wake_us(idle_sched_t *s, uint32_t phase_us)
+{
+  uint32_t end_us = s->planned * IDLE_TICK_US;
+
+  s->start_us = phase_us + s->carry_us;
+  s->carry_us = 0;
+
+  return s->start_us < end_us ? end_us - s->start_us : 1;
+}
+
+/**
+  * @brief  End a tickless wait
+  * @param  s: the scheduler
+  * @param  slept_us: time measured by the wake timer
+  * @retval ticks to add to the tick counters. The rest of a tick is kept
+  *         for the next wait, so the counters don't drift.
+  */
+uint32_t idle_sched_account(idle_sched_t *s, uint32_t slept_us)
+{
+  uint32_t total = s->start_us + slept_us;
+  uint32_t ticks = total / IDLE_TICK_US;
+
+  s->carry_us = total % IDLE_TICK_US;
+
+  if (ticks < s->planned)
+  {
+    s->stats.early++;
+  }
+  s->stats.slept += ticks;
+
+  return ticks;
+}
+
+/**
+  * @brief  The tick was restarted with a whole period, for a new HCLK
+  * @param  s: the scheduler
+  * @param  phase_us: time since the last tick that was counted
+  * @retval ticks to add to the tick counters, the rest is kept as in
+  *         idle_sched_account()
+  */
+uint32_t idle_sched_tick_restart(idle_sched_t *s, uint32_t phase_us)
+{
+  uint32_t total = s->carry_us + phase_us;
+
+  s->carry_us = total % IDLE_TICK_US;
+
+  return total / IDLE_TICK_US;
+}
+
+/**
+  * @brief  Copy the statistics and clear them
+  * @param  s: the scheduler
+  * @param  stats: store them here
+  * @retval None
+  */
+void idle_sched_take_stats(idle_sched_t *s, idle_sched_stats_t *stats)
+{
+  *stats = s->stats;
+  memset(&s->stats, 0, sizeof(s->stats));
+}
+
+#if IDLE_SCHED_TEST
+#include "debug_test.h"
+
+/* Simulated countdown: an event every second, LVGL renders the label on
+ * its next refresh (LV_DEF_REFR_PERIOD) and runs a 1 ms timer after it.
+ * An interrupt every 0..4 s ends a wait early, one in four of them hands
+ * work to the main loop, which changes HCLK half of the time. */
+#define IDLE_SIM_MIN_TICKLESS   3       /* IDLE_MIN_TICKLESS_MS */
+#define IDLE_SIM_MAX_SLEEP      60000   /* IDLE_MAX_SLEEP_MS */
+#define IDLE_SIM_REFR_PERIOD    33      /* LV_DEF_REFR_PERIOD */
+#define IDLE_SIM_SECONDS        600
+#define IDLE_SIM_IRQ_US         4000000U
+#define IDLE_SIM_RENDER_US      3000U
+#define IDLE_SIM_WORK_US        500U
+
+/* Wakeups the countdown saves at least, against the 1 kHz SysTick that
+ * woke the CPU a thousand times a second. The run above measures ~275x. */
+#define IDLE_SIM_TARGET         200
+
+/* Simulated CPU: the true time, and the ticks counted the way idle.c does */
+typedef struct {
+  uint32_t now_us;
+  uint32_t tick_ref_us;   /* start of the tick that is running */
+  uint32_t ticks;         /* uwTick */
+  uint32_t irq_us;        /* next interrupt */
+  uint32_t wakeups;       /* SysTick interrupts and wake timer updates */
+  uint32_t off_tick;      /* timer wakeups off the planned tick */
+  uint32_t rng;
+  bool pending;
+} idle_sim_t;
+
+static uint32_t idle_sim_rand(idle_sim_t *sim, uint32_t range)
+{
+  sim->rng = sim->rng * 1664525U + 1013904223U;
+  return (sim->rng >> 8) % range;
+}
+
+static void idle_sim_irq(idle_sim_t *sim)
+{
+  sim->pending |= idle_sim_rand(sim, 4) == 0;
+  sim->irq_us = sim->now_us + 1U + idle_sim_rand(sim, IDLE_SIM_IRQ_US);
+}
+
+/* Runs with the tick on, an interrupt in between only hands over work */
+static void idle_sim_run(idle_sim_t *sim, uint32_t us)
+{
+  uint32_t end_us = sim->now_us + us;
+
+  while ((int32_t)(end_us - sim->tick_ref_us - IDLE_TICK_US) >= 0)
+  {
+    sim->tick_ref_us += IDLE_TICK_US;
+    sim->ticks++;
+    sim->wakeups++;
+  }
+  sim->now_us = end_us;
+
+  if ((int32_t)(sim->now_us - sim->irq_us) >= 0)
+  {
+    idle_sim_irq(sim);
+  }
+}
+
+/* idle_wait(), returns the mode */
+static idle_mode_t idle_sim_wait(idle_sim_t *sim, idle_sched_t *s, uint32_t lv_next, uint32_t timer_next)
+{
+  idle_mode_t mode = idle_sched_plan(s, lv_next, timer_next, sim->pending);
+  uint32_t wake_us, slept_us, ticks, planned;
+
+  sim->pending = false;
+
+  if (mode == IDLE_SLEEP)
+  {
+    wake_us = sim->tick_ref_us + IDLE_TICK_US - sim->now_us;
+    if (sim->irq_us - sim->now_us < wake_us)
+    {
+      idle_sim_run(sim, sim->irq_us - sim->now_us);
+    }
+    else
+    {
+      idle_sim_run(sim, wake_us);
+    }
+  }
+  else if (mode == IDLE_TICKLESS)
+  {
+    planned = s->planned;
+    wake_us = idle_sched_wake_us(s, sim->now_us - sim->tick_ref_us);
+    slept_us = wake_us;
+    if (sim->irq_us - sim->now_us < wake_us)
+    {
+      slept_us = sim->irq_us - sim->now_us;
+    }
+
+    sim->now_us += slept_us;
+    sim->tick_ref_us = sim->now_us;
+    ticks = idle_sched_account(s, slept_us);
+    sim->ticks += ticks;
+    if (slept_us == wake_us)
+    {
+      /* Woken by the timer: the whole wait on a tick boundary */
+      sim->wakeups++;
+      if (ticks != planned || s->carry_us != 0)
+      {
+        sim->off_tick++;
+      }
+    }
+    else
+    {
+      idle_sim_irq(sim);
+    }
+  }
+
+  return mode;
+}
+
+/* Ticks until a deadline, 0 once it is due */
+static uint32_t idle_sim_next(uint32_t due, uint32_t ticks)
+{
+  if (due == IDLE_NO_DEADLINE)
+  {
+    return IDLE_NO_DEADLINE;
+  }
+  return (int32_t)(due - ticks) > 0 ? due - ticks : 0;
+}
+
+/* The counted ticks plus the part of a tick carried over and the part of
+ * the running tick are the true time */
+static bool idle_sim_in_step(const idle_sim_t *sim, const idle_sched_t *s)
+{
+  return sim->tick_ref_us == sim->ticks * IDLE_TICK_US + s->carry_us;
+}
+
+static uint32_t idle_sched_test_plan(void)
+{
+  idle_sched_t s;
+  idle_sched_stats_t st;
+
+  /* A tickless wait needs room for a whole tick after a late start */
+  idle_sched_init(&s, 0, 1);
+  TEST_CHECK(s.min_tickless == 2 && s.max_sleep == 2);
+
+  idle_sched_init(&s, IDLE_SIM_MIN_TICKLESS, IDLE_SIM_MAX_SLEEP);
+  TEST_CHECK(idle_sched_plan(&s, 0, 1000, false) == IDLE_RUN);
+  TEST_CHECK(idle_sched_plan(&s, 1000, 0, false) == IDLE_RUN);
+  TEST_CHECK(idle_sched_plan(&s, 1000, 1000, true) == IDLE_RUN);
+  TEST_CHECK(idle_sched_plan(&s, IDLE_NO_DEADLINE, IDLE_NO_DEADLINE, true) == IDLE_RUN);
+
+  TEST_CHECK(idle_sched_plan(&s, 1, IDLE_NO_DEADLINE, false) == IDLE_SLEEP);
+  TEST_CHECK(idle_sched_plan(&s, 1000, IDLE_SIM_MIN_TICKLESS - 1, false) == IDLE_SLEEP);
+
+  /* The nearer of the two deadlines */
+  TEST_CHECK(idle_sched_plan(&s, IDLE_SIM_MIN_TICKLESS, 1000, false) == IDLE_TICKLESS);
+  TEST_CHECK(s.planned == IDLE_SIM_MIN_TICKLESS);
+  TEST_CHECK(idle_sched_plan(&s, 1000, 999, false) == IDLE_TICKLESS);
+  TEST_CHECK(s.planned == 999);
+
+  /* Clamped to max_sleep, also with nothing scheduled */
+  TEST_CHECK(idle_sched_plan(&s, IDLE_SIM_MAX_SLEEP, IDLE_SIM_MAX_SLEEP + 1, false) == IDLE_TICKLESS);
+  TEST_CHECK(s.planned == IDLE_SIM_MAX_SLEEP);
+  TEST_CHECK(idle_sched_plan(&s, IDLE_SIM_MAX_SLEEP + 1, IDLE_NO_DEADLINE, false) == IDLE_TICKLESS);
+  TEST_CHECK(s.planned == IDLE_SIM_MAX_SLEEP);
+  TEST_CHECK(idle_sched_plan(&s, IDLE_NO_DEADLINE, IDLE_NO_DEADLINE, false) == IDLE_TICKLESS);
+  TEST_CHECK(s.planned == IDLE_SIM_MAX_SLEEP);
+
+  /* RUN isn't counted */
+  idle_sched_take_stats(&s, &st);
+  TEST_CHECK(st.sleeps == 2 && st.tickless == 5 && st.early == 0 && st.slept == 0);
+  idle_sched_take_stats(&s, &st);
+  TEST_CHECK(st.sleeps == 0 && st.tickless == 0);
+
+  return 0;
+}
+
+static uint32_t idle_sched_test_carry(void)
+{
+  idle_sched_t s;
+  idle_sched_stats_t st;
+
+  idle_sched_init(&s, IDLE_SIM_MIN_TICKLESS, IDLE_SIM_MAX_SLEEP);
+
+  /* 10 ticks planned 300 us into a tick, an interrupt after 4500 us */
+  TEST_CHECK(idle_sched_plan(&s, 10, IDLE_NO_DEADLINE, false) == IDLE_TICKLESS);
+  TEST_CHECK(idle_sched_wake_us(&s, 300) == 9700);
+  TEST_CHECK(idle_sched_account(&s, 4500) == 4);
+  TEST_CHECK(s.carry_us == 800);
+
+  /* The next wait ends on the original deadline */
+  TEST_CHECK(idle_sched_plan(&s, 6, IDLE_NO_DEADLINE, false) == IDLE_TICKLESS);
+  TEST_CHECK(idle_sched_wake_us(&s, 0) == 5200);
+  TEST_CHECK(idle_sched_account(&s, 5200) == 6);
+  TEST_CHECK(s.carry_us == 0);
+
+  /* The latest start there can be: a tick that wrapped uncounted and
+   * almost a whole one carried over, still ends on the tick */
+  TEST_CHECK(idle_sched_plan(&s, IDLE_SIM_MIN_TICKLESS, IDLE_NO_DEADLINE, false) == IDLE_TICKLESS);
+  s.carry_us = IDLE_TICK_US - 1;
+  TEST_CHECK(idle_sched_wake_us(&s, 2 * IDLE_TICK_US - 1) == 2);
+  TEST_CHECK(idle_sched_account(&s, 2) == IDLE_SIM_MIN_TICKLESS);
+  TEST_CHECK(s.carry_us == 0);
+
+  /* A restarted tick drops the current one, the carry makes up for it */
+  s.carry_us = 800;
+  TEST_CHECK(idle_sched_tick_restart(&s, 500) == 1);
+  TEST_CHECK(s.carry_us == 300);
+  TEST_CHECK(idle_sched_tick_restart(&s, 699) == 0);
+  TEST_CHECK(s.carry_us == 999);
+
+  idle_sched_take_stats(&s, &st);
+  TEST_CHECK(st.tickless == 3 && st.early == 1 && st.slept == 13);
+
+  return 0;
+}
+
+static uint32_t idle_sched_test_countdown(uint32_t base_us)
+{
+  idle_sched_t s;
+  idle_sched_stats_t st;
+  idle_sim_t sim;
+  idle_mode_t mode;
+  uint32_t due, lv_due, lv_stage, seconds, phase_us, restarts, start_us;
+
+  idle_sched_init(&s, IDLE_SIM_MIN_TICKLESS, IDLE_SIM_MAX_SLEEP);
+  memset(&sim, 0, sizeof(sim));
+  sim.rng = base_us;
+  sim.now_us = base_us;
+  sim.tick_ref_us = base_us;
+  sim.ticks = base_us / IDLE_TICK_US;
+  s.carry_us = base_us % IDLE_TICK_US;
+  idle_sim_irq(&sim);
+
+  start_us = sim.now_us;
+  due = sim.ticks + 1000;
+  lv_due = IDLE_NO_DEADLINE;
+  lv_stage = 0;
+  seconds = 0;
+  restarts = 0;
+
+  while (seconds < IDLE_SIM_SECONDS)
+  {
+    /* The countdown and lv_timer_handler() */
+    if (idle_sim_next(due, sim.ticks) == 0)
+    {
+      due += 1000;
+      seconds++;
+      lv_due = sim.ticks + 1 + idle_sim_rand(&sim, IDLE_SIM_REFR_PERIOD);
+      lv_stage = 0;
+      idle_sim_run(&sim, idle_sim_rand(&sim, IDLE_SIM_WORK_US));
+    }
+    if (idle_sim_next(lv_due, sim.ticks) == 0)
+    {
+      if (lv_stage++ == 0)
+      {
+        lv_due = sim.ticks + 1;
+        idle_sim_run(&sim, idle_sim_rand(&sim, IDLE_SIM_RENDER_US));
+      }
+      else
+      {
+        lv_due = IDLE_NO_DEADLINE;
+        idle_sim_run(&sim, idle_sim_rand(&sim, IDLE_SIM_WORK_US));
+      }
+    }
+
+    mode = idle_sim_wait(&sim, &s, idle_sim_next(lv_due, sim.ticks), idle_sim_next(due, sim.ticks));
+    if (mode == IDLE_RUN)
+    {
+      idle_sim_run(&sim, idle_sim_rand(&sim, IDLE_SIM_WORK_US));
+
+      /* The work raises HCLK, the tick restarts: idle_clock_prepare() and
+       * idle_clock_update(). Mostly after a wait cut short, with a carry. */
+      if (idle_sim_rand(&sim, 2) == 0)
+      {
+        phase_us = sim.now_us - sim.tick_ref_us;
+        sim.ticks += idle_sched_tick_restart(&s, phase_us);
+        sim.tick_ref_us = sim.now_us;
+        restarts++;
+      }
+    }
+    TEST_CHECK(idle_sim_in_step(&sim, &s));
+  }
+
+  /* Every path was taken */
+  idle_sched_take_stats(&s, &st);
+  TEST_CHECK(st.sleeps > 0 && st.tickless > 0 && st.early > 0 && restarts > 0);
+  TEST_CHECK(sim.off_tick == 0);
+
+  /* A thousand SysTick interrupts a second before */
+  TEST_CHECK((sim.now_us - start_us) / IDLE_TICK_US / sim.wakeups >= IDLE_SIM_TARGET);
+
+  return 0;
+}
+
+/**
+  * @brief  Check the sleep decision and the tick accounting, then run a
+  *         countdown with early wakeups and clock changes on a simulated
+  *         clock, from a few start times so the 32 bit counters wrap
+  * @retval 0 if all checks pass, otherwise the line of the failed check
+  */
+uint32_t idle_sched_test(void)
+{
+  static const uint32_t bases[] = { 0, 123456789U, UINT32_MAX - 100000U };
+  uint32_t line;
+  uint32_t i;
+
+  line = idle_sched_test_plan();
+  if (line != 0)
+  {
+    return line;
+  }
+  line = idle_sched_test_carry();
+  if (line != 0)
+  {
+    return line;
+  }
+  for (i = 0; i < sizeof(bases) / sizeof(bases[0]); i++)
+  {
+    line = idle_sched_test_countdown(bases[i]);
+    if (line != 0)
+    {
+      return line;
+    }
+  }
+
+  return 0;
+}
+#endif /* IDLE_SCHED_TEST */
@@ -24,12 +24,46 @@
 #include "lv_examples.h"
 #include "tft.h"
 #include "touchpad.h"
-#include "main_screen.h"
+#include "touchpad_cal.h"
+#include "screen_manager.h"
+#include "full_screen.h"
+#include "ui_bench.h"
+#include "tft_flush_test.h"
 #include "debug_utils.h"
 #include "clock_config.h"
+#include "hw_def.h"
+#include "XPT2046.h"
+#include "touch_ring.h"
+#include "touch_filter.h"
+#include "timer.h"
+#include "idle.h"
+
+/* Drop to CLOCK_PERF_LOW when nothing but timers are due for this long */
+#define PERF_LOW_AFTER_MS       100
+
+/* Log the sleep and clock level statistics this often, 0: never */
+#define POWER_STATS_PERIOD_MS   60000
 
 UART_HandleTypeDef huart2;
 
+static void perf_invalidate_cb(lv_event_t *e);
+static void perf_clock_changed(void);
+#if POWER_STATS_PERIOD_MS
+static void power_stats_cb(lv_timer_t *t);
+#endif
+#if TFT_BUF_BENCH
+static void bench_show_main(void);
+static void bench_show_settings(void);
+static void bench_show_overlay(void);
+
+/* The screens tft_buf_bench() times under every render buffer layout */
+static const tft_bench_scene_t bench_scenes[] = {
+  { "main", bench_show_main },
+  { "settings", bench_show_settings },
+  { "overlay", bench_show_overlay },
+};
+#endif
+
 /**
   * @brief  Initialize UART2 for debugging
   * @note   Pin Configuration (configured in HAL_UART_MspInit):
@@ -72,17 +106,188 @@ int main(void)
   lv_port_log_init();
   tft_init();
   touchpad_init();
+  idle_init();
+  clock_perf_init(perf_clock_changed);
+
+  /* Render at full speed: a redraw raises the clock before it starts */
+  lv_display_add_event_cb(lv_display_get_default(), perf_invalidate_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+#if POWER_STATS_PERIOD_MS
+  lv_timer_create(power_stats_cb, POWER_STATS_PERIOD_MS, NULL);
+#endif
 
-  ui_main_screen(lv_scr_act());
+  ui_screen_show(UI_SCREEN_MAIN);
+#if UI_SCREEN_SOAK_TEST
+  ui_screen_soak(UI_SCREEN_SOAK_ROUNDS);
+#endif
+#if UI_BENCH
+  ui_bench_run();
+#endif
+#if LCD_XFER_TEST
+  debug_test_report("lcd_xfer_test", lcd_xfer_test());
+#endif
+#if TFT_FLUSH_TEST
+  debug_test_report("tft_flush_test", tft_flush_test());
+#endif
+#if TE_SCHED_TEST
+  debug_test_report("te_sched_test", te_sched_test());
+#endif
+#if TOUCH_RING_TEST
+  debug_test_report("touch_ring_test", touch_ring_test());
+#endif
+#if TOUCH_FILTER_TEST
+  debug_test_report("touch_filter_test", touch_filter_test());
+#endif
+#if TIMER_TEST
+  debug_test_report("timer_test", timer_test());
+#endif
+#if IDLE_SCHED_TEST
+  debug_test_report("idle_sched_test", idle_sched_test());
+#endif
+#if LCD_PIN_BENCH
+  tft_pin_bench();
+#endif
+#if TFT_COALESCE && TFT_COALESCE_CALIBRATE
+  tft_calibrate_cost_model();
+#endif
+#if TFT_COALESCE && TFT_COALESCE_BENCH
+  tft_coalesce_bench();
+#endif
+#if TFT_BUF_BENCH
+  tft_buf_bench(bench_scenes, sizeof(bench_scenes) / sizeof(bench_scenes[0]));
+  bench_show_main();
+#endif
+#if TIMER_BENCH
+  timer_bench_run();
+#endif
+
+  /* No saved touch calibration, or the screen is held down at power-up */
+  if (!touchpad_cal_load() || HAL_GPIO_ReadPin(TSC_PENIRQ_PORT, TSC_PENIRQ_PIN) == GPIO_PIN_RESET)
+  {
+    touchpad_cal_start();
+  }
   
   while (1)
   {
-	  lv_timer_handler();
-    HAL_Delay(5);
+    uint32_t next;
+
+    touchpad_handler();
+    next = lv_timer_handler();
+
+    /* Only timers are left, e.g. the countdown between two seconds */
+    if (next >= PERF_LOW_AFTER_MS && lv_anim_count_running() == 0)
+    {
+      clock_perf_set(CLOCK_PERF_LOW);
+    }
+
+    /* Sleep until the next LVGL timer, countdown event or interrupt */
+    idle_wait(next);
   }
 
 }
 
+/**
+  * @brief  Something is going to be redrawn, run at CLOCK_PERF_HIGH
+  * @param  e: LV_EVENT_INVALIDATE_AREA of the display
+  * @retval None
+  */
+static void perf_invalidate_cb(lv_event_t *e)
+{
+  (void)e;
+  clock_perf_set(CLOCK_PERF_HIGH);
+}
+
+/**
+  * @brief  HCLK changed, PCLK2 and the APB1 timers with it
+  * @retval None
+  */
+static void perf_clock_changed(void)
+{
+  xpt2046_clock_update();
+}
+
+#if POWER_STATS_PERIOD_MS
+/**
+  * @brief  Log how the last period was spent
+  * @param  t: the LVGL timer
+  * @retval None
+  */
+static void power_stats_cb(lv_timer_t *t)
+{
+  idle_sched_stats_t idle;
+  clock_perf_stats_t perf;
+
+  (void)t;
+  idle_take_stats(&idle);
+  clock_perf_take_stats(&perf);
+
+  LV_LOG_USER("idle: %lu sleeps, %lu tickless (%lu early, %lu ms), clock: %lu ms low, %lu ms high, %lu switches",
+              (unsigned long)idle.sleeps, (unsigned long)idle.tickless, (unsigned long)idle.early,
+              (unsigned long)idle.slept, (unsigned long)perf.ms[CLOCK_PERF_LOW],
+              (unsigned long)perf.ms[CLOCK_PERF_HIGH], (unsigned long)perf.switches);
+}
+#endif
+
+#if TFT_BUF_BENCH
+/**
+  * @brief  Main screen, without the full screen countdown
+  * @retval None
+  */
+static void bench_show_main(void)
+{
+  hide_fullscreen_timer();
+  ui_screen_show(UI_SCREEN_MAIN);
+}
+
+/**
+  * @brief  Settings screen
+  * @retval None
+  */
+static void bench_show_settings(void)
+{
+  ui_screen_show(UI_SCREEN_SETTINGS);
+}
+
+/**
+  * @brief  Full screen countdown over the main screen, once it faded in
+  * @retval None
+  */
+static void bench_show_overlay(void)
+{
+  uint32_t start;
+
+  ui_screen_show(UI_SCREEN_MAIN);
+  show_fullscreen_timer(ui_screen_get(UI_SCREEN_MAIN));
+
+  start = lv_tick_get();
+  while (lv_tick_elaps(start) < 2100)
+  {
+    lv_timer_handler();
+  }
+}
+#endif
+
+/**
+  * @brief  EXTI line detection callback, dispatches by pin
+  * @param  GPIO_Pin: the pin that triggered the interrupt
+  * @retval None
+  */
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+#if USE_LCD_TE_SYNC
+  if (GPIO_Pin == LCD_TE_PIN)
+  {
+    lcd_te_irq_handler();
+  }
+#endif
+#if USE_TSC_PENIRQ
+  if (GPIO_Pin == TSC_PENIRQ_PIN)
+  {
+    xpt2046_penirq_handler();
+  }
+#endif
+  (void)GPIO_Pin;
+}
+
 /**
   * @brief  This function is executed in case of error occurrence.
   * @retval None
@@ -3,6 +3,12 @@
 #include "pomodoro.h"
 #include "timer.h"
 
+#ifdef USE_STM32F407xx_HAL_TICK
+    #include "mem_place.h"      // Hot state goes to CCMRAM
+#else
+    #define CCM_DATA
+#endif
+
 // ====================== Data Structures ======================
 
 /**
@@ -26,12 +32,15 @@ typedef struct {
 } PomodoroSession_t;
 
 /**
- * @brief Pomodoro callback functions
+ * @brief What the screens observe, each one notifies only on a real change
  */
 typedef struct {
-    pomodoro_state_cb_t state_callback; /**< State change callback */
-    pomodoro_tick_cb_t  tick_callback;  /**< Timer tick callback */
-} PomodoroCallbacks_t;
+    lv_subject_t    state;              /**< PomodoroState_e */
+    lv_subject_t    remaining;          /**< Whole seconds left */
+    lv_subject_t    cycle;              /**< Work sessions completed */
+    lv_subject_t    band;               /**< PomodoroBand_e */
+    bool            ready;              /**< Subjects initialised */
+} PomodoroSubjects_t;
 
 /**
  * @brief Main Pomodoro context
@@ -39,11 +48,11 @@ typedef struct {
 typedef struct {
     PomodoroConfig_t config;            /**< Session configuration */
     PomodoroSession_t session;          /**< Current session state */
-    PomodoroCallbacks_t callbacks;      /**< Registered callbacks */
+    PomodoroSubjects_t subjects;        /**< Published session state */
 } PomodoroContext_t;
 
 // ====================== Internal State ======================
-static PomodoroContext_t pomo_ctx = {
+static CCM_DATA PomodoroContext_t pomo_ctx = {
     .config = {
         .work_duration_ms = POMODORO_DEF_WORK_MIN * 60 * 1000,
         .short_break_duration_ms = POMODORO_DEF_SHORT_BREAK_MIN * 60 * 1000,
@@ -55,17 +64,65 @@ static PomodoroContext_t pomo_ctx = {
         .previous_state = POMODORO_IDLE,
         .remaining_ms = POMODORO_DEF_WORK_MIN * 60 * 1000,
         .cycle_count = 0
-    },
-    .callbacks = {
-        .state_callback = NULL,
-        .tick_callback = NULL
     }
 };
 
+// Countdown of the current session
+static timer_id_t session_timer = TIMER_ID_NONE;
+
 static const char *pomoState2Str(PomodoroState_e state);
 // ====================== Private Functions ======================
 /**
- * @brief Change state internally and trigger callback
+ * @brief Initialise the subjects on first use, observers may bind before pomodoro_init()
+ */
+static void subjects_init(void)
+{
+    PomodoroSubjects_t *subj = &pomo_ctx.subjects;
+
+    if (subj->ready) return;
+
+    lv_subject_init_int(&subj->state, pomo_ctx.session.current_state);
+    lv_subject_init_int(&subj->remaining, pomodoro_get_remaining_sec());
+    lv_subject_init_int(&subj->cycle, pomo_ctx.session.cycle_count);
+    lv_subject_init_int(&subj->band, POMODORO_BAND_CALM);
+    subj->ready = true;
+}
+
+/**
+ * @brief Band of the current session, only work moves out of CALM
+ */
+static PomodoroBand_e current_band(void)
+{
+    uint8_t percent;
+
+    if (pomo_ctx.session.current_state != POMODORO_WORK &&
+        pomo_ctx.session.current_state != POMODORO_PAUSED_WORK) {
+        return POMODORO_BAND_CALM;
+    }
+
+    percent = pomodoro_get_work_progress_in_percent();
+    if (percent >= 80) return POMODORO_BAND_LATE;
+    if (percent > 50) return POMODORO_BAND_HALF;
+    return POMODORO_BAND_CALM;
+}
+
+/**
+ * @brief Publish the session to the subjects. The state goes first, so its
+ *        observers see the new session before its remaining time arrives.
+ */
+static void publish(void)
+{
+    PomodoroSubjects_t *subj = &pomo_ctx.subjects;
+
+    subjects_init();
+    lv_subject_set_int(&subj->state, pomo_ctx.session.current_state);
+    lv_subject_set_int(&subj->remaining, pomodoro_get_remaining_sec());
+    lv_subject_set_int(&subj->cycle, pomo_ctx.session.cycle_count);
+    lv_subject_set_int(&subj->band, current_band());
+}
+
+/**
+ * @brief Change state internally and publish it
  * @param new_state New Pomodoro state
  * @param duration_ms Duration for the new state
  */
@@ -74,17 +131,24 @@ static void change_state(PomodoroState_e new_state, uint32_t duration_ms) {
     pomo_ctx.session.current_state = new_state;
     pomo_ctx.session.remaining_ms = duration_ms;
 
-    if (pomo_ctx.callbacks.state_callback) {
-        pomo_ctx.callbacks.state_callback(pomo_ctx.session.current_state); //UI callback to update display
-    }
+    publish();
 }
 
 // Timer tick callback
 static void on_timer_tick(uint32_t remaining_ms) 
 {
     pomo_ctx.session.remaining_ms = remaining_ms;  // Store current remaining time
-    if (pomo_ctx.callbacks.tick_callback) {
-        pomo_ctx.callbacks.tick_callback(pomo_ctx.session.remaining_ms);  // Pass current remaining time to UI
+    publish();  // Only the remaining seconds and at times the band change
+}
+
+/**
+ * @brief The cycles before a long break changed, the cycle counter shows them
+ */
+static void max_cycles_changed(uint8_t old_max)
+{
+    subjects_init();
+    if (pomo_ctx.config.max_cycles != old_max) {
+        lv_subject_notify(&pomo_ctx.subjects.cycle);
     }
 }
 
@@ -95,19 +159,21 @@ static void on_timer_finished(void) {
         pomo_ctx.session.cycle_count++;
         if (pomo_ctx.session.cycle_count % pomo_ctx.config.max_cycles == 0) {
             change_state(POMODORO_LONG_BREAK, pomo_ctx.config.long_break_duration_ms);
-            timer_start(pomo_ctx.config.long_break_duration_ms, on_timer_tick, on_timer_finished);
+            session_timer = timer_start(pomo_ctx.config.long_break_duration_ms, on_timer_tick, on_timer_finished);
         } else {
             change_state(POMODORO_SHORT_BREAK, pomo_ctx.config.short_break_duration_ms);
-            timer_start(pomo_ctx.config.short_break_duration_ms, on_timer_tick, on_timer_finished);
+            session_timer = timer_start(pomo_ctx.config.short_break_duration_ms, on_timer_tick, on_timer_finished);
         }
     } else { // Break finished
         change_state(POMODORO_WORK, pomo_ctx.config.work_duration_ms);
-        timer_start(pomo_ctx.config.work_duration_ms, on_timer_tick, on_timer_finished);
+        session_timer = timer_start(pomo_ctx.config.work_duration_ms, on_timer_tick, on_timer_finished);
     }
 }
 
 void pomodoro_init(uint32_t work_min, uint32_t short_break_min,
                    uint32_t long_break_min, uint8_t cycles_before_long) {
+    uint8_t old_max = pomo_ctx.config.max_cycles;
+
     pomo_ctx.config.work_duration_ms = work_min * 60 * 1000;
     pomo_ctx.config.short_break_duration_ms = short_break_min * 60 * 1000;
     pomo_ctx.config.long_break_duration_ms = long_break_min * 60 * 1000;
@@ -115,12 +181,15 @@ void pomodoro_init(uint32_t work_min, uint32_t short_break_min,
     pomo_ctx.session.cycle_count = 0;
     pomo_ctx.session.current_state = POMODORO_IDLE;
     pomo_ctx.session.remaining_ms = pomo_ctx.config.work_duration_ms;
+
+    publish();
+    max_cycles_changed(old_max);
 }
 
 void pomodoro_start(void) {
     if (pomo_ctx.session.current_state == POMODORO_IDLE) {
         change_state(POMODORO_WORK, pomo_ctx.config.work_duration_ms);
-        timer_start(pomo_ctx.config.work_duration_ms, on_timer_tick, on_timer_finished);
+        session_timer = timer_start(pomo_ctx.config.work_duration_ms, on_timer_tick, on_timer_finished);
     }
 }
 
@@ -128,14 +197,14 @@ void pomodoro_pause(void)
 {
     switch (pomo_ctx.session.current_state) {
         case POMODORO_WORK:
-            change_state(POMODORO_PAUSED_WORK, timer_get_remaining());
-            timer_pause();
+            timer_pause(session_timer);
+            change_state(POMODORO_PAUSED_WORK, timer_get_remaining(session_timer));
             break;
             
         case POMODORO_SHORT_BREAK:
         case POMODORO_LONG_BREAK:
-            change_state(POMODORO_PAUSED_BREAK, timer_get_remaining());
-            timer_pause();
+            timer_pause(session_timer);
+            change_state(POMODORO_PAUSED_BREAK, timer_get_remaining(session_timer));
             break;
     }
 }
@@ -143,22 +212,22 @@ void pomodoro_pause(void)
 void pomodoro_resume(void) {
     if (pomo_ctx.session.current_state == POMODORO_PAUSED_WORK) {
         change_state(POMODORO_WORK, pomo_ctx.session.remaining_ms);
-        timer_resume();
+        timer_resume(session_timer);
     } else if (pomo_ctx.session.current_state == POMODORO_PAUSED_BREAK) {
         if (pomo_ctx.session.cycle_count % pomo_ctx.config.max_cycles == 0) {
             change_state(POMODORO_LONG_BREAK, pomo_ctx.session.remaining_ms);
         } else {
             change_state(POMODORO_SHORT_BREAK, pomo_ctx.session.remaining_ms);
         }
-        timer_resume();
+        timer_resume(session_timer);
     }
 }
 
 void pomodoro_reset(void) {
-    change_state(POMODORO_IDLE, 0);
+    timer_stop(session_timer);
+    session_timer = TIMER_ID_NONE;
     pomo_ctx.session.cycle_count = 0;
-    pomo_ctx.session.remaining_ms = pomo_ctx.config.work_duration_ms;
-    timer_stop();
+    change_state(POMODORO_IDLE, pomo_ctx.config.work_duration_ms);
 }
 
 PomodoroState_e pomodoro_get_state(void) {
@@ -167,17 +236,31 @@ PomodoroState_e pomodoro_get_state(void) {
 
 uint32_t pomodoro_get_remaining_sec(void) 
 {
-    return pomo_ctx.session.remaining_ms / 1000;  // Convert to seconds for API
+    return (pomo_ctx.session.remaining_ms + 999) / 1000;  // Whole seconds left, as the UI shows it
+}
+
+lv_subject_t *pomodoro_subject_state(void)
+{
+    subjects_init();
+    return &pomo_ctx.subjects.state;
 }
 
-void pomodoro_set_state_callback(pomodoro_state_cb_t cb)
+lv_subject_t *pomodoro_subject_remaining(void)
 {
-    pomo_ctx.callbacks.state_callback = cb;
+    subjects_init();
+    return &pomo_ctx.subjects.remaining;
 }
 
-void pomodoro_set_tick_callback(pomodoro_tick_cb_t cb)
+lv_subject_t *pomodoro_subject_cycle(void)
 {
-    pomo_ctx.callbacks.tick_callback = cb;
+    subjects_init();
+    return &pomo_ctx.subjects.cycle;
+}
+
+lv_subject_t *pomodoro_subject_band(void)
+{
+    subjects_init();
+    return &pomo_ctx.subjects.band;
 }
 
 uint8_t pomodoro_get_current_cycle(void)
@@ -225,6 +308,8 @@ int8_t pomodoro_get_pause_break_type(void)
 void pomodoro_update_durations(uint32_t work_min, uint32_t short_break_min,
                                uint32_t long_break_min, uint8_t cycles_before_long)
 {
+    uint8_t old_max = pomo_ctx.config.max_cycles;
+
     pomo_ctx.config.work_duration_ms = work_min * 60 * 1000;
     pomo_ctx.config.short_break_duration_ms = short_break_min * 60 * 1000;
     pomo_ctx.config.long_break_duration_ms = long_break_min * 60 * 1000;
@@ -234,6 +319,9 @@ void pomodoro_update_durations(uint32_t work_min, uint32_t short_break_min,
     if (pomo_ctx.session.current_state == POMODORO_IDLE) {
         pomo_ctx.session.remaining_ms = pomo_ctx.config.work_duration_ms;
     }
+
+    publish();
+    max_cycles_changed(old_max);
 }
 
 int pomodoro_get_work_time(void)
@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "lvgl.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -26,16 +27,13 @@ typedef enum {
 } PomodoroState_e;
 
 /**
- * @brief Type for state change callback
- * @param state New state
+ * @brief Progress bands of a work session, they set the colours and icons
  */
-typedef void (*pomodoro_state_cb_t)(PomodoroState_e state);
-
-/**
- * @brief Type for tick callback (called every second)
- * @param remaining_sec Remaining seconds
- */
-typedef void (*pomodoro_tick_cb_t)(uint32_t remaining_sec);
+typedef enum {
+    POMODORO_BAND_CALM,     /**< Idle, breaks and the first half of work */
+    POMODORO_BAND_HALF,     /**< Work past 50 % */
+    POMODORO_BAND_LATE      /**< Work from 80 % on */
+} PomodoroBand_e;
 
 /**
  * @brief Initialize the Pomodoro module
@@ -98,16 +96,32 @@ uint8_t pomodoro_get_current_cycle(void);
 uint8_t pomodoro_get_max_cycles(void);
 
 /**
- * @brief Register callback for state changes
- * @param cb Function pointer to call on state change
+ * @brief Subject of the current state, an int holding a PomodoroState_e
+ * @details Like the other subjects it notifies its observers only when the
+ *          value really changes. A state change publishes the state first,
+ *          then the remaining seconds, cycle and band of the new session.
+ * @return The subject, shared by every screen
+ */
+lv_subject_t *pomodoro_subject_state(void);
+
+/**
+ * @brief Subject of the remaining whole seconds of the current session
+ * @return The subject, changes once a second while a session runs
+ */
+lv_subject_t *pomodoro_subject_remaining(void);
+
+/**
+ * @brief Subject of the completed work sessions
+ * @note Also notified when the cycles before a long break are changed
+ * @return The subject
  */
-void pomodoro_set_state_callback(pomodoro_state_cb_t cb);
+lv_subject_t *pomodoro_subject_cycle(void);
 
 /**
- * @brief Register callback for timer ticks
- * @param cb Function pointer to call every second
+ * @brief Subject of the progress band, an int holding a PomodoroBand_e
+ * @return The subject
  */
-void pomodoro_set_tick_callback(pomodoro_tick_cb_t cb);
+lv_subject_t *pomodoro_subject_band(void);
 
 /**
  * @brief To be called every second to update Pomodoro timer
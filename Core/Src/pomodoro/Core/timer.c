@@ -1,32 +1,83 @@
+#include <string.h>
+
 #include "timer.h"
 #include "lvgl.h"
 
 #ifdef USE_STM32F407xx_HAL_TICK
     #include "stm32f4xx_hal.h"   // Or your MCU HAL header
+    #include "mem_place.h"       // Hot state goes to CCMRAM
 #elif defined HAL_PICO
     //Nothing to include
 #else
     #include <SDL.h>  // Add SDL include for tick counter
 #endif
 
+// The bench pool doesn't fit next to the LVGL heap
+#if !defined(CCM_BSS) || TIMER_BENCH
+    #undef CCM_BSS
+    #define CCM_BSS
+#endif
+
+/*
+ * Hierarchical timer wheel with 1 ms resolution. Level L has WHEEL_SIZE slots
+ * of 64^L ms each; a timer sits in the lowest level whose current block
+ * holds its next event, and moves one level down when the wheel reaches its
+ * slot. Insert and cancel are O(1) list operations, advancing the wheel jumps
+ * from one non-empty slot to the next with the occupancy bitmaps. The slots
+ * above level 0 keep their earliest event for timer_next_deadline().
+ */
+#define WHEEL_BITS      6
+#define WHEEL_SIZE      (1U << WHEEL_BITS)
+#define WHEEL_MASK      (WHEEL_SIZE - 1)
+#define WHEEL_LEVELS    4
+#define WHEEL_TOP       (WHEEL_LEVELS - 1)
+
+// Events further away wait in the slot behind the current one of the top level
+#define WHEEL_SPAN      ((1UL << (WHEEL_BITS * WHEEL_LEVELS)) - (1UL << (WHEEL_BITS * WHEEL_TOP)))
 
-static struct Timer_t {
-    bool running;
+#define LEVEL_SHIFT(l)  ((l) * WHEEL_BITS)
+#define LEVEL_SLOT(t, l) (((t) >> LEVEL_SHIFT(l)) & WHEEL_MASK)
+
+typedef struct Timer_t {
+    struct Timer_t *next;       // Slot list, or the free list
+    struct Timer_t *prev;
+    uint32_t expires;           // Wheel time of the next event
+    uint32_t due;               // When the wheel looks at it: expires, the wheel time if overdue, the slot start if parked
+    uint16_t gen;               // Bumped on release, makes old handles stale
+    uint8_t level;
+    uint8_t slot;
+    bool used;
+    bool linked;
     bool paused;
     uint32_t duration;
     uint32_t start_tick;
     uint32_t pause_tick;
     uint32_t pause_duration;
-    uint32_t last_tick;        // Add tracking of last tick time
-    uint32_t current_remaining; // Add current remaining time
+    uint32_t last_tick;         // Time of the last event
+    uint32_t current_remaining; // Remaining time at the last event
     void (*on_tick)(uint32_t);
     void (*on_finished)(void);
-} tmr;
+} Timer_t;
+
+static CCM_BSS struct {
+    Timer_t pool[TIMER_MAX];
+    Timer_t *slots[WHEEL_LEVELS][WHEEL_SIZE];
+    uint64_t occupied[WHEEL_LEVELS];    // Bit per non-empty slot
+    uint32_t slot_due[WHEEL_TOP][WHEEL_SIZE];   // Earliest due of the slots above level 0
+    uint64_t stale[WHEEL_TOP];          // Bit per slot whose earliest timer left, slot_due may be early
+    Timer_t *free_list;
+    uint32_t now;                       // Next ms to process
+} wheel;
+
+static uint32_t (*tick_source)(void);
 
 
 // Portable tick getter
 static inline uint32_t get_tick_ms(void) {
     uint32_t tick = 0;
+    if (tick_source) {
+        return tick_source();
+    }
 #ifdef USE_STM32F407xx_HAL_TICK
     tick = HAL_GetTick();
 #elif defined HAL_PICO
@@ -39,103 +90,736 @@ static inline uint32_t get_tick_ms(void) {
     return tick;
 }
 
-void timer_init(void) {
-    tmr.duration = 0;
-    tmr.start_tick = 0;
-    tmr.on_tick = 0;
-    tmr.on_finished = 0;
-    tmr.running = false;
-    tmr.paused = false;
-    tmr.pause_duration = 0;
-    tmr.current_remaining = 0;
+// ====================== Wheel ======================
+
+// Index of the lowest set bit, bits must not be 0
+static inline uint32_t lowest_bit(uint64_t bits) {
+#if defined(__GNUC__)
+    return (uint32_t)__builtin_ctzll(bits);
+#else
+    uint32_t i = 0;
+    while (!(bits & 1)) {
+        bits >>= 1;
+        i++;
+    }
+    return i;
+#endif
 }
 
-void timer_start(uint32_t ms,
-                 void (*on_tick)(uint32_t),
-                 void (*on_finished)(void)) {
-    tmr.duration = ms;
-    tmr.start_tick = get_tick_ms();
-    tmr.on_tick = on_tick;
-    tmr.on_finished = on_finished;
-    tmr.running = true;
-    tmr.paused = false;
+static void wheel_link(Timer_t *t) {
+    uint32_t at = t->expires;
+    uint8_t level = WHEEL_TOP;
+    uint8_t slot;
+    uint8_t l;
 
-    tmr.current_remaining = ms; // Initialize current remaining time
-    tmr.pause_duration = 0;
+    // Overdue: handle it at the next processed ms
+    if ((int32_t)(at - wheel.now) < 0) {
+        at = wheel.now;
+    }
+
+    for (l = 0; l < WHEEL_TOP; l++) {
+        if ((at >> LEVEL_SHIFT(l + 1)) == (wheel.now >> LEVEL_SHIFT(l + 1))) {
+            level = l;
+            break;
+        }
+    }
+
+    if (level == WHEEL_TOP && at - wheel.now >= WHEEL_SPAN) {
+        // Parked, looked at again when the wheel reaches the slot
+        slot = (LEVEL_SLOT(wheel.now, WHEEL_TOP) - 1) & WHEEL_MASK;
+        at = ((wheel.now >> LEVEL_SHIFT(WHEEL_TOP)) + WHEEL_MASK) << LEVEL_SHIFT(WHEEL_TOP);
+    } else {
+        slot = LEVEL_SLOT(at, level);
+    }
+
+    if (level > 0) {
+        uint32_t *slot_due = &wheel.slot_due[level - 1][slot];
+        if (!wheel.slots[level][slot] || (int32_t)(at - *slot_due) < 0) {
+            *slot_due = at;
+        }
+    }
+
+    t->due = at;
+    t->level = level;
+    t->slot = slot;
+    t->prev = NULL;
+    t->next = wheel.slots[level][slot];
+    if (t->next) {
+        t->next->prev = t;
+    }
+    wheel.slots[level][slot] = t;
+    wheel.occupied[level] |= (uint64_t)1 << slot;
+    t->linked = true;
 }
 
-void timer_stop(void) {
-    tmr.running = false;
-    tmr.paused = false;
+static void wheel_unlink(Timer_t *t) {
+    if (!t->linked) return;
+
+    if (t->prev) {
+        t->prev->next = t->next;
+    } else {
+        wheel.slots[t->level][t->slot] = t->next;
+    }
+    if (t->next) {
+        t->next->prev = t->prev;
+    }
+    if (!wheel.slots[t->level][t->slot]) {
+        wheel.occupied[t->level] &= ~((uint64_t)1 << t->slot);
+        if (t->level > 0) {
+            wheel.stale[t->level - 1] &= ~((uint64_t)1 << t->slot);
+        }
+    } else if (t->level > 0 && t->due == wheel.slot_due[t->level - 1][t->slot]) {
+        // Found again by timer_next_deadline() if it asks
+        wheel.stale[t->level - 1] |= (uint64_t)1 << t->slot;
+    }
+    t->linked = false;
 }
 
-void timer_restart(uint32_t ms) {
-    if (tmr.on_tick || tmr.on_finished) {
-        timer_start(ms, tmr.on_tick, tmr.on_finished);
+// Move the timers of the current slot of a level one level down (or keep
+// the far ones in the top level)
+static void wheel_cascade(uint8_t level) {
+    uint8_t slot = LEVEL_SLOT(wheel.now, level);
+    Timer_t *t = wheel.slots[level][slot];
+
+    wheel.slots[level][slot] = NULL;
+    wheel.occupied[level] &= ~((uint64_t)1 << slot);
+    wheel.stale[level - 1] &= ~((uint64_t)1 << slot);
+
+    while (t) {
+        Timer_t *next = t->next;
+        wheel_link(t);
+        t = next;
     }
 }
 
-bool timer_is_running(void) {
-    return tmr.running;
+// Move the wheel forward. The slots skipped on the way must be empty; the
+// slots that become current are spread over the levels below.
+static void wheel_advance(uint32_t to) {
+    uint8_t l = WHEEL_TOP;
+
+    while (l > 0 && (wheel.now >> LEVEL_SHIFT(l)) == (to >> LEVEL_SHIFT(l))) {
+        l--;
+    }
+
+    wheel.now = to;
+    for (; l > 0; l--) {
+        wheel_cascade(l);
+    }
 }
 
-void timer_tick_handler(void)
-{
-    if (!tmr.running || tmr.paused) {
-        // LV_LOG_USER("[TIMER] Not running or paused\n");
-        return;
+// Start of the first non-empty slot at or after wheel.now
+static bool wheel_next_slot(uint32_t *at, uint8_t *level, uint8_t *slot) {
+    uint32_t cur = LEVEL_SLOT(wheel.now, 0);
+    uint64_t bits = wheel.occupied[0] >> cur;
+    uint8_t l;
+
+    if (bits) {
+        *level = 0;
+        *slot = cur + lowest_bit(bits);
+        *at = wheel.now + lowest_bit(bits);
+        return true;
+    }
+
+    // Below the top, the current slot was cascaded on the way in
+    for (l = 1; l < WHEEL_TOP; l++) {
+        cur = LEVEL_SLOT(wheel.now, l);
+        bits = (cur == WHEEL_MASK) ? 0 : (wheel.occupied[l] >> (cur + 1));
+        if (bits) {
+            *level = l;
+            *slot = cur + 1 + lowest_bit(bits);
+            *at = ((wheel.now >> LEVEL_SHIFT(l + 1)) << LEVEL_SHIFT(l + 1)) +
+                  ((uint32_t)*slot << LEVEL_SHIFT(l));
+            return true;
+        }
+    }
+
+    // The top level wraps around
+    cur = (LEVEL_SLOT(wheel.now, WHEEL_TOP) + 1) & WHEEL_MASK;
+    bits = wheel.occupied[WHEEL_TOP];
+    bits = cur ? ((bits >> cur) | (bits << (WHEEL_SIZE - cur))) : bits;
+    if (bits) {
+        uint32_t dist = lowest_bit(bits) + 1;
+        *level = WHEEL_TOP;
+        *slot = (cur + dist - 1) & WHEEL_MASK;
+        *at = ((wheel.now >> LEVEL_SHIFT(WHEEL_TOP)) + dist) << LEVEL_SHIFT(WHEEL_TOP);
+        return true;
     }
 
+    return false;
+}
+
+// ====================== Timers ======================
+
+static Timer_t *timer_get(timer_id_t id) {
+    uint32_t idx = (id & 0xFFFF) - 1;
+
+    if (id == TIMER_ID_NONE || idx >= TIMER_MAX) return NULL;
+    if (!wheel.pool[idx].used || wheel.pool[idx].gen != (uint16_t)(id >> 16)) return NULL;
+    return &wheel.pool[idx];
+}
+
+static void timer_release(Timer_t *t) {
+    wheel_unlink(t);
+    t->used = false;
+    t->gen++;
+    t->next = wheel.free_list;
+    wheel.free_list = t;
+}
+
+static uint32_t remaining_at(const Timer_t *t, uint32_t now) {
+    uint32_t elapsed = now - t->start_tick - t->pause_duration;
+    return (elapsed >= t->duration) ? 0 : (t->duration - elapsed);
+}
+
+// Time from the last event to the next one
+static uint32_t next_step(const Timer_t *t, uint32_t remaining) {
+    uint32_t to_second = remaining % 1000;
+
+    // Durations are whole seconds, so this is also the next second since the start
+    if (!t->on_tick || remaining == 0) return remaining;
+    return to_second ? to_second : 1000;
+}
+
+static void timer_arm(Timer_t *t, uint32_t ms) {
     uint32_t now = get_tick_ms();
-    uint32_t elapsed = now - tmr.start_tick - tmr.pause_duration;
-    
-    // Store current remaining time
-    tmr.current_remaining = (elapsed >= tmr.duration) ? 0 : (tmr.duration - elapsed);
-    tmr.last_tick = now;
-    
-    if (tmr.current_remaining > 0) {
-        if (tmr.on_tick) {
-            tmr.on_tick(tmr.current_remaining);
+
+    wheel_unlink(t);
+    t->duration = ms;
+    t->start_tick = now;
+    t->last_tick = now;
+    t->pause_duration = 0;
+    t->paused = false;
+    t->current_remaining = ms;
+    t->expires = now + next_step(t, ms);
+    wheel_link(t);
+}
+
+static void timer_fire(Timer_t *t) {
+    uint32_t remaining = remaining_at(t, wheel.now);
+
+    t->current_remaining = remaining;
+    t->last_tick = wheel.now;
+
+    if (remaining > 0) {
+        // Re-armed first, so the callback may stop or pause it
+        t->expires = wheel.now + next_step(t, remaining);
+        wheel_link(t);
+        if (t->on_tick) {
+            t->on_tick(remaining);
         }
     } else {
-        tmr.running = false;
-        if (tmr.on_finished) {
-            tmr.on_finished();
+        void (*on_finished)(void) = t->on_finished;
+
+        // Released first, so the callback can start the next timer
+        timer_release(t);
+        if (on_finished) {
+            on_finished();
         }
     }
+}
+
+void timer_init(void) {
+    uint32_t i;
+
+    memset(&wheel, 0, sizeof(wheel));
+    for (i = TIMER_MAX; i > 0; i--) {
+        wheel.pool[i - 1].next = wheel.free_list;
+        wheel.free_list = &wheel.pool[i - 1];
+    }
+    wheel.now = get_tick_ms();
+}
+
+timer_id_t timer_start(uint32_t ms,
+                       void (*on_tick)(uint32_t),
+                       void (*on_finished)(void)) {
+    Timer_t *t = wheel.free_list;
 
+    if (!t) {
+        LV_LOG_WARN("[TIMER] All %d timers in use\n", TIMER_MAX);
+        return TIMER_ID_NONE;
+    }
+    wheel.free_list = t->next;
+
+    t->used = true;
+    t->linked = false;
+    t->on_tick = on_tick;
+    t->on_finished = on_finished;
+    timer_arm(t, ms);
+
+    return ((timer_id_t)t->gen << 16) | (uint32_t)(t - wheel.pool + 1);
+}
+
+void timer_stop(timer_id_t id) {
+    Timer_t *t = timer_get(id);
+    if (t) {
+        timer_release(t);
+    }
 }
 
-void timer_pause(void)
+void timer_restart(timer_id_t id, uint32_t ms) {
+    Timer_t *t = timer_get(id);
+    if (t) {
+        timer_arm(t, ms);
+    }
+}
+
+bool timer_is_running(timer_id_t id) {
+    return timer_get(id) != NULL;
+}
+
+void timer_tick_handler(void)
 {
-    if (tmr.running && !tmr.paused) {
-        tmr.paused = true;
-        tmr.pause_tick = tmr.last_tick; // Use last tick time instead of current time
-        
-        // Use stored remaining time from last tick
-        if (tmr.on_tick) {
-            tmr.on_tick(tmr.current_remaining);
+    uint32_t target = get_tick_ms();
+    uint32_t at;
+    uint8_t level, slot;
+
+    while (wheel_next_slot(&at, &level, &slot) && (int32_t)(target - at) >= 0) {
+        wheel_advance(at);
+
+        // Callbacks may add timers that are due right away
+        slot = LEVEL_SLOT(wheel.now, 0);
+        while (wheel.slots[0][slot]) {
+            Timer_t *t = wheel.slots[0][slot];
+            wheel_unlink(t);
+            timer_fire(t);
+        }
+
+        // A higher level slot can start here and hold later events only
+        if (level == 0) {
+            wheel_advance(wheel.now + 1);
         }
     }
+
+    // Nothing due up to target
+    if ((int32_t)(target + 1 - wheel.now) > 0) {
+        wheel_advance(target + 1);
+    }
 }
 
-void timer_resume(void) {
-    if (tmr.paused) {
+void timer_pause(timer_id_t id)
+{
+    Timer_t *t = timer_get(id);
+
+    if (t && !t->paused) {
+        wheel_unlink(t);
+        t->paused = true;
+
+        if (t->on_tick) {
+            // Use last tick time instead of current time
+            t->pause_tick = t->last_tick;
+
+            // Use stored remaining time from last tick
+            t->on_tick(t->current_remaining);
+        } else {
+            // Nothing was shown, keep what really elapsed
+            t->pause_tick = get_tick_ms();
+            t->current_remaining = remaining_at(t, t->pause_tick);
+        }
+    }
+}
+
+void timer_resume(timer_id_t id) {
+    Timer_t *t = timer_get(id);
+
+    if (t && t->paused) {
         // Calculate how long we were paused
         uint32_t now = get_tick_ms();
-        tmr.pause_duration += (now - tmr.pause_tick);
-        
+        t->pause_duration += (now - t->pause_tick);
+
         // Clear pause state
-        tmr.paused = false;
+        t->paused = false;
+        t->last_tick = now;
+        t->expires = now + next_step(t, t->current_remaining);
+        wheel_link(t);
     }
 }
 
-uint32_t timer_get_remaining(void)
+uint32_t timer_next_deadline(void)
 {
-    if (!tmr.running) return tmr.duration;
-    if (tmr.paused) return tmr.current_remaining;
-    
+    uint32_t at;
+    uint8_t level, slot;
+
+    if (!wheel_next_slot(&at, &level, &slot)) return TIMER_NO_DEADLINE;
+
+    // Above level 0 a slot spans many ms, its earliest event is kept. Only
+    // after that timer left the slot is it searched again
+    if (level > 0) {
+        uint64_t bit = (uint64_t)1 << slot;
+
+        if (wheel.stale[level - 1] & bit) {
+            Timer_t *t = wheel.slots[level][slot];
+
+            at = t->due;
+            for (t = t->next; t; t = t->next) {
+                if ((int32_t)(t->due - at) < 0) {
+                    at = t->due;
+                }
+            }
+            wheel.slot_due[level - 1][slot] = at;
+            wheel.stale[level - 1] &= ~bit;
+        }
+        at = wheel.slot_due[level - 1][slot];
+    }
+
     uint32_t now = get_tick_ms();
-    uint32_t elapsed = now - tmr.start_tick - tmr.pause_duration;
-    return (elapsed >= tmr.duration) ? 0 : (tmr.duration - elapsed);
+    return ((int32_t)(at - now) > 0) ? (at - now) : 0;
+}
+
+void timer_set_tick_source(uint32_t (*get_tick)(void))
+{
+    tick_source = get_tick;
+}
+
+uint32_t timer_get_remaining(timer_id_t id)
+{
+    Timer_t *t = timer_get(id);
+
+    if (!t) return 0;
+    if (t->paused) return t->current_remaining;
+
+    return remaining_at(t, get_tick_ms());
+}
+
+#if TIMER_TEST
+
+#include "debug_test.h"
+
+// Whole seconds left, rounded up like the countdown labels show them
+#define TEST_SHOWN(ms)  (((ms) + 999) / 1000)
+
+static struct {
+    uint32_t now;               // The virtual clock
+    uint32_t ticks;             // on_tick calls
+    uint32_t remaining;         // Last on_tick value
+    uint32_t shown;             // What the label shows
+    uint32_t finished;          // on_finished calls
+    uint32_t finished_at;
+} test;
+
+static uint32_t test_clock(void) {
+    return test.now;
+}
+
+static void test_on_tick(uint32_t remaining) {
+    test.ticks++;
+    test.remaining = remaining;
+    test.shown = TEST_SHOWN(remaining);
 }
+
+static void test_on_finished(void) {
+    test.finished++;
+    test.finished_at = test.now;
+    test.shown = 0;
+}
+
+static timer_id_t test_start(uint32_t ms) {
+    test.ticks = 0;
+    test.finished = 0;
+    test.shown = TEST_SHOWN(ms);
+    return timer_start(ms, test_on_tick, test_on_finished);
+}
+
+static uint32_t timer_test_run(uint32_t base) {
+    timer_id_t id;
+    uint32_t start, t, d, step;
+
+    test.now = base;
+    timer_init();
+    TEST_CHECK(timer_next_deadline() == TIMER_NO_DEADLINE);
+
+    // Polled every ms: the label flips on the ms the second ends, never before
+    id = test_start(5000);
+    start = test.now;
+    for (t = 1; t <= 5000; t++) {
+        test.now = start + t;
+        timer_tick_handler();
+        TEST_CHECK(test.shown == TEST_SHOWN(5000 - t));
+        TEST_CHECK(test.ticks == (t < 5000 ? t / 1000 : 4));
+        TEST_CHECK(test.ticks == 0 || test.remaining % 1000 == 0);
+    }
+    TEST_CHECK(test.finished == 1 && test.finished_at == start + 5000);
+    TEST_CHECK(!timer_is_running(id));
+    TEST_CHECK(timer_next_deadline() == TIMER_NO_DEADLINE);
+
+    // Woken by the deadline like the main screen: nothing one ms before,
+    // exactly one flip on it
+    id = test_start(3000);
+    start = test.now;
+    for (step = 1; step <= 3; step++) {
+        d = timer_next_deadline();
+        TEST_CHECK(d == 1000);
+        test.now += d - 1;
+        timer_tick_handler();
+        TEST_CHECK(test.ticks == step - 1 && test.finished == 0);
+        TEST_CHECK(test.shown == 3 - (step - 1));
+        test.now++;
+        timer_tick_handler();
+        TEST_CHECK(test.shown == 3 - step);
+        TEST_CHECK(timer_get_remaining(id) == 3000 - step * 1000);
+    }
+    TEST_CHECK(test.ticks == 2 && test.finished == 1 && test.finished_at == start + 3000);
+    TEST_CHECK(timer_next_deadline() == TIMER_NO_DEADLINE);
+
+    // A late wake-up catches up in order and ends on the right second
+    id = test_start(5000);
+    test.now += 2500;
+    TEST_CHECK(timer_next_deadline() == 0);
+    timer_tick_handler();
+    TEST_CHECK(test.ticks == 2 && test.remaining == 3000 && test.shown == 3);
+    TEST_CHECK(timer_next_deadline() == 500);
+    timer_stop(id);
+    TEST_CHECK(timer_next_deadline() == TIMER_NO_DEADLINE);
+
+    // Paused mid-second: the label stays, and the paused second is shown
+    // in full again after resuming
+    id = test_start(4000);
+    test.now += 1500;
+    timer_tick_handler();
+    TEST_CHECK(test.ticks == 1 && test.shown == 3);
+    timer_pause(id);
+    TEST_CHECK(test.ticks == 2 && test.remaining == 3000);
+    TEST_CHECK(timer_next_deadline() == TIMER_NO_DEADLINE);
+    test.now += 10000;
+    timer_tick_handler();
+    TEST_CHECK(test.ticks == 2 && test.shown == 3 && timer_get_remaining(id) == 3000);
+    timer_resume(id);
+    TEST_CHECK(timer_get_remaining(id) == 3000);
+    TEST_CHECK(timer_next_deadline() == 1000);
+    test.now += 999;
+    timer_tick_handler();
+    TEST_CHECK(test.ticks == 2 && test.shown == 3);
+    test.now++;
+    timer_tick_handler();
+    TEST_CHECK(test.ticks == 3 && test.remaining == 2000 && test.shown == 2);
+    timer_stop(id);
+
+    return 0;
+}
+
+uint32_t timer_test(void) {
+    uint32_t line;
+
+    timer_set_tick_source(test_clock);
+
+    line = timer_test_run(0);
+    // The clock wraps in the middle of the countdowns
+    if (line == 0) line = timer_test_run(UINT32_MAX - 2600);
+
+    timer_set_tick_source(NULL);
+    timer_init();
+
+    return line;
+}
+
+#endif // TIMER_TEST
+
+#if TIMER_BENCH
+
+// Operations per measurement, lv_tick_get() has 1 ms resolution
+#ifndef TIMER_BENCH_OPS
+#define TIMER_BENCH_OPS     100000
+#endif
+
+// Wake-ups of the reference check per timer count
+#define BENCH_CHECK_WAKES   3000
+
+#define BENCH_NONE          UINT32_MAX
+
+// What the wheel has to do for one timer, worked out the slow way
+typedef struct {
+    timer_id_t id;
+    uint32_t end;               // Expiry
+    uint32_t next;              // Next event, BENCH_NONE once finished
+    bool ticks;                 // Has an on_tick callback
+} bench_ref_t;
+
+static struct {
+    uint32_t now;               // The virtual clock
+    uint32_t rnd;
+    uint32_t events;            // on_tick and on_finished calls
+    uint32_t fails;             // Reference mismatches
+    bool refill;                // Replace the finished timers, the reference isn't kept
+    bench_ref_t ref[TIMER_MAX];
+} bench;
+
+static uint32_t bench_clock(void) {
+    return bench.now;
+}
+
+static uint32_t bench_rand(void) {
+    // xorshift32, the same sequence on every run
+    bench.rnd ^= bench.rnd << 13;
+    bench.rnd ^= bench.rnd >> 17;
+    bench.rnd ^= bench.rnd << 5;
+    return bench.rnd;
+}
+
+static void bench_on_tick(uint32_t remaining) {
+    (void)remaining;
+    bench.events++;
+}
+
+static void bench_on_finished(void) {
+    bench.events++;
+    if (bench.refill) {
+        timer_start((1 + bench_rand() % 3600) * 1000, (bench_rand() & 1) ? bench_on_tick : NULL,
+                    bench_on_finished);
+    }
+}
+
+// Replace timer i by a new one of 1 s to 1 h, half of them ticking
+static void bench_restart(uint32_t i) {
+    bench_ref_t *r = &bench.ref[i];
+    uint32_t ms = (1 + bench_rand() % 3600) * 1000;
+
+    timer_stop(r->id);
+    r->ticks = bench_rand() & 1;
+    r->id = timer_start(ms, r->ticks ? bench_on_tick : NULL, bench_on_finished);
+    r->end = bench.now + ms;
+    r->next = (r->ticks && ms > 1000) ? bench.now + 1000 : r->end;
+}
+
+static void bench_fill(uint32_t n) {
+    uint32_t base = bench_rand();
+    uint32_t i;
+
+    bench.now = base;
+    timer_init();
+    for (i = 0; i < n; i++) {
+        // Spread the starts over the first second, so the seconds of the
+        // timers don't line up and none is due before the reference starts
+        bench.now = base + i * 999 / n;
+        timer_tick_handler();
+        bench_restart(i);
+    }
+}
+
+// Earliest event of the reference, BENCH_NONE if all finished
+static uint32_t bench_ref_next(uint32_t n) {
+    uint32_t at = BENCH_NONE;
+    uint32_t i;
+
+    for (i = 0; i < n; i++) {
+        if (bench.ref[i].next == BENCH_NONE) continue;
+        if (at == BENCH_NONE || (int32_t)(bench.ref[i].next - at) < 0) {
+            at = bench.ref[i].next;
+        }
+    }
+    return at;
+}
+
+// Wake up on every deadline and compare the wheel with the reference
+static void bench_check(uint32_t n) {
+    uint32_t wake, i, at, due;
+
+    for (wake = 0; wake < BENCH_CHECK_WAKES; wake++) {
+        if (bench_rand() % 4 == 0) {
+            bench_restart(bench_rand() % n);
+        }
+
+        at = bench_ref_next(n);
+        if (at == BENCH_NONE) {
+            if (timer_next_deadline() != TIMER_NO_DEADLINE) bench.fails++;
+            break;
+        }
+        if (timer_next_deadline() != at - bench.now) {
+            bench.fails++;
+            break;
+        }
+
+        bench.now = at;
+        due = 0;
+        for (i = 0; i < n; i++) {
+            bench_ref_t *r = &bench.ref[i];
+            if (r->next != at) continue;
+            due++;
+            if (at == r->end) {
+                r->next = BENCH_NONE;
+            } else {
+                r->next = (r->ticks && at + 1000 != r->end) ? at + 1000 : r->end;
+            }
+        }
+
+        bench.events = 0;
+        timer_tick_handler();
+        if (bench.events != due) bench.fails++;
+
+        for (i = 0; i < n; i++) {
+            bench_ref_t *r = &bench.ref[i];
+            bool running = r->next != BENCH_NONE;
+            if (timer_is_running(r->id) != running ||
+                timer_get_remaining(r->id) != (running ? r->end - bench.now : 0)) {
+                bench.fails++;
+            }
+        }
+    }
+}
+
+// ns per operation from the ms the operations took
+static uint32_t bench_ns(uint32_t start, uint32_t ops) {
+    return ops ? (uint32_t)((uint64_t)lv_tick_elaps(start) * 1000000 / ops) : 0;
+}
+
+static void bench_run(uint32_t n) {
+    uint32_t i, start, ns_restart, ns_deadline, ns_wake, ns_event, wakes, events;
+    volatile uint32_t sink = 0;
+
+    bench_fill(n);
+    bench_check(n);
+
+    // Stop one timer and start its replacement
+    bench_fill(n);
+    start = lv_tick_get();
+    for (i = 0; i < TIMER_BENCH_OPS; i++) {
+        bench_restart(bench_rand() % n);
+    }
+    ns_restart = bench_ns(start, 2 * TIMER_BENCH_OPS);
+
+    // The replacements all started on the same ms, spread them again
+    bench_fill(n);
+    start = lv_tick_get();
+    for (i = 0; i < TIMER_BENCH_OPS; i++) {
+        sink += timer_next_deadline();
+    }
+    ns_deadline = bench_ns(start, TIMER_BENCH_OPS);
+    (void)sink;
+
+    // The main loop: sleep until the deadline, run what is due
+    bench.refill = true;
+    bench.events = 0;
+    start = lv_tick_get();
+    for (wakes = 0; wakes < TIMER_BENCH_OPS; wakes++) {
+        uint32_t d = timer_next_deadline();
+        if (d == TIMER_NO_DEADLINE) break;
+        bench.now += d;
+        timer_tick_handler();
+    }
+    events = bench.events;
+    bench.refill = false;
+    ns_wake = bench_ns(start, wakes);
+    ns_event = bench_ns(start, events);
+
+    LV_LOG_USER("Timer bench: %4lu timers, start/stop %lu ns, next_deadline %lu ns, "
+                "wake %lu ns (%lu events in %lu wakes, %lu ns each)%s",
+                (unsigned long)n, (unsigned long)ns_restart, (unsigned long)ns_deadline,
+                (unsigned long)ns_wake, (unsigned long)events, (unsigned long)wakes,
+                (unsigned long)ns_event, bench.fails ? ", REFERENCE MISMATCH" : "");
+}
+
+void timer_bench_run(void) {
+    uint32_t n;
+
+    timer_set_tick_source(bench_clock);
+    bench.rnd = 0x2545F491;
+    bench.fails = 0;
+
+    for (n = 16; n < TIMER_MAX; n *= 4) {
+        bench_run(n);
+    }
+    bench_run(TIMER_MAX);
+
+    timer_set_tick_source(NULL);
+    timer_init();
+}
+
+#endif // TIMER_BENCH
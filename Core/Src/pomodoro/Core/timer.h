@@ -6,34 +6,89 @@
 
 // #define USE_HAL_TICK   1
 
-/// Initialize timer system
+/// 1: timer_test() is built, it runs the countdown on a virtual clock
+#ifndef TIMER_TEST
+#define TIMER_TEST          0
+#endif
+
+/// 1: timer_bench_run() is built, it times the wheel with many random timers
+#ifndef TIMER_BENCH
+#define TIMER_BENCH         0
+#endif
+
+/// Timers that can run at the same time
+#ifndef TIMER_MAX
+#if TIMER_BENCH
+#define TIMER_MAX           512     // The bench runs up to this many, the host can take more
+#else
+#define TIMER_MAX           8
+#endif
+#endif
+
+/// timer_next_deadline() when nothing is due: stopped or paused
+#define TIMER_NO_DEADLINE   UINT32_MAX
+
+/// Handle of a started timer, it goes stale when the timer finishes or stops
+typedef uint32_t timer_id_t;
+
+/// Never a valid handle
+#define TIMER_ID_NONE       0
+
+/// Initialize timer system, drops all timers
 void timer_init(void);
 
 /// Start a countdown timer
 /// @param ms duration in milliseconds
-/// @param on_tick callback for each tick (can be NULL). Parameter = remaining time in ms
+/// @param on_tick callback on each whole second of the remaining time (can be NULL). Parameter = remaining time in ms
 /// @param on_finished callback when timer expires (can be NULL)
-void timer_start(uint32_t ms,
-                 void (*on_tick)(uint32_t),
-                 void (*on_finished)(void));
+/// @return handle of the timer, TIMER_ID_NONE if all TIMER_MAX are in use
+timer_id_t timer_start(uint32_t ms,
+                       void (*on_tick)(uint32_t),
+                       void (*on_finished)(void));
 
-/// Stop the current timer
-void timer_stop(void);
+/// Stop a timer, its handle goes stale
+void timer_stop(timer_id_t id);
 
-/// Restart timer with new duration (keeps same callbacks)
-void timer_restart(uint32_t ms);
+/// Restart timer with new duration (keeps same callbacks and handle)
+void timer_restart(timer_id_t id, uint32_t ms);
 
-/// Check if timer is running
-bool timer_is_running(void);
+/// Check if timer is running (paused counts as running)
+bool timer_is_running(timer_id_t id);
 
-/// Get remaining time (ms), 0 if stopped
-uint32_t timer_get_remaining(void);
+/// Get remaining time (ms), 0 if stopped or finished
+uint32_t timer_get_remaining(timer_id_t id);
 
-/// Pause and resume
-void timer_pause(void);
-void timer_resume(void);
+/// Pause and resume. The time since the last on_tick is not counted as
+/// elapsed, so the paused second is shown again after resuming
+void timer_pause(timer_id_t id);
+void timer_resume(timer_id_t id);
 
-/// To be called periodically from main loop or SysTick
+/// To be called periodically from main loop or SysTick, runs the callbacks
+/// of all timers that are due
 void timer_tick_handler(void);
 
+/// Time until timer_tick_handler() has something to do for any timer: a
+/// remaining time reaching the next whole second, or an expiry
+/// @return milliseconds, 0 if overdue, TIMER_NO_DEADLINE if no timer runs
+uint32_t timer_next_deadline(void);
+
+/// Replace the millisecond tick source, e.g. with a virtual clock on the host
+/// @param get_tick returns the current time in ms, NULL for the platform tick
+void timer_set_tick_source(uint32_t (*get_tick)(void));
+
+#if TIMER_TEST
+/// Check the callbacks against a virtual clock. Drops all timers, call it
+/// before anything started one
+/// @return 0 if all checks passed, else the line of the first failed one
+uint32_t timer_test(void);
+#endif
+
+#if TIMER_BENCH
+/// Time start/stop, the wake-ups and timer_next_deadline() with 16 up to
+/// TIMER_MAX random timers on a virtual clock, checked against a reference,
+/// and log the cost per operation. Drops all timers, call it before
+/// anything started one; it blocks for a few seconds.
+void timer_bench_run(void);
+#endif
+
 #endif // TIMER_H
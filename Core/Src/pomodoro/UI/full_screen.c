@@ -1,6 +1,7 @@
 #include <stdint.h>
 #include "lvgl.h"
 #include "settings_screen.h"
+#include "pomodoro.h"
 
 static lv_obj_t *fullscreen_timer_cont = NULL;
 static lv_obj_t *fullscreen_timer_label = NULL;
@@ -8,6 +9,7 @@ static lv_obj_t *fullscreen_timer_label = NULL;
 static void ui_full_screen_set_bg_by_theme(lv_obj_t *parent);
 static void ui_full_screen_fade_in_obj(lv_obj_t *obj, uint32_t duration_ms);
 static void ui_full_screen_fade_out_obj(lv_obj_t *obj, uint32_t duration_ms);
+static void remaining_observer_cb(lv_observer_t *observer, lv_subject_t *subject);
 
 void show_fullscreen_timer(lv_obj_t *parent)
 {
@@ -17,23 +19,17 @@ void show_fullscreen_timer(lv_obj_t *parent)
     ui_full_screen_set_bg_by_theme(fullscreen_timer_cont);
     ui_full_screen_fade_in_obj(fullscreen_timer_cont, 2000); // Fade in over 2 seconds
 
+    LV_FONT_DECLARE(font_timer_48);  // "0123456789:" only, see assets/font_subset.py
     fullscreen_timer_label = lv_label_create(fullscreen_timer_cont);
     lv_obj_center(fullscreen_timer_label);
-    lv_obj_set_style_text_font(fullscreen_timer_label, &lv_font_montserrat_48, 0);
-    lv_label_set_text(fullscreen_timer_label, "00:00");
+    lv_obj_set_style_text_font(fullscreen_timer_label, &font_timer_48, 0);
     lv_obj_set_style_text_color(fullscreen_timer_label, lv_color_hex(0x008080), 0);
+    // Shows the same remaining time as the main screen, unbound when deleted
+    lv_subject_add_observer_obj(pomodoro_subject_remaining(), remaining_observer_cb,
+                                fullscreen_timer_label, NULL);
     lv_obj_move_foreground(fullscreen_timer_cont);
 }
 
-void update_fullscreen_timer(uint32_t remaining)
-{
-    remaining /= 1000; // Convert ms to seconds
-    if (!fullscreen_timer_label) return;
-    char buf[8];
-    lv_snprintf(buf, sizeof(buf), "%02d:%02d", remaining / 60, remaining % 60);
-    lv_label_set_text(fullscreen_timer_label, buf);
-}
-
 void hide_fullscreen_timer(void)
 {
     if (fullscreen_timer_cont) {
@@ -63,6 +59,14 @@ static void ui_full_screen_set_bg_by_theme(lv_obj_t *parent)
     }
 }
 
+static void remaining_observer_cb(lv_observer_t *observer, lv_subject_t *subject)
+{
+    int32_t remaining = lv_subject_get_int(subject);
+
+    lv_label_set_text_fmt(lv_observer_get_target_obj(observer), "%02d:%02d",
+                          (int)(remaining / 60), (int)(remaining % 60));
+}
+
 static void anim_set_opa_cb(void *var, int32_t value)
 {
     lv_obj_set_style_opa((lv_obj_t *)var, value, LV_PART_MAIN);
@@ -5,7 +5,6 @@
 #include "lvgl.h"
 
 void show_fullscreen_timer(lv_obj_t *parent);
-void update_fullscreen_timer(uint32_t remaining);
 void hide_fullscreen_timer(void);
 
 #endif/* __H_FULL_SCREEN_H__ */
@@ -5,11 +5,27 @@
 #include "timer.h"
 #include "pomodoro.h"
 #include "settings_screen.h"
+#include "screen_manager.h"
 #include "main_screen.h"
 #include "full_screen.h"
+#include "progress_ring.h"
 
 #define POMO_MOVE_TO_FULLSCREEN_SEC     10
 
+// 1: log the widget writes and invalidated pixels of every countdown second,
+// next to the writes the per-tick callback made before the observers
+#define UI_TICK_STATS                   0
+
+/* Visible mode icons, same order as icon_obj[] in ui_mode_icon_observer_cb() */
+enum {
+    UI_ICON_READY       = 1 << 0,
+    UI_ICON_RUN         = 1 << 1,
+    UI_ICON_RACE        = 1 << 2,
+    UI_ICON_SPEED       = 1 << 3,
+    UI_ICON_SHORT_BREAK = 1 << 4,
+    UI_ICON_LONG_BREAK  = 1 << 5,
+};
+
 static lv_obj_t *main_cont;
 
 static lv_obj_t *label_mode;
@@ -38,25 +54,52 @@ static lv_obj_t *long_break_icon;
 // static lv_obj_t *objective_icon;
 
 static bool timer_running = false;
-static int work_state_elapsed_sec = 0;
+static timer_id_t fullscreen_delay = TIMER_ID_NONE;
 static bool fullscreen_timer_active = false;
 static bool fullscreen_enable = false;
+static lv_timer_t *tick_timer = NULL;
+
+/* Colour of the timer label and the progress arc indicator */
+static const uint32_t band_color[] = {
+    [POMODORO_BAND_CALM] = 0x4A90E2,
+    [POMODORO_BAND_HALF] = 0x9B59B6,
+    [POMODORO_BAND_LATE] = 0xE74C3C,
+};
+
+#if UI_TICK_STATS
+static uint32_t stat_writes;
+static uint32_t stat_old_writes;
+static uint32_t stat_areas;
+static uint32_t stat_px;
+#define UI_STAT_WRITES(n)   (stat_writes += (n))
+#else
+#define UI_STAT_WRITES(n)   ((void)0)
+#endif
 
 /* Forward declarations */
 static void ui_main_screen_set_bg_by_theme(lv_obj_t *parent);
 static void ui_main_screen_init_style_by_theme(void);
-static void update_timer_label(uint32_t remaining_ms);
+static void ui_main_screen_bind(void);
+#if UI_TICK_STATS
+static void ui_stats_invalidate_cb(lv_event_t *e);
+static uint32_t ui_stats_old_writes(PomodoroState_e state);
+#endif
 
 static void start_event_cb(lv_event_t *e);
 static void reset_event_cb(lv_event_t *e);
 static void setting_event_cb(lv_event_t *e);
 
-static void pomodoro_state_changed(PomodoroState_e state);
+static void ui_state_observer_cb(lv_observer_t *observer, lv_subject_t *subject);
+static void ui_timer_label_observer_cb(lv_observer_t *observer, lv_subject_t *subject);
+static void ui_band_observer_cb(lv_observer_t *observer, lv_subject_t *subject);
+static void ui_mode_icon_observer_cb(lv_observer_t *observer, lv_subject_t *subject);
+static void ui_cycle_observer_cb(lv_observer_t *observer, lv_subject_t *subject);
 static void timer_tick_cb(lv_timer_t * timer);
-static void ui_tick_cb(uint32_t remaining);
+static void timer_reschedule(void);
+static void fullscreen_delay_cb(void);
 static void ui_update_ctrl_button(PomodoroState_e state);
 static void ui_update_state_text(PomodoroState_e state);
-static void ui_update_cycle_counter(void);
+static void ui_update_progress_range(void);
 
 /* --- UI Functions --- */
 
@@ -139,59 +182,68 @@ static void label_event_cb(lv_event_t * e)
     }
 }
 
-void ui_main_screen_update_mode_icon(PomodoroState_e curr_state) {
-
-    // Hide all icons initially
-    if (ready_icon)         lv_obj_add_flag(ready_icon, LV_OBJ_FLAG_HIDDEN);
-    if (work_race_icon)     lv_obj_add_flag(work_race_icon, LV_OBJ_FLAG_HIDDEN);
-    if (work_run_icon)      lv_obj_add_flag(work_run_icon, LV_OBJ_FLAG_HIDDEN);
-    if (work_speed_icon)    lv_obj_add_flag(work_speed_icon, LV_OBJ_FLAG_HIDDEN);
-    // if (objective_icon)     lv_obj_add_flag(objective_icon, LV_OBJ_FLAG_HIDDEN);
-    if (short_break_icon)   lv_obj_add_flag(short_break_icon, LV_OBJ_FLAG_HIDDEN);
-    if (long_break_icon)    lv_obj_add_flag(long_break_icon, LV_OBJ_FLAG_HIDDEN);
+/* Icons follow the state and, during work, the progress band */
+static void ui_mode_icon_observer_cb(lv_observer_t *observer, lv_subject_t *subject)
+{
+    static lv_obj_t **const icon_obj[] = {
+        &ready_icon, &work_run_icon, &work_race_icon,
+        &work_speed_icon, &short_break_icon, &long_break_icon,
+    };
+    PomodoroState_e state = lv_subject_get_int(pomodoro_subject_state());
+    PomodoroBand_e band = lv_subject_get_int(pomodoro_subject_band());
+    uint8_t icons;
 
-    switch (curr_state) {
+    switch (state) {
         case POMODORO_IDLE:
-            lv_obj_clear_flag(ready_icon, LV_OBJ_FLAG_HIDDEN);
+            icons = UI_ICON_READY;
             break;
         case POMODORO_WORK:
         case POMODORO_PAUSED_WORK:
-            lv_obj_clear_flag(work_run_icon, LV_OBJ_FLAG_HIDDEN);
-            // lv_obj_clear_flag(objective_icon, LV_OBJ_FLAG_HIDDEN);
+            icons = UI_ICON_RUN;
+            if (band >= POMODORO_BAND_HALF) icons |= UI_ICON_RACE;
+            if (band >= POMODORO_BAND_LATE) icons |= UI_ICON_SPEED;
             break;
         case POMODORO_SHORT_BREAK:
-            lv_obj_clear_flag(short_break_icon, LV_OBJ_FLAG_HIDDEN);
+            icons = UI_ICON_SHORT_BREAK;
             break;
         case POMODORO_LONG_BREAK:
-            lv_obj_clear_flag(long_break_icon, LV_OBJ_FLAG_HIDDEN);
+            icons = UI_ICON_LONG_BREAK;
             break;
         case POMODORO_PAUSED_BREAK:
             if(pomodoro_get_pause_break_type() == POMODORO_SHORT_BREAK) {
-                lv_obj_clear_flag(short_break_icon, LV_OBJ_FLAG_HIDDEN);
+                icons = UI_ICON_SHORT_BREAK;
             }
             else {
-                lv_obj_clear_flag(long_break_icon, LV_OBJ_FLAG_HIDDEN);
+                icons = UI_ICON_LONG_BREAK;
             }
-
+            break;
         default:
-            // Optionally hide all
+            icons = 0;
             break;
     }
+
+    // Setting a flag that is already set doesn't invalidate the icon
+    for (uint32_t i = 0; i < sizeof(icon_obj) / sizeof(icon_obj[0]); i++) {
+        bool hidden = !(icons & (1 << i));
+
+        if (lv_obj_has_flag(*icon_obj[i], LV_OBJ_FLAG_HIDDEN) != hidden) UI_STAT_WRITES(1);
+        lv_obj_set_flag(*icon_obj[i], LV_OBJ_FLAG_HIDDEN, hidden);
+    }
 }
 
 void ui_main_screen(lv_obj_t *parent)
 {
     // Initialize systems
     event_init();
-    timer_init();
     ui_main_screen_init_style_by_theme();
 
-    // Register callbacks
-    pomodoro_set_state_callback(pomodoro_state_changed);
-    pomodoro_set_tick_callback(ui_tick_cb);
-
-    // Create periodic timer check using LVGL
-    lv_timer_create(timer_tick_cb, 1000, NULL);  // Check every 1000ms
+    // LVGL timer that fires when the countdown reaches the next second
+    timer_init();
+    tick_timer = lv_timer_create(timer_tick_cb, 1000, NULL);
+#if UI_TICK_STATS
+    lv_display_add_event_cb(lv_display_get_default(), ui_stats_invalidate_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+#endif
+    timer_reschedule();
     
     /* Grid: 6 rows, 1 column */
     static int col_dsc[] = {LV_GRID_FR(1), LV_GRID_TEMPLATE_LAST};
@@ -233,11 +285,8 @@ void ui_main_screen(lv_obj_t *parent)
     lv_style_set_img_recolor(&icon_style, lv_color_hex(0x000000));
     lv_style_set_img_recolor_opa(&icon_style, LV_OPA_100);
 
-    int img_zoom = 256;
-    #ifdef SCREEN_SIZE_240x320
-    img_zoom = 256 * 0.7;
-    #endif
-
+    // The icons are A8 and pre-scaled to the screen size by assets/icon_a8.py,
+    // no zoom: each is drawn as a plain recoloured alpha blend
     icon_mode_cont = lv_obj_create(main_cont);
     lv_obj_remove_style_all(icon_mode_cont);
     lv_obj_set_size(icon_mode_cont, LV_PCT(80), LV_PCT(100));
@@ -245,22 +294,12 @@ void ui_main_screen(lv_obj_t *parent)
     lv_obj_set_flex_flow(icon_mode_cont, LV_FLEX_FLOW_ROW);
     lv_obj_set_flex_align(icon_mode_cont, LV_FLEX_ALIGN_SPACE_EVENLY, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
 
-    //TODO: Should add main screen de-constructor for these deinit
-    if (ready_icon)         lv_obj_del(ready_icon);
-    if (work_speed_icon)    lv_obj_del(work_speed_icon);
-    if (work_run_icon)      lv_obj_del(work_run_icon);
-    if (work_race_icon)     lv_obj_del(work_race_icon);
-    // if (objective_icon)     lv_obj_del(objective_icon);
-    if (short_break_icon)   lv_obj_del(short_break_icon);
-    if (long_break_icon)    lv_obj_del(long_break_icon);
-
     LV_IMG_DECLARE(get_ready_64x64);
     ready_icon = lv_img_create(icon_mode_cont);
     lv_obj_add_style(ready_icon, &icon_style, 0);
     // lv_img_set_src(ready_icon, "S:/png/get_ready_64x64.png");
     lv_img_set_src(ready_icon, &get_ready_64x64);
     lv_obj_set_style_img_recolor(ready_icon, lv_color_hex(0xBBBBBB), 0);
-    lv_img_set_zoom(ready_icon, img_zoom);
 
     LV_IMG_DECLARE(run);
     work_run_icon = lv_img_create(icon_mode_cont);
@@ -268,7 +307,6 @@ void ui_main_screen(lv_obj_t *parent)
     // lv_img_set_src(work_run_icon, "S:/png/run.png");
     lv_img_set_src(work_run_icon, &run);
     lv_obj_set_style_img_recolor(work_run_icon, lv_color_hex(0xBBBBBB), 0);
-    lv_img_set_zoom(work_run_icon, img_zoom);
 
     LV_IMG_DECLARE(race);
     work_race_icon = lv_img_create(icon_mode_cont);
@@ -276,7 +314,6 @@ void ui_main_screen(lv_obj_t *parent)
     // lv_img_set_src(work_race_icon, "S:/png/race.png");
     lv_img_set_src(work_race_icon, &race);
     lv_obj_set_style_img_recolor(work_race_icon, lv_color_hex(0xBBBBBB), 0);
-    lv_img_set_zoom(work_race_icon, img_zoom);
 
     LV_IMG_DECLARE(speed);
     work_speed_icon = lv_img_create(icon_mode_cont);
@@ -284,7 +321,6 @@ void ui_main_screen(lv_obj_t *parent)
     // lv_img_set_src(work_speed_icon, "S:/png/speed.png");
     lv_img_set_src(work_speed_icon, &speed);
     lv_obj_set_style_img_recolor(work_speed_icon, lv_color_hex(0xBBBBBB), 0);
-    lv_img_set_zoom(work_speed_icon, img_zoom);
 
     #if 0
     LV_IMG_DECLARE(objective);
@@ -301,7 +337,6 @@ void ui_main_screen(lv_obj_t *parent)
     // lv_img_set_src(short_break_icon, "S:/png/short_break.png");
     lv_img_set_src(short_break_icon, &short_break);
     lv_obj_set_style_img_recolor(short_break_icon, lv_color_hex(0xBBBBBB), 0);
-    lv_img_set_zoom(short_break_icon, img_zoom);
 
     LV_IMG_DECLARE(long_break);
     long_break_icon = lv_img_create(icon_mode_cont);
@@ -309,9 +344,6 @@ void ui_main_screen(lv_obj_t *parent)
     // lv_img_set_src(long_break_icon, "S:/png/long_break.png");
     lv_img_set_src(long_break_icon, &long_break);
     lv_obj_set_style_img_recolor(long_break_icon, lv_color_hex(0xBBBBBB), 0);
-    lv_img_set_zoom(long_break_icon, img_zoom);
-
-    ui_main_screen_update_mode_icon(POMODORO_IDLE);
 
     /* Timer row */
     lv_obj_t *timer_cont = lv_obj_create(main_cont);
@@ -336,8 +368,6 @@ void ui_main_screen(lv_obj_t *parent)
     lv_obj_remove_style(progress, NULL, LV_PART_KNOB);   // Remove the knob
     lv_obj_clear_flag(progress, LV_OBJ_FLAG_CLICKABLE);  // Make it non-interactive
 
-    lv_arc_set_range(progress, 0, pomodoro_get_remaining_sec());
-    lv_arc_set_value(progress, pomodoro_get_remaining_sec());
     lv_arc_set_bg_angles(progress, 0, 360);
 
     // Set rotation to start from top
@@ -346,12 +376,13 @@ void ui_main_screen(lv_obj_t *parent)
 
     lv_obj_add_style(progress, &progress_main_style, LV_PART_MAIN);
     lv_obj_add_style(progress, &progress_indic_style, LV_PART_INDICATOR);
+    progress_ring_attach(progress);  // Indicator drawn from a cached ring, see progress_ring.c
 
     /* Timer label - positioned in center of circle */
+    LV_FONT_DECLARE(font_timer_28);  // "0123456789:" only, see assets/font_subset.py
     label_timer = lv_label_create(progress);  // Create as child of arc for centering
-    lv_label_set_text(label_timer, "25:00");
     lv_obj_set_style_text_color(label_timer, lv_color_hex(0x4A90E2), 0);
-    lv_obj_set_style_text_font(label_timer, &lv_font_montserrat_28, 0);
+    lv_obj_set_style_text_font(label_timer, &font_timer_28, 0);
     lv_obj_center(label_timer);  // Center within the arc
 
     label_pause = lv_label_create(timer_cont);
@@ -409,7 +440,7 @@ void ui_main_screen(lv_obj_t *parent)
 
     /* Cycle status */
     label_cycle = lv_label_create(main_cont);
-    lv_label_set_text(label_cycle, "Cycle: 0 / 4");
+    lv_obj_set_style_text_color(label_cycle, lv_color_hex(0x00FFFF), 0);
     lv_obj_set_grid_cell(label_cycle,
                          LV_GRID_ALIGN_CENTER, 0, 1,
                          LV_GRID_ALIGN_CENTER, 3, 1);
@@ -427,25 +458,50 @@ void ui_main_screen(lv_obj_t *parent)
     lv_obj_add_event_cb(label_quote, label_event_cb, LV_EVENT_ALL, NULL);
 
 
-    /* Update initial timer display */
-    update_timer_label(pomodoro_get_remaining_sec() * 1000);
+    ui_main_screen_bind();
+}
 
-    // Initialize to IDLE state
-    pomodoro_state_changed(POMODORO_IDLE);
+/* Every widget observes the subjects it shows, binding also sets it up.
+ * The state comes first: it sets the arc range the remaining time is
+ * shown in. */
+static void ui_main_screen_bind(void)
+{
+    lv_subject_add_observer_obj(pomodoro_subject_state(), ui_state_observer_cb, main_cont, NULL);
+    lv_arc_bind_value(progress, pomodoro_subject_remaining());
+    lv_subject_add_observer_obj(pomodoro_subject_remaining(), ui_timer_label_observer_cb, label_timer, NULL);
+    lv_subject_add_observer_obj(pomodoro_subject_band(), ui_band_observer_cb, label_timer, NULL);
+    lv_subject_add_observer_obj(pomodoro_subject_state(), ui_mode_icon_observer_cb, icon_mode_cont, NULL);
+    lv_subject_add_observer_obj(pomodoro_subject_band(), ui_mode_icon_observer_cb, icon_mode_cont, NULL);
+    lv_subject_add_observer_obj(pomodoro_subject_cycle(), ui_cycle_observer_cb, label_cycle, NULL);
 }
 
-static void update_timer_label(uint32_t remaining_ms)
+static void ui_timer_label_observer_cb(lv_observer_t *observer, lv_subject_t *subject)
 {
-    uint32_t total_seconds = remaining_ms / 1000;
-    uint32_t minutes = total_seconds / 60;
-    uint32_t seconds = total_seconds % 60;
+    int32_t seconds = lv_subject_get_int(subject);
+
+#if UI_TICK_STATS
+    // The previous second, with the band and icon changes published after it
+    LV_LOG_USER("ui tick: %lu widget writes (%lu before the observers), %lu areas, %lu px invalidated",
+                (unsigned long)stat_writes, (unsigned long)stat_old_writes,
+                (unsigned long)stat_areas, (unsigned long)stat_px);
+    stat_writes = 0;
+    stat_old_writes = ui_stats_old_writes(lv_subject_get_int(pomodoro_subject_state()));
+    stat_areas = 0;
+    stat_px = 0;
+#endif
 
-    static char buf[8];
-    lv_snprintf(buf, sizeof(buf), "%02d:%02d", minutes, seconds);
-    lv_label_set_text(label_timer, buf);
+    lv_label_set_text_fmt(lv_observer_get_target_obj(observer), "%02d:%02d",
+                          (int)(seconds / 60), (int)(seconds % 60));
+    UI_STAT_WRITES(2);  // The label and the arc bound to the same subject
+}
 
-    // Update progress bar using seconds
-    lv_arc_set_value(progress, total_seconds);
+static void ui_band_observer_cb(lv_observer_t *observer, lv_subject_t *subject)
+{
+    lv_color_t color = lv_color_hex(band_color[lv_subject_get_int(subject)]);
+
+    lv_obj_set_style_text_color(label_timer, color, 0);
+    lv_obj_set_style_arc_color(progress, color, LV_PART_INDICATOR);
+    UI_STAT_WRITES(2);
 }
 
 static void ui_update_ctrl_button(PomodoroState_e state)
@@ -488,7 +544,7 @@ static void ui_update_state_text(PomodoroState_e state)
             lv_label_set_text(label_mode, "Ready");
             lv_label_set_text(lv_obj_get_child(btn_start, 0), "Start");
             lv_obj_add_flag(label_pause, LV_OBJ_FLAG_HIDDEN); // Hide "Paused" label
-            update_timer_label(timer_get_remaining());
+            update_timer_label(pomodoro_get_remaining_sec() * 1000);
             break;
             
         case POMODORO_WORK:
@@ -509,55 +565,57 @@ static void ui_update_state_text(PomodoroState_e state)
         case POMODORO_PAUSED_WORK:
             lv_label_set_text(lv_obj_get_child(btn_start, 0), "Resume");
             // Keep current remaining time
-            update_timer_label(timer_get_remaining());
+            update_timer_label(pomodoro_get_remaining_sec() * 1000);
             break;
             
         case POMODORO_PAUSED_BREAK:
             lv_label_set_text(lv_obj_get_child(btn_start, 0), "Resume");
             // Keep current remaining time
-            update_timer_label(timer_get_remaining());
+            update_timer_label(pomodoro_get_remaining_sec() * 1000);
             break;
     }
 }
 #endif
 
-static void ui_update_cycle_counter(void)
+static void ui_cycle_observer_cb(lv_observer_t *observer, lv_subject_t *subject)
 {
-    char buf[32];
-    snprintf(buf, sizeof(buf), "Cycle: %d / %d", 
-             pomodoro_get_current_cycle(),
-             pomodoro_get_max_cycles());
-    lv_label_set_text(label_cycle, buf);
-    lv_obj_set_style_text_color(label_cycle, lv_color_hex(0x00FFFF), 0);
+    lv_label_set_text_fmt(lv_observer_get_target_obj(observer), "Cycle: %d / %d",
+                          (int)lv_subject_get_int(subject),
+                          pomodoro_get_max_cycles());
 }
 
-static void update_timer_and_progress(PomodoroState_e state)
+static void ui_update_progress_range(void)
 {
+    // A new session: the arc counts down from its whole length
     if (!pomodoro_is_resume_transition() && !pomodoro_is_pause_transition()) {
         lv_arc_set_range(progress, 0, pomodoro_get_remaining_sec());
-    }
-
-    // Update remaining time and progress bar
-    update_timer_label(pomodoro_get_remaining_sec() * 1000);
-
-    if (state == POMODORO_IDLE) {
-        lv_obj_set_style_text_color(label_timer, lv_color_hex(0x4A90E2), 0);
-        lv_obj_set_style_arc_color(progress, lv_color_hex(0x4A90E2), LV_PART_INDICATOR);
+        lv_arc_set_value(progress, pomodoro_get_remaining_sec());
     }
 }
 
-static void pomodoro_state_changed(PomodoroState_e state)
+static void ui_state_observer_cb(lv_observer_t *observer, lv_subject_t *subject)
 {
-    ui_main_screen_update_mode_icon(state);
+    PomodoroState_e state = lv_subject_get_int(subject);
+
     ui_update_ctrl_button(state);
     #if 0
     ui_update_state_text(state);
     #endif
 
-    update_timer_and_progress(state);
-    ui_update_cycle_counter();
+    ui_update_progress_range();
+
+    // The overlay only shows a running work session
+    if (state != POMODORO_WORK && fullscreen_timer_active) {
+        hide_fullscreen_timer();
+        fullscreen_timer_active = false;
+    }
 
-    work_state_elapsed_sec = 0;
+    // Count the fullscreen delay from the start (or resume) of a work session
+    timer_stop(fullscreen_delay);
+    fullscreen_delay = TIMER_ID_NONE;
+    if (state == POMODORO_WORK && fullscreen_enable) {
+        fullscreen_delay = timer_start(POMO_MOVE_TO_FULLSCREEN_SEC * 1000, NULL, fullscreen_delay_cb);
+    }
 }
 
 static void start_event_cb(lv_event_t *e)
@@ -573,79 +631,83 @@ static void start_event_cb(lv_event_t *e)
         case POMODORO_WORK:
         case POMODORO_SHORT_BREAK:
         case POMODORO_LONG_BREAK:
-            timer_pause();
             event_dispatch(EVENT_PAUSE, NULL);
             break;
             
         case POMODORO_PAUSED_WORK:
         case POMODORO_PAUSED_BREAK:
-            timer_resume();
             event_dispatch(EVENT_RESUME, NULL);
             break;
     }
+
+    timer_reschedule();
 }
 
 static void reset_event_cb(lv_event_t *e)
 {
     event_dispatch(EVENT_RESET, NULL);
-    timer_stop();
-    pomodoro_state_changed(POMODORO_IDLE); // Force UI update
+    timer_reschedule();
 }
 
-static void ui_tick_cb(uint32_t remaining) {
-    update_timer_label(remaining);
-
-    PomodoroState_e state = pomodoro_get_state();
-    if (state == POMODORO_WORK) {
-        if (fullscreen_enable) {
-            work_state_elapsed_sec++;
-            if (!fullscreen_timer_active && work_state_elapsed_sec >= POMO_MOVE_TO_FULLSCREEN_SEC) {
-                // Show fullscreen overlay after 10 seconds
-                show_fullscreen_timer(main_cont);
-                fullscreen_timer_active = true;
-            }
-            if (fullscreen_timer_active) {
-                update_fullscreen_timer(remaining);
-            }
-        }
-
-        uint8_t percent = pomodoro_get_work_progress_in_percent();
-        if (percent > 50 && percent < 80) {
-            lv_obj_clear_flag(work_race_icon, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_set_style_text_color(label_timer, lv_color_hex(0x9B59B6), 0);
-            lv_obj_set_style_arc_color(progress, lv_color_hex(0x9B59B6), LV_PART_INDICATOR);
-        }
-        else if (percent >= 80) {
-            lv_obj_clear_flag(work_speed_icon, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_set_style_text_color(label_timer, lv_color_hex(0xE74C3C), 0);
-            lv_obj_set_style_arc_color(progress, lv_color_hex(0xE74C3C), LV_PART_INDICATOR);
-        }
-        else {
-            lv_obj_set_style_text_color(label_timer, lv_color_hex(0x4A90E2), 0);
-            lv_obj_set_style_arc_color(progress, lv_color_hex(0x4A90E2), LV_PART_INDICATOR);
-        }
-    }
-    else if (state == POMODORO_SHORT_BREAK || state == POMODORO_LONG_BREAK) {
-        lv_obj_set_style_text_color(label_timer, lv_color_hex(0x4A90E2), 0);
-        lv_obj_set_style_arc_color(progress, lv_color_hex(0x4A90E2), LV_PART_INDICATOR);
+#if UI_TICK_STATS
+static void ui_stats_invalidate_cb(lv_event_t *e)
+{
+    const lv_area_t *area = lv_event_get_param(e);
+
+    stat_areas++;
+    stat_px += lv_area_get_size(area);
+}
+
+/* The per-tick callback set the label and the arc every second, both
+ * colours in a running session and past half of a work session the race
+ * or speed icon again */
+static uint32_t ui_stats_old_writes(PomodoroState_e state)
+{
+    switch (state) {
+        case POMODORO_WORK:
+            return pomodoro_get_work_progress_in_percent() > 50 ? 5 : 4;
+        case POMODORO_SHORT_BREAK:
+        case POMODORO_LONG_BREAK:
+            return 4;
+        default:
+            return 2;
     }
-    else {
-        // Not in WORK state: reset elapsed time and hide overlay if shown
-        work_state_elapsed_sec = 0;
-        if (fullscreen_timer_active) {
-            hide_fullscreen_timer();
-            fullscreen_timer_active = false;
-        }
+}
+#endif
+
+// Show fullscreen overlay after POMO_MOVE_TO_FULLSCREEN_SEC of work
+static void fullscreen_delay_cb(void) {
+    fullscreen_delay = TIMER_ID_NONE;
+    if (pomodoro_get_state() == POMODORO_WORK && !fullscreen_timer_active) {
+        show_fullscreen_timer(main_cont);
+        fullscreen_timer_active = true;
     }
 }
 
 static void timer_tick_cb(lv_timer_t * timer) {
     timer_tick_handler();
+    timer_reschedule();
+}
+
+/* Run tick_timer exactly when the countdown has the next second to show,
+ * and not at all while it is stopped or paused */
+static void timer_reschedule(void)
+{
+    uint32_t deadline = timer_next_deadline();
+
+    if (deadline == TIMER_NO_DEADLINE) {
+        lv_timer_pause(tick_timer);
+        return;
+    }
+
+    lv_timer_set_period(tick_timer, deadline);
+    lv_timer_reset(tick_timer);
+    lv_timer_resume(tick_timer);
 }
 
 static void setting_event_cb(lv_event_t *e)
 {
     LV_LOG_USER("Moving to Settings page...\n");
-    show_settings_screen(main_cont);
+    ui_screen_show(UI_SCREEN_SETTINGS);
 
 }
\ No newline at end of file
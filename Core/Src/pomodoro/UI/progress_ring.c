@@ -0,0 +1,433 @@
+#include <stdint.h>
+#include "lvgl.h"
+#include "lvgl/src/lvgl_private.h"
+#include "progress_ring.h"
+
+/**
+ * @file progress_ring.c
+ * @brief Draw unit that draws the progress arc indicator from a cached ring.
+ *
+ * The software renderer sets up an angle mask and two radius masks and runs
+ * them over every row of the arc, each time the value changes. Here one
+ * quadrant of the ring is rasterized once per radius and width: the
+ * coverage and the angle of each of its pixels, the other quadrants are its
+ * mirror images. A redraw compares the angle of the ring pixels in the clip
+ * area with the ends of the arc and blends their coverage. lv_arc only
+ * invalidates the sector that changed, so once a second that is a few
+ * hundred pixels.
+ *
+ * The cut at each end is anti-aliased by the pixel's distance to it, the
+ * rounded ends use the same circle mask as the software renderer.
+ */
+
+#define DRAW_UNIT_ID_PROGRESS_RING  51
+
+// Angles in 1/65536 turn, 0 is 3 o'clock and they grow clockwise like LVGL's
+#define RING_TURN       65536
+#define RING_HALF       (RING_TURN / 2)
+#define RING_QUARTER    (RING_TURN / 4)
+
+typedef struct {
+    lv_obj_t *obj;
+    int32_t radius;         // geometry the tables are built for, 0: not built
+    int32_t width;
+    uint16_t *row_ofs;      // [radius + 1] first pixel of each quadrant row, one block with the rest
+    uint16_t *row_x;        // [radius] column of the first ring pixel of each row
+    uint16_t *angle;        // angle of each ring pixel, 0..RING_QUARTER in the quadrant
+    lv_opa_t *cover;        // coverage of each ring pixel
+    lv_opa_t *cap;          // [width * width] mask of a rounded end
+} ring_t;
+
+static ring_t rings[PROGRESS_RING_MAX];
+static lv_draw_unit_t *ring_unit = NULL;
+
+static int32_t evaluate_cb(lv_draw_unit_t *draw_unit, lv_draw_task_t *task);
+static int32_t dispatch_cb(lv_draw_unit_t *draw_unit, lv_layer_t *layer);
+static void ring_delete_cb(lv_event_t *e);
+static bool ring_build(ring_t *ring, int32_t radius, int32_t width);
+static void ring_release(ring_t *ring);
+static void ring_draw(lv_draw_task_t *t, const ring_t *ring, const lv_draw_arc_dsc_t *dsc);
+
+static ring_t *ring_find(const lv_obj_t *obj)
+{
+    if (!obj) return NULL;
+
+    for (uint32_t i = 0; i < PROGRESS_RING_MAX; i++) {
+        if (rings[i].obj == obj) return &rings[i];
+    }
+    return NULL;
+}
+
+bool progress_ring_attach(lv_obj_t *arc)
+{
+    ring_t *ring = ring_find(arc);
+
+    if (ring) return true;
+
+    for (uint32_t i = 0; i < PROGRESS_RING_MAX && !ring; i++) {
+        if (!rings[i].obj) ring = &rings[i];
+    }
+    if (!ring) return false;
+
+    if (!ring_unit) {
+        ring_unit = lv_draw_create_unit(sizeof(lv_draw_unit_t));
+        ring_unit->evaluate_cb = evaluate_cb;
+        ring_unit->dispatch_cb = dispatch_cb;
+        ring_unit->name = "PROGRESS_RING";
+    }
+
+    // The tables are built at the first draw, when the geometry is known
+    ring->obj = arc;
+    lv_obj_add_event_cb(arc, ring_delete_cb, LV_EVENT_DELETE, NULL);
+    return true;
+}
+
+void progress_ring_detach(lv_obj_t *arc)
+{
+    ring_t *ring = ring_find(arc);
+
+    if (!ring) return;
+
+    lv_obj_remove_event_cb(arc, ring_delete_cb);
+    ring_release(ring);
+}
+
+static void ring_delete_cb(lv_event_t *e)
+{
+    ring_t *ring = ring_find(lv_event_get_target(e));
+
+    if (ring) ring_release(ring);
+}
+
+static void ring_release(ring_t *ring)
+{
+    lv_free(ring->row_ofs);
+    lv_memzero(ring, sizeof(*ring));
+}
+
+/* Claim the indicator arcs of the attached widgets. The full ring of the
+ * background is left to the software renderer, it draws it as a border. */
+static int32_t evaluate_cb(lv_draw_unit_t *draw_unit, lv_draw_task_t *task)
+{
+    lv_draw_arc_dsc_t *dsc;
+    int32_t sweep;
+
+    LV_UNUSED(draw_unit);
+
+    if (task->type != LV_DRAW_TASK_TYPE_ARC) return 0;
+
+    dsc = task->draw_dsc;
+    if (!ring_find(dsc->base.obj) || dsc->base.part != LV_PART_INDICATOR) return 0;
+
+    sweep = (int32_t)dsc->end_angle - (int32_t)dsc->start_angle;
+    if (dsc->img_src || sweep == 360 || sweep == -360 || dsc->width > dsc->radius) return 0;
+
+    task->preferred_draw_unit_id = DRAW_UNIT_ID_PROGRESS_RING;
+    task->preference_score = 0;
+    return 0;
+}
+
+static int32_t dispatch_cb(lv_draw_unit_t *draw_unit, lv_layer_t *layer)
+{
+    lv_draw_task_t *t = NULL;
+    lv_draw_arc_dsc_t *dsc;
+    ring_t *ring;
+
+    // The tasks nobody claimed are also "available" for this unit, skip them
+    do {
+        t = lv_draw_get_next_available_task(layer, t, DRAW_UNIT_ID_PROGRESS_RING);
+    } while (t && t->preferred_draw_unit_id != DRAW_UNIT_ID_PROGRESS_RING);
+
+    if (t == NULL) return LV_DRAW_UNIT_IDLE;
+    if (lv_draw_layer_alloc_buf(layer) == NULL) return LV_DRAW_UNIT_IDLE;
+
+    t->state = LV_DRAW_TASK_STATE_IN_PROGRESS;
+    t->draw_unit = draw_unit;
+
+    dsc = t->draw_dsc;
+    ring = ring_find(dsc->base.obj);
+    if (ring && (ring->radius != dsc->radius || ring->width != dsc->width)) {
+        lv_obj_t *obj = ring->obj;
+
+        ring_release(ring);
+        ring->obj = obj;
+        ring_build(ring, dsc->radius, dsc->width);
+    }
+
+    if (ring && ring->radius) {
+        ring_draw(t, ring, dsc);
+    }
+    else {
+        // Detached meanwhile or out of memory for the tables
+        lv_draw_sw_arc(t, dsc, &t->area);
+    }
+
+    t->state = LV_DRAW_TASK_STATE_FINISHED;
+    lv_draw_dispatch_request();
+    return 1;
+}
+
+/* Angle of the quadrant pixel (i, j) from the centre, 0..RING_QUARTER.
+ * Only runs when the tables are built. */
+static uint16_t ring_quadrant_angle(int32_t i, int32_t j)
+{
+    float dx = i + 0.5f;
+    float dy = j + 0.5f;
+    bool steep = dy > dx;
+    float t = steep ? dx / dy : dy / dx;
+    float t2 = t * t;
+    // atan(t) for 0 <= t <= 1, error below 1e-5 rad
+    float a = t * (0.9998660f + t2 * (-0.3302995f + t2 * (0.1801410f + t2 * (-0.0851330f + t2 * 0.0208351f))));
+    int32_t v = (int32_t)(a * (RING_QUARTER / 1.5707963f) + 0.5f);
+
+    return steep ? RING_QUARTER - v : v;
+}
+
+/* Coverage of quadrant row j with the masks of the software renderer.
+ * Returns the first and the number of ring pixels. */
+static void ring_quadrant_row(void *masks[], lv_opa_t *line, int32_t radius, int32_t j,
+                              int32_t *first, int32_t *len)
+{
+    lv_draw_sw_mask_res_t res;
+    int32_t last;
+
+    lv_memset(line, 0xff, radius);
+    res = lv_draw_sw_mask_apply(masks, line, radius, radius + j, radius);
+    if (res == LV_DRAW_SW_MASK_RES_TRANSP) {
+        *first = 0;
+        *len = 0;
+        return;
+    }
+
+    for (*first = 0; *first < radius && line[*first] == 0; (*first)++);
+    for (last = radius - 1; last >= *first && line[last] == 0; last--);
+    *len = last - *first + 1;
+}
+
+static bool ring_build(ring_t *ring, int32_t radius, int32_t width)
+{
+    lv_area_t out = { 0, 0, 2 * radius - 1, 2 * radius - 1 };
+    lv_area_t in = { width, width, 2 * radius - 1 - width, 2 * radius - 1 - width };
+    lv_area_t cap_area = { 0, 0, width - 1, width - 1 };
+    lv_draw_sw_mask_radius_param_t mask_out, mask_in, mask_cap;
+    void *masks[3] = { &mask_out, NULL, NULL };
+    void *cap_masks[2] = { &mask_cap, NULL };
+    int32_t first, len, count = 0;
+    lv_opa_t *line;
+    uint8_t *block;
+
+    line = lv_malloc(radius);
+    if (!line) return false;
+
+    lv_draw_sw_mask_radius_init(&mask_out, &out, LV_RADIUS_CIRCLE, false);
+    if (in.x2 >= in.x1) {
+        lv_draw_sw_mask_radius_init(&mask_in, &in, LV_RADIUS_CIRCLE, true);
+        masks[1] = &mask_in;
+    }
+
+    for (int32_t j = 0; j < radius; j++) {
+        ring_quadrant_row(masks, line, radius, j, &first, &len);
+        count += len;
+    }
+
+    block = count <= UINT16_MAX ?
+            lv_malloc((2 * radius + 1) * sizeof(uint16_t) + count * (sizeof(uint16_t) + 1) + width * width) : NULL;
+    if (block) {
+        ring->row_ofs = (uint16_t *)block;
+        ring->row_x = ring->row_ofs + radius + 1;
+        ring->angle = ring->row_x + radius;
+        ring->cover = (lv_opa_t *)(ring->angle + count);
+        ring->cap = ring->cover + count;
+
+        count = 0;
+        for (int32_t j = 0; j < radius; j++) {
+            ring_quadrant_row(masks, line, radius, j, &first, &len);
+            ring->row_ofs[j] = count;
+            ring->row_x[j] = first;
+            for (int32_t i = first; i < first + len; i++, count++) {
+                ring->angle[count] = ring_quadrant_angle(i, j);
+                ring->cover[count] = line[i];
+            }
+        }
+        ring->row_ofs[radius] = count;
+
+        // The rounded end, as lv_draw_sw_arc() makes it
+        lv_memset(ring->cap, 0xff, width * width);
+        lv_draw_sw_mask_radius_init(&mask_cap, &cap_area, width / 2, false);
+        for (int32_t h = 0; h < width; h++) {
+            if (lv_draw_sw_mask_apply(cap_masks, ring->cap + h * width, 0, h, width) == LV_DRAW_SW_MASK_RES_TRANSP) {
+                lv_memzero(ring->cap + h * width, width);
+            }
+        }
+        lv_draw_sw_mask_free_param(&mask_cap);
+
+        ring->radius = radius;
+        ring->width = width;
+    }
+
+    lv_draw_sw_mask_free_param(&mask_out);
+    if (masks[1]) lv_draw_sw_mask_free_param(&mask_in);
+    lv_free(line);
+
+    return block != NULL;
+}
+
+/* Where lv_draw_sw_arc() puts a rounded end, relative to the centre */
+static void ring_cap_area(int32_t angle, int32_t radius, int32_t width, lv_area_t *area)
+{
+    int32_t half = width / 2;
+    int32_t corr = (width & 0x01) ? 0 : 1;
+    int32_t x = ((radius - half) * lv_trigo_cos(angle)) >> (LV_TRIGO_SHIFT - 8);
+    int32_t y = ((radius - half) * lv_trigo_sin(angle)) >> (LV_TRIGO_SHIFT - 8);
+
+    if (x > 0) {
+        x = (x - 128) >> 8;
+        area->x1 = x - half + corr;
+        area->x2 = x + half;
+    }
+    else {
+        x = (x + 128) >> 8;
+        area->x1 = x - half;
+        area->x2 = x + half - corr;
+    }
+
+    if (y > 0) {
+        y = (y - 128) >> 8;
+        area->y1 = y - half + corr;
+        area->y2 = y + half;
+    }
+    else {
+        y = (y + 128) >> 8;
+        area->y1 = y - half;
+        area->y2 = y + half - corr;
+    }
+}
+
+/* Coverage of a ring pixel inside the arc. edge_k is the opacity gained per
+ * 1/65536 turn away from an end, in 1/256 steps. */
+static inline lv_opa_t ring_opa(lv_opa_t cover, uint16_t angle, uint16_t start, uint16_t sweep, int32_t edge_k)
+{
+    uint16_t rel = angle - start;
+    int32_t dist;   // to the nearest end, negative outside of the arc
+    int32_t opa;
+
+    if (rel < sweep) dist = LV_MIN(rel, (uint16_t)(sweep - rel));
+    else dist = -(int32_t)LV_MIN((uint16_t)(rel - sweep), (uint16_t)(0 - rel));
+
+    opa = 128 + ((dist * edge_k) >> 8);
+    if (opa >= 255) return cover;
+    if (opa <= 0) return 0;
+    return (cover * opa) >> 8;
+}
+
+static void ring_add_cap(const ring_t *ring, const lv_area_t *cap, const lv_area_t *row, lv_opa_t *mask)
+{
+    lv_area_t common;
+
+    if (!lv_area_intersect(&common, cap, row)) return;
+
+    const lv_opa_t *src = ring->cap + ring->width * (common.y1 - cap->y1) + common.x1 - cap->x1;
+    lv_opa_t *dst = mask + common.x1 - row->x1;
+
+    for (int32_t x = 0; x < lv_area_get_width(&common); x++) {
+        uint32_t v = dst[x] + src[x];
+        dst[x] = v > 255 ? 255 : v;
+    }
+}
+
+static void ring_draw(lv_draw_task_t *t, const ring_t *ring, const lv_draw_arc_dsc_t *dsc)
+{
+    int32_t cx = dsc->center.x;
+    int32_t cy = dsc->center.y;
+    int32_t start_deg = (int32_t)dsc->start_angle;
+    int32_t end_deg = (int32_t)dsc->end_angle;
+    int32_t r_mid = ring->radius - ring->width / 2;
+    int32_t edge_k = (r_mid * 1608) >> 8;   // 2 * pi * r_mid * 256 / 256 px per 1/65536 turn
+    uint16_t start, sweep;
+    lv_area_t clip, row, caps[2];
+    lv_draw_sw_blend_dsc_t blend_dsc;
+    lv_opa_t *mask;
+
+    if (!lv_area_intersect(&clip, &t->area, &t->clip_area)) return;
+
+    while (start_deg >= 360) start_deg -= 360;
+    while (start_deg < 0) start_deg += 360;
+    while (end_deg >= 360) end_deg -= 360;
+    while (end_deg < 0) end_deg += 360;
+    start = (uint16_t)((start_deg * RING_TURN) / 360);
+    sweep = (uint16_t)((end_deg * RING_TURN) / 360 - start);
+
+    if (dsc->rounded) {
+        ring_cap_area(start_deg, ring->radius, ring->width, &caps[0]);
+        ring_cap_area(end_deg, ring->radius, ring->width, &caps[1]);
+        lv_area_move(&caps[0], cx, cy);
+        lv_area_move(&caps[1], cx, cy);
+    }
+
+    mask = lv_malloc(lv_area_get_width(&clip));
+    if (!mask) return;
+
+    lv_memzero(&blend_dsc, sizeof(blend_dsc));
+    blend_dsc.color = dsc->color;
+    blend_dsc.opa = dsc->opa;
+    blend_dsc.mask_buf = mask;
+    blend_dsc.mask_area = &row;
+    blend_dsc.blend_area = &row;
+
+    row = clip;
+    for (int32_t y = clip.y1; y <= clip.y2; y++) {
+        bool bottom = y >= cy;
+        int32_t j = bottom ? y - cy : cy - 1 - y;
+        bool any = false;
+
+        row.y1 = y;
+        row.y2 = y;
+        lv_memzero(mask, lv_area_get_width(&clip));
+
+        if (j < ring->radius) {
+            int32_t first = ring->row_x[j];
+            int32_t last = first + ring->row_ofs[j + 1] - ring->row_ofs[j] - 1;
+            const uint16_t *angle = ring->angle + ring->row_ofs[j] - first;
+            const lv_opa_t *cover = ring->cover + ring->row_ofs[j] - first;
+            int32_t lo, hi;
+
+            // Right half, x = cx + i
+            lo = LV_MAX(first, clip.x1 - cx);
+            hi = LV_MIN(last, clip.x2 - cx);
+            for (int32_t i = lo; i <= hi; i++) {
+                uint16_t a = bottom ? angle[i] : (uint16_t)(RING_TURN - angle[i]);
+                lv_opa_t opa = ring_opa(cover[i], a, start, sweep, edge_k);
+
+                mask[cx + i - clip.x1] = opa;
+                any |= opa != 0;
+            }
+
+            // Left half, x = cx - 1 - i
+            lo = LV_MAX(first, cx - 1 - clip.x2);
+            hi = LV_MIN(last, cx - 1 - clip.x1);
+            for (int32_t i = lo; i <= hi; i++) {
+                uint16_t a = bottom ? (uint16_t)(RING_HALF - angle[i]) : (uint16_t)(RING_HALF + angle[i]);
+                lv_opa_t opa = ring_opa(cover[i], a, start, sweep, edge_k);
+
+                mask[cx - 1 - i - clip.x1] = opa;
+                any |= opa != 0;
+            }
+        }
+
+        if (dsc->rounded) {
+            for (uint32_t c = 0; c < 2; c++) {
+                if (y >= caps[c].y1 && y <= caps[c].y2) {
+                    ring_add_cap(ring, &caps[c], &row, mask);
+                    any = true;
+                }
+            }
+        }
+
+        if (any) {
+            blend_dsc.mask_res = LV_DRAW_SW_MASK_RES_CHANGED;
+            lv_draw_sw_blend(t, &blend_dsc);
+        }
+    }
+
+    lv_free(mask);
+}
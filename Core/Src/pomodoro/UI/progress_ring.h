@@ -0,0 +1,27 @@
+#ifndef __H_PROGRESS_RING_H__
+#define __H_PROGRESS_RING_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl.h"
+
+// Arcs drawn by the ring renderer at the same time
+#define PROGRESS_RING_MAX       2
+
+/**
+ * @brief Draw the indicator of an arc from a cached ring instead of the
+ *        software arc masks. The ring is rasterized once for the arc's
+ *        radius and width, each redraw is then a lookup and a blend.
+ *        The arc is detached by itself when it is deleted.
+ * @param arc The arc widget
+ * @return false if all PROGRESS_RING_MAX slots are taken
+ */
+bool progress_ring_attach(lv_obj_t *arc);
+
+/**
+ * @brief Go back to the software arc and free the cached ring
+ * @param arc The arc widget
+ */
+void progress_ring_detach(lv_obj_t *arc);
+
+#endif /* __H_PROGRESS_RING_H__ */
@@ -0,0 +1,113 @@
+#include <stdio.h>
+#include "lvgl.h"
+#include "screen_manager.h"
+#include "main_screen.h"
+#include "settings_screen.h"
+
+/**
+ * @file screen_manager.c
+ * @brief Builds every screen once and switches between them.
+ *
+ * A screen keeps its widgets, styles, observers and timers for the whole
+ * run. Showing it again only loads it and refreshes what it shows, so
+ * going back and forth between the screens allocates nothing.
+ */
+
+typedef struct {
+    void (*create)(lv_obj_t *parent);   // build the widgets on the screen
+    void (*refresh)(void);              // bring the values up to date, may be NULL
+} ui_screen_desc_t;
+
+static const ui_screen_desc_t screen_desc[UI_SCREEN_COUNT] = {
+    // Bound to the pomodoro subjects, it is always up to date
+    [UI_SCREEN_MAIN]     = { ui_main_screen, NULL },
+    [UI_SCREEN_SETTINGS] = { ui_settings_screen, ui_settings_screen_refresh },
+};
+
+static lv_obj_t *screens[UI_SCREEN_COUNT];
+static bool default_used = false;
+
+void ui_screen_show(ui_screen_e id)
+{
+    if (id >= UI_SCREEN_COUNT) return;
+
+    if (!screens[id]) {
+        // The first screen takes over the display's empty default screen
+        if (!default_used) {
+            screens[id] = lv_screen_active();
+            default_used = true;
+        }
+        else {
+            screens[id] = lv_obj_create(NULL);
+        }
+        screen_desc[id].create(screens[id]);
+    }
+    else if (screen_desc[id].refresh) {
+        screen_desc[id].refresh();
+    }
+
+    if (lv_screen_active() != screens[id]) {
+        lv_screen_load(screens[id]);
+    }
+}
+
+lv_obj_t *ui_screen_get(ui_screen_e id)
+{
+    return id < UI_SCREEN_COUNT ? screens[id] : NULL;
+}
+
+#if UI_SCREEN_SOAK_TEST
+static uint32_t ui_timer_count(void)
+{
+    uint32_t count = 0;
+
+    for (lv_timer_t *t = lv_timer_get_next(NULL); t; t = lv_timer_get_next(t)) {
+        count++;
+    }
+    return count;
+}
+
+static size_t ui_heap_used(void)
+{
+    lv_mem_monitor_t mon;
+
+    lv_mem_monitor(&mon);
+    return mon.total_size - mon.free_size;
+}
+
+void ui_screen_soak(uint32_t rounds)
+{
+    ui_screen_e start = UI_SCREEN_MAIN;
+    size_t heap_before;
+    uint32_t timers_before;
+
+    for (ui_screen_e id = 0; id < UI_SCREEN_COUNT; id++) {
+        if (lv_screen_active() == screens[id]) start = id;
+    }
+
+    // One round first, so every screen is built and rendered once
+    for (ui_screen_e id = 0; id < UI_SCREEN_COUNT; id++) {
+        ui_screen_show(id);
+        lv_refr_now(NULL);
+    }
+    heap_before = ui_heap_used();
+    timers_before = ui_timer_count();
+
+    for (uint32_t i = 0; i < rounds; i++) {
+        for (ui_screen_e id = 0; id < UI_SCREEN_COUNT; id++) {
+            ui_screen_show(id);
+            lv_refr_now(NULL);
+        }
+    }
+
+    ui_screen_show(start);
+    lv_refr_now(NULL);
+
+    LV_LOG_USER("screen soak: %lu rounds, heap %lu -> %lu bytes, timers %lu -> %lu",
+                (unsigned long)rounds,
+                (unsigned long)heap_before, (unsigned long)ui_heap_used(),
+                (unsigned long)timers_before, (unsigned long)ui_timer_count());
+    LV_ASSERT_MSG(ui_heap_used() == heap_before, "screen switching leaks LVGL heap");
+    LV_ASSERT_MSG(ui_timer_count() == timers_before, "screen switching leaks LVGL timers");
+}
+#endif
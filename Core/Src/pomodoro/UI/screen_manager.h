@@ -0,0 +1,45 @@
+#ifndef __H_SCREEN_MANAGER_H__
+#define __H_SCREEN_MANAGER_H__
+
+#include <stdint.h>
+#include "lvgl.h"
+
+// 1: ui_screen_soak() is built, it checks that switching screens doesn't leak
+#ifndef UI_SCREEN_SOAK_TEST
+#define UI_SCREEN_SOAK_TEST     0
+#endif
+
+#ifndef UI_SCREEN_SOAK_ROUNDS
+#define UI_SCREEN_SOAK_ROUNDS   2000
+#endif
+
+typedef enum {
+    UI_SCREEN_MAIN,
+    UI_SCREEN_SETTINGS,
+    UI_SCREEN_COUNT
+} ui_screen_e;
+
+/**
+ * @brief Show a screen. It is built the first time, after that it is only
+ *        loaded and its values are refreshed in place.
+ * @param id Screen to show
+ */
+void ui_screen_show(ui_screen_e id);
+
+/**
+ * @brief Get the screen object
+ * @param id Screen
+ * @return The screen, NULL if it was never shown
+ */
+lv_obj_t *ui_screen_get(ui_screen_e id);
+
+#if UI_SCREEN_SOAK_TEST
+/**
+ * @brief Switch between all screens and check the LVGL heap and timer
+ *        count stay the same
+ * @param rounds Number of times every screen is shown
+ */
+void ui_screen_soak(uint32_t rounds);
+#endif
+
+#endif /* __H_SCREEN_MANAGER_H__ */
@@ -2,8 +2,12 @@
 #include <stdlib.h>
 #include "settings_screen.h"
 #include "event.h"
+#include "screen_manager.h"
 #include "lvgl.h"
 
+// Lowest value of every roller, its first option
+#define SETTING_ROLLER_MIN      1
+
 typedef struct {
     lv_obj_t *work_roller;
     lv_obj_t *short_roller;
@@ -19,6 +23,7 @@ static PomodoroSettings_t settings = {
 };
 
 static lv_obj_t *settings_screen;
+static rollers_t rollers;
 static lv_style_t setting_section_label_style;
 static lv_style_t setting_label_style;
 static lv_style_t setting_section_style;
@@ -83,7 +88,7 @@ lv_obj_t *setting_screen_create_roller(lv_obj_t *parent, int min, int max, int i
         unit[3] = '\0'; // Truncate to 3 characters
     }
     // Build options string
-    static char opts[150]; // Each "xx min\n" can be up to 7 chars, so 25*7=175 is safe.
+    static char opts[176]; // Each "xx min\n" can be up to 7 chars, so 25*7+1=176 is safe.
     char *p = opts;
     for (int i = min; i <= max; i++) {
         p += sprintf(p, "%d %s", i, unit);
@@ -155,19 +160,31 @@ static void setting_event_handler(lv_event_t *e)
     LV_LOG_USER("Settings saved. Returning to Main screen...\n");
     event_dispatch(EVENT_SETTINGS, &settings);
 
-    ui_main_screen(lv_scr_act());
+    ui_screen_show(UI_SCREEN_MAIN);
+}
 
-    if (settings_screen) {
-        lv_obj_del(settings_screen);
-        settings_screen = NULL;
+/* Select the saved value of a roller built by setting_screen_create_roller() */
+static void setting_screen_select(lv_obj_t *roller, int value)
+{
+    if (value < SETTING_ROLLER_MIN || value >= SETTING_ROLLER_MIN + (int)lv_roller_get_option_count(roller)) {
+        value = SETTING_ROLLER_MIN;
+    }
+    if (lv_roller_get_selected(roller) != (uint32_t)(value - SETTING_ROLLER_MIN)) {
+        lv_roller_set_selected(roller, value - SETTING_ROLLER_MIN, LV_ANIM_OFF);
     }
 }
 
-void show_settings_screen(lv_obj_t *parent)
+/* Shown again: drop the roller changes that were not saved */
+void ui_settings_screen_refresh(void)
 {
-    static rollers_t rollers;
-    static lv_obj_t *cycle_setting;
+    setting_screen_select(rollers.work_roller, settings.work_min);
+    setting_screen_select(rollers.short_roller, settings.short_break_min);
+    setting_screen_select(rollers.long_roller, settings.long_break_min);
+    setting_screen_select(rollers.cycle_roller, settings.cycles_before_long);
+}
 
+void ui_settings_screen(lv_obj_t *parent)
+{
     settings_screen = lv_obj_create(parent);
     ui_setting_screen_set_bg_by_theme(settings_screen);
 
@@ -181,7 +198,7 @@ void show_settings_screen(lv_obj_t *parent)
     lv_obj_t *work_label = lv_label_create(work_min_cont);
     lv_label_set_text(work_label, "Pomodoro");
     lv_obj_add_style(work_label, &setting_label_style, 0);
-    rollers.work_roller = setting_screen_create_roller(work_min_cont, 1, 25, settings.work_min, "min");
+    rollers.work_roller = setting_screen_create_roller(work_min_cont, SETTING_ROLLER_MIN, 25, settings.work_min, "min");
     lv_obj_set_flex_flow(work_min_cont, LV_FLEX_FLOW_COLUMN);
     lv_obj_set_flex_align(work_min_cont, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
     lv_obj_add_style(work_min_cont, &setting_cont_style, 0);
@@ -192,7 +209,7 @@ void show_settings_screen(lv_obj_t *parent)
     lv_obj_t *short_break_label = lv_label_create(short_break_cont);
     lv_label_set_text(short_break_label, "Short Break");
     lv_obj_add_style(short_break_label, &setting_label_style, 0);
-    rollers.short_roller = setting_screen_create_roller(short_break_cont, 1, 5, settings.short_break_min, "min");
+    rollers.short_roller = setting_screen_create_roller(short_break_cont, SETTING_ROLLER_MIN, 5, settings.short_break_min, "min");
     lv_obj_set_flex_flow(short_break_cont, LV_FLEX_FLOW_COLUMN);
     lv_obj_set_flex_align(short_break_cont, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
 
@@ -202,7 +219,7 @@ void show_settings_screen(lv_obj_t *parent)
     lv_obj_t *long_break_label = lv_label_create(long_break_cont);
     lv_label_set_text(long_break_label, "Long Break");
     lv_obj_add_style(long_break_label, &setting_label_style, 0);
-    rollers.long_roller = setting_screen_create_roller(long_break_cont, 1, 10, settings.long_break_min, "min");
+    rollers.long_roller = setting_screen_create_roller(long_break_cont, SETTING_ROLLER_MIN, 10, settings.long_break_min, "min");
     lv_obj_set_flex_flow(long_break_cont, LV_FLEX_FLOW_COLUMN);
     lv_obj_set_flex_align(long_break_cont, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
     
@@ -212,7 +229,7 @@ void show_settings_screen(lv_obj_t *parent)
     lv_obj_t *cycle_label = lv_label_create(cycle_cont);
     lv_label_set_text(cycle_label, "Cycles");
     lv_obj_add_style(cycle_label, &setting_label_style, 0);
-    rollers.cycle_roller = setting_screen_create_roller(cycle_cont, 1, 4, settings.cycles_before_long, "");
+    rollers.cycle_roller = setting_screen_create_roller(cycle_cont, SETTING_ROLLER_MIN, 4, settings.cycles_before_long, "");
     lv_obj_set_flex_flow(cycle_cont, LV_FLEX_FLOW_COLUMN);
     lv_obj_set_flex_align(cycle_cont, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
 
@@ -9,7 +9,8 @@ typedef enum {
 } pomodoro_theme_e;
 
 pomodoro_theme_e ui_get_theme(void);
-void show_settings_screen(lv_obj_t *parent);
+void ui_settings_screen(lv_obj_t *parent);
+void ui_settings_screen_refresh(void);
 int settings_get_work_time(void);
 int settings_get_short_break(void);
 int settings_get_long_break(void);
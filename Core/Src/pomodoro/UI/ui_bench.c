@@ -0,0 +1,344 @@
+#include <stdio.h>
+#include "lvgl.h"
+#include "lvgl/src/lvgl_private.h"
+#include "progress_ring.h"
+#include "ui_bench.h"
+
+/**
+ * @file ui_bench.c
+ * @brief Draw time of the UI assets, old form against the current one.
+ *
+ * Everything is drawn into an off-screen canvas, so the numbers are the
+ * software renderer alone, without the transfer to the display.
+ */
+
+#if UI_BENCH
+
+#ifdef SCREEN_SIZE_240x320
+#define BENCH_ICON_SCALE    179     // the zoom the icons were drawn with
+#else
+#define BENCH_ICON_SCALE    LV_SCALE_NONE
+#endif
+
+// Fits the 64 px icons, "00:00" in the 48 px countdown font and two 64 px
+// windows on the progress ring
+#define BENCH_CANVAS_W      160
+#define BENCH_CANVAS_H      64
+
+typedef struct {
+    lv_obj_t *screen;
+    lv_obj_t *canvas;
+    lv_draw_buf_t *buf;
+} bench_t;
+
+static bool bench_open(bench_t *b)
+{
+    b->buf = lv_draw_buf_create(BENCH_CANVAS_W, BENCH_CANVAS_H, LV_COLOR_FORMAT_RGB565, 0);
+    if (!b->buf) return false;
+
+    // Not loaded, only used as the parent of the canvas
+    b->screen = lv_obj_create(NULL);
+    b->canvas = lv_canvas_create(b->screen);
+    lv_canvas_set_draw_buf(b->canvas, b->buf);
+    lv_canvas_fill_bg(b->canvas, lv_color_hex(0x343247), LV_OPA_COVER);
+    return true;
+}
+
+static void bench_close(bench_t *b)
+{
+    lv_obj_delete(b->screen);
+    lv_draw_buf_destroy(b->buf);
+}
+
+/* Average time of one recoloured image draw in us */
+static uint32_t bench_image(bench_t *b, const lv_image_dsc_t *src, uint32_t scale)
+{
+    lv_draw_image_dsc_t dsc;
+    lv_area_t area = { 0, 0, src->header.w - 1, src->header.h - 1 };
+    lv_layer_t layer;
+    uint32_t start;
+
+    lv_draw_image_dsc_init(&dsc);
+    dsc.src = src;
+    dsc.scale_x = scale;
+    dsc.scale_y = scale;
+    dsc.pivot.x = src->header.w / 2;
+    dsc.pivot.y = src->header.h / 2;
+    dsc.recolor = lv_color_hex(0xBBBBBB);
+    dsc.recolor_opa = LV_OPA_COVER;
+
+    start = lv_tick_get();
+    for (uint32_t i = 0; i < UI_BENCH_ROUNDS; i++) {
+        lv_canvas_init_layer(b->canvas, &layer);
+        lv_draw_image(&layer, &dsc, &area);
+        lv_canvas_finish_layer(b->canvas, &layer);
+    }
+    return lv_tick_elaps(start) * 1000 / UI_BENCH_ROUNDS;
+}
+
+/* The mode icons were 64x64 ARGB8888 zoomed at draw time, now they are A8
+ * at their on-screen size. The old form is rebuilt in RAM from the A8
+ * source: its colour channels were all 0. */
+static void bench_icons(bench_t *b)
+{
+    LV_IMG_DECLARE(run);
+    LV_IMG_DECLARE(run_src);
+    uint32_t px = run_src.header.w * run_src.header.h;
+    uint8_t *argb = lv_malloc(px * 4);
+    lv_image_dsc_t old = run_src;
+    uint32_t t_old, t_new;
+
+    if (!argb) return;
+
+    for (uint32_t i = 0; i < px; i++) {
+        argb[i * 4 + 0] = 0;
+        argb[i * 4 + 1] = 0;
+        argb[i * 4 + 2] = 0;
+        argb[i * 4 + 3] = run_src.data[i];
+    }
+    old.header.cf = LV_COLOR_FORMAT_ARGB8888;
+    old.header.stride = run_src.header.w * 4;
+    old.data_size = px * 4;
+    old.data = argb;
+
+    t_old = bench_image(b, &old, BENCH_ICON_SCALE);
+    t_new = bench_image(b, &run, LV_SCALE_NONE);
+
+    LV_LOG_USER("icon: ARGB8888 %lux%lu scale %lu: %lu us, A8 %lux%lu: %lu us",
+                (unsigned long)old.header.w, (unsigned long)old.header.h,
+                (unsigned long)BENCH_ICON_SCALE, (unsigned long)t_old,
+                (unsigned long)run.header.w, (unsigned long)run.header.h,
+                (unsigned long)t_new);
+
+    lv_free(argb);
+}
+
+/* Average time of one countdown label draw in us. The last draw is left on
+ * a clean canvas, so two fonts can be compared pixel by pixel. */
+static uint32_t bench_label(bench_t *b, const lv_font_t *font, const char *text)
+{
+    lv_draw_label_dsc_t dsc;
+    lv_area_t area = { 0, 0, BENCH_CANVAS_W - 1, BENCH_CANVAS_H - 1 };
+    lv_layer_t layer;
+    uint32_t start, elapsed;
+
+    lv_draw_label_dsc_init(&dsc);
+    dsc.font = font;
+    dsc.text = text;
+    dsc.color = lv_color_hex(0x008080);
+
+    start = lv_tick_get();
+    for (uint32_t i = 0; i < UI_BENCH_ROUNDS; i++) {
+        lv_canvas_init_layer(b->canvas, &layer);
+        lv_draw_label(&layer, &dsc, &area);
+        lv_canvas_finish_layer(b->canvas, &layer);
+    }
+    elapsed = lv_tick_elaps(start);
+
+    lv_canvas_fill_bg(b->canvas, lv_color_hex(0x343247), LV_OPA_COVER);
+    lv_canvas_init_layer(b->canvas, &layer);
+    lv_draw_label(&layer, &dsc, &area);
+    lv_canvas_finish_layer(b->canvas, &layer);
+
+    return elapsed * 1000 / UI_BENCH_ROUNDS;
+}
+
+/* FNV-1a of the canvas, to compare two draws without a second buffer */
+static uint32_t bench_canvas_hash(bench_t *b)
+{
+    uint32_t hash = 2166136261u;
+
+    for (uint32_t i = 0; i < b->buf->data_size; i++) {
+        hash = (hash ^ b->buf->data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/* The countdown fonts are digit-only A8 subsets of Montserrat. The full
+ * 4 bpp fonts they replace are only there if they are enabled again in
+ * lv_conf.h, without them only the new draw time is logged. */
+static void bench_digit_font(bench_t *b, const lv_font_t *font, const lv_font_t *full, uint32_t size)
+{
+    static const char text[] = "08:47";
+    uint32_t t_full, t_new, diff;
+
+    t_new = bench_label(b, font, text);
+    if (!full) {
+        LV_LOG_USER("digits %lu px: A8 subset: %lu us", (unsigned long)size, (unsigned long)t_new);
+        return;
+    }
+
+    diff = bench_canvas_hash(b);
+    t_full = bench_label(b, full, text);
+    diff ^= bench_canvas_hash(b);
+
+    LV_LOG_USER("digits %lu px: Montserrat 4 bpp: %lu us, A8 subset: %lu us, pixels %s",
+                (unsigned long)size, (unsigned long)t_full, (unsigned long)t_new,
+                diff == 0 ? "identical" : "DIFFER");
+}
+
+static void bench_digits(bench_t *b)
+{
+    LV_FONT_DECLARE(font_timer_28);
+    LV_FONT_DECLARE(font_timer_48);
+
+#if LV_FONT_MONTSERRAT_28
+    bench_digit_font(b, &font_timer_28, &lv_font_montserrat_28, 28);
+#else
+    bench_digit_font(b, &font_timer_28, NULL, 28);
+#endif
+#if LV_FONT_MONTSERRAT_48
+    bench_digit_font(b, &font_timer_48, &lv_font_montserrat_48, 48);
+#else
+    bench_digit_font(b, &font_timer_48, NULL, 48);
+#endif
+}
+
+// Window on the ring around its end, stock draw left, cached ring right
+#define BENCH_RING_WIN      64
+#define BENCH_RING_OFS      80
+#define BENCH_RING_WIDTH    10
+#define BENCH_RING_START    200
+#define BENCH_RING_END      315
+
+/* Average time of one arc draw in us, clipped to clip. With obj set the
+ * arc is an indicator of it, so an attached arc takes the cached ring. */
+static uint32_t bench_arc(bench_t *b, lv_draw_arc_dsc_t *dsc, const lv_area_t *clip, uint32_t rounds,
+                          lv_obj_t *detach)
+{
+    lv_layer_t layer;
+    uint32_t start;
+
+    start = lv_tick_get();
+    for (uint32_t i = 0; i < rounds; i++) {
+        if (detach) {
+            progress_ring_detach(detach);
+            progress_ring_attach(detach);
+        }
+        lv_canvas_init_layer(b->canvas, &layer);
+        layer._clip_area = *clip;
+        lv_draw_arc(&layer, dsc);
+        lv_canvas_finish_layer(b->canvas, &layer);
+    }
+    return lv_tick_elaps(start) * 1000 / rounds;
+}
+
+/* Largest difference of a colour channel between the two windows, 0..255 */
+static uint32_t bench_ring_diff(bench_t *b, uint32_t *count)
+{
+    uint32_t max = 0;
+
+    *count = 0;
+    for (uint32_t y = 0; y < BENCH_RING_WIN; y++) {
+        const uint16_t *px = (const uint16_t *)(b->buf->data + y * b->buf->header.stride);
+
+        for (uint32_t x = 0; x < BENCH_RING_WIN; x++) {
+            uint16_t c1 = px[x];
+            uint16_t c2 = px[x + BENCH_RING_OFS];
+            int32_t d[3] = {
+                ((c1 >> 11) - (c2 >> 11)) * 255 / 31,
+                (((c1 >> 5) & 0x3F) - ((c2 >> 5) & 0x3F)) * 255 / 63,
+                ((c1 & 0x1F) - (c2 & 0x1F)) * 255 / 31,
+            };
+
+            if (c1 != c2) (*count)++;
+            for (uint32_t i = 0; i < 3; i++) {
+                uint32_t v = LV_ABS(d[i]);
+                if (v > max) max = v;
+            }
+        }
+    }
+    return max;
+}
+
+/* The progress indicator drawn by the software arc against the cached ring,
+ * at the size of the arc on both screen sizes. "window" redraws a 64 px
+ * square around the end of the arc, "tick" only the area a 1 degree step
+ * invalidates, like the countdown does once a second. */
+static void bench_ring_size(bench_t *b, lv_obj_t *arc, int32_t size)
+{
+    int32_t radius = size / 2;
+    int32_t r_mid = radius - BENCH_RING_WIDTH / 2;
+    // The end of the arc (315 degrees, top right) in the middle of the window
+    int32_t cx = BENCH_RING_WIN / 2 - r_mid * 181 / 256;
+    int32_t cy = BENCH_RING_WIN / 2 + r_mid * 181 / 256;
+    lv_area_t win = { 0, 0, BENCH_RING_WIN - 1, BENCH_RING_WIN - 1 };
+    lv_area_t tick, win_r, tick_r;
+    lv_draw_arc_dsc_t dsc;
+    uint32_t t_stock, t_ring, t_stock_tick, t_ring_tick, t_build, diff, count;
+
+    lv_obj_set_size(arc, size, size);
+
+    lv_draw_arc_dsc_init(&dsc);
+    dsc.color = lv_color_hex(0x4A90E2);
+    dsc.width = BENCH_RING_WIDTH;
+    dsc.radius = radius;
+    dsc.start_angle = BENCH_RING_START;
+    dsc.end_angle = BENCH_RING_END;
+    dsc.rounded = 1;
+    dsc.base.part = LV_PART_INDICATOR;
+
+    lv_draw_arc_get_area(cx, cy, radius, BENCH_RING_END - 1, BENCH_RING_END, BENCH_RING_WIDTH, true, &tick);
+    lv_area_intersect(&tick, &tick, &win);
+    win_r = win;
+    tick_r = tick;
+    lv_area_move(&win_r, BENCH_RING_OFS, 0);
+    lv_area_move(&tick_r, BENCH_RING_OFS, 0);
+
+    lv_canvas_fill_bg(b->canvas, lv_color_hex(0x343247), LV_OPA_COVER);
+
+    dsc.base.obj = NULL;
+    dsc.center.x = cx;
+    dsc.center.y = cy;
+    t_stock_tick = bench_arc(b, &dsc, &tick, UI_BENCH_ROUNDS, NULL);
+    t_stock = bench_arc(b, &dsc, &win, UI_BENCH_ROUNDS, NULL);
+
+    dsc.base.obj = arc;
+    dsc.center.x = cx + BENCH_RING_OFS;
+    t_build = bench_arc(b, &dsc, &tick_r, UI_BENCH_ROUNDS / 10 + 1, arc);
+    t_ring_tick = bench_arc(b, &dsc, &tick_r, UI_BENCH_ROUNDS, NULL);
+    t_ring = bench_arc(b, &dsc, &win_r, UI_BENCH_ROUNDS, NULL);
+
+    diff = bench_ring_diff(b, &count);
+
+    LV_LOG_USER("ring %ld px w %d: window: arc %lu us, ring %lu us; tick %ldx%ld: arc %lu us, ring %lu us; "
+                "build+draw %lu us; %lu px differ, max %lu/255",
+                (long)size, BENCH_RING_WIDTH, (unsigned long)t_stock, (unsigned long)t_ring,
+                (long)lv_area_get_width(&tick), (long)lv_area_get_height(&tick),
+                (unsigned long)t_stock_tick, (unsigned long)t_ring_tick, (unsigned long)t_build,
+                (unsigned long)count, (unsigned long)diff);
+}
+
+static void bench_ring(bench_t *b)
+{
+    lv_obj_t *arc = lv_arc_create(b->screen);
+
+    if (!progress_ring_attach(arc)) {
+        LV_LOG_USER("ring: no free slot");
+        lv_obj_delete(arc);
+        return;
+    }
+
+    bench_ring_size(b, arc, 130);
+    bench_ring_size(b, arc, 200);
+
+    lv_obj_delete(arc);
+}
+
+void ui_bench_run(void)
+{
+    bench_t b;
+
+    if (!bench_open(&b)) {
+        LV_LOG_USER("bench: no memory for the canvas");
+        return;
+    }
+
+    bench_icons(&b);
+    bench_digits(&b);
+    bench_ring(&b);
+
+    bench_close(&b);
+}
+
+#endif /* UI_BENCH */
@@ -0,0 +1,19 @@
+#ifndef __H_UI_BENCH_H__
+#define __H_UI_BENCH_H__
+
+#include <stdint.h>
+#include "lvgl.h"
+
+// 1: ui_bench_run() is built, it times the drawing of the UI assets
+#define UI_BENCH                0
+#define UI_BENCH_ROUNDS         200
+
+#if UI_BENCH
+/**
+ * @brief Time the asset draws off screen and log the results. Call it once
+ *        after the screens were built, it blocks for a few seconds.
+ */
+void ui_bench_run(void);
+#endif
+
+#endif /* __H_UI_BENCH_H__ */
@@ -0,0 +1,243 @@
+#!/usr/bin/env python3
+"""Generate the countdown fonts as digit-only subsets of LVGL's Montserrat.
+
+The countdown only ever shows "mm:ss", so the full built-in fonts (ASCII and
+the symbols) are cut down to the glyphs in CHARS. The glyphs are taken from
+lvgl/src/font/lv_font_montserrat_<size>.c, so they look the same as before.
+
+With bpp 8 the glyphs are stored as plain A8 and the font is flagged as a
+static bitmap: the software renderer blends them straight from flash
+instead of unpacking every glyph into a buffer on each redraw.
+
+    python3 font_subset.py      # rewrites the font .c files next to it
+
+Needs nothing but the Python standard library.
+"""
+
+import os
+import re
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+LVGL_FONTS = os.path.join(HERE, "..", "..", "..", "..", "lvgl", "src", "font")
+
+CHARS = "0123456789:"
+
+# Font name, Montserrat size, output bpp (4 like the source or 8 for A8)
+FONTS = [
+    ("font_timer_28", 28, 8),
+    ("font_timer_48", 48, 8),
+]
+
+
+def c_ints(text):
+    return [int(v, 0) for v in re.findall(r"-?0x[0-9a-fA-F]+|-?\d+", text)]
+
+
+def c_array(src, name):
+    m = re.search(name + r"\[\]\s*=\s*\{(.*?)\};", src, re.S)
+    if not m:
+        raise ValueError(f"{name}[] not found")
+    # Drop the /* U+0030 "0" */ comments, their digits are not data
+    return c_ints(re.sub(r"/\*.*?\*/", "", m.group(1), flags=re.S))
+
+
+def c_field(src, name):
+    m = re.search(r"\." + name + r"\s*=\s*(-?\d+)", src)
+    if not m:
+        raise ValueError(f".{name} not found")
+    return int(m.group(1))
+
+
+def read_font(size):
+    path = os.path.join(LVGL_FONTS, f"lv_font_montserrat_{size}.c")
+    src = open(path).read()
+    font = src[src.index("PUBLIC FONT"):]
+
+    if c_field(src, "bpp") != 4 or c_field(src, "bitmap_format") != 0:
+        raise ValueError(f"{path}: only plain bpp 4 fonts")
+
+    glyphs = []
+    dsc = re.search(r"glyph_dsc\[\]\s*=\s*\{(.*?)\n\};", src, re.S).group(1)
+    for m in re.finditer(r"\{\.bitmap_index = (\d+), \.adv_w = (\d+), \.box_w = (\d+), "
+                         r"\.box_h = (\d+), \.ofs_x = (-?\d+), \.ofs_y = (-?\d+)\}", dsc):
+        glyphs.append(dict(zip(("index", "adv_w", "box_w", "box_h", "ofs_x", "ofs_y"),
+                               map(int, m.groups()))))
+
+    # The ASCII range is the first cmap, a plain range from glyph id 1
+    cmap = re.search(r"\.range_start = (\d+), \.range_length = (\d+), \.glyph_id_start = (\d+)", src)
+    start, length, gid0 = map(int, cmap.groups())
+
+    return {
+        "path": path,
+        "bitmap": c_array(src, "glyph_bitmap"),
+        "glyphs": glyphs,
+        "cmap": (start, length, gid0),
+        "kern_left": c_array(src, "kern_left_class_mapping"),
+        "kern_right": c_array(src, "kern_right_class_mapping"),
+        "kern_values": c_array(src, "kern_class_values"),
+        "kern_right_cnt": c_field(src, "right_class_cnt"),
+        "kern_scale": c_field(src, "kern_scale"),
+        "line_height": c_field(font, "line_height"),
+        "base_line": c_field(font, "base_line"),
+        "underline_position": c_field(font, "underline_position"),
+        "underline_thickness": c_field(font, "underline_thickness"),
+    }
+
+
+def glyph_id(font, ch):
+    start, length, gid0 = font["cmap"]
+    if not start <= ord(ch) < start + length:
+        raise ValueError(f"{ch!r} is not in the ASCII range of the font")
+    return ord(ch) - start + gid0
+
+
+def glyph_alpha(font, g):
+    """The glyph as A8 values, the same ones LVGL unpacks at draw time"""
+    count = g["box_w"] * g["box_h"]
+    packed = font["bitmap"][g["index"]:g["index"] + (count + 1) // 2]
+    out = []
+    for i in range(count):
+        nibble = packed[i // 2] >> 4 if i % 2 == 0 else packed[i // 2] & 0xF
+        out.append(nibble * 17)  # opa4_table
+    return out
+
+
+def kern(font, left, right):
+    lc, rc = font["kern_left"][left], font["kern_right"][right]
+    if lc == 0 or rc == 0:
+        return 0
+    return font["kern_values"][(lc - 1) * font["kern_right_cnt"] + (rc - 1)]
+
+
+def pack4(alpha):
+    out = []
+    for i in range(0, len(alpha), 2):
+        hi = alpha[i] // 17
+        lo = alpha[i + 1] // 17 if i + 1 < len(alpha) else 0
+        out.append(hi << 4 | lo)
+    return out
+
+
+def generate(name, size, bpp):
+    font = read_font(size)
+    gids = [glyph_id(font, ch) for ch in CHARS]
+
+    if [ord(ch) for ch in CHARS] != list(range(ord(CHARS[0]), ord(CHARS[0]) + len(CHARS))):
+        raise ValueError("CHARS must be a continuous range")
+
+    bitmap_lines = []
+    dsc_lines = ["    {.bitmap_index = 0, .adv_w = 0, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0} /* id = 0 reserved */,"]
+    index = 0
+    for ch, gid in zip(CHARS, gids):
+        g = font["glyphs"][gid]
+        alpha = glyph_alpha(font, g)
+        data = alpha if bpp == 8 else pack4(alpha)
+        bitmap_lines.append(f"\n    /* U+{ord(ch):04X} \"{ch}\" */")
+        for i in range(0, len(data), 16):
+            bitmap_lines.append("    " + ", ".join(f"0x{v:02x}" for v in data[i:i + 16]) + ",")
+        dsc_lines.append(f"    {{.bitmap_index = {index}, .adv_w = {g['adv_w']}, .box_w = {g['box_w']}, "
+                         f".box_h = {g['box_h']}, .ofs_x = {g['ofs_x']}, .ofs_y = {g['ofs_y']}}},")
+        index += len(data)
+    dsc_lines[-1] = dsc_lines[-1].rstrip(",")
+
+    # Kerning of the subset as plain pairs, the new glyph ids start at 1
+    pairs = []
+    for li, lg in enumerate(gids):
+        for ri, rg in enumerate(gids):
+            value = kern(font, lg, rg)
+            if value:
+                pairs.append((li + 1, ri + 1, value))
+
+    out = [f"""/* Generated by font_subset.py from {os.path.basename(font['path'])}, do not edit.
+ * Size: {size} px, bpp: {bpp}, glyphs: "{CHARS}" */
+
+#ifdef __has_include
+    #if __has_include("lvgl.h")
+        #ifndef LV_LVGL_H_INCLUDE_SIMPLE
+            #define LV_LVGL_H_INCLUDE_SIMPLE
+        #endif
+    #endif
+#endif
+
+#if defined(LV_LVGL_H_INCLUDE_SIMPLE)
+    #include "lvgl.h"
+#else
+    #include "lvgl/lvgl.h"
+#endif
+
+/*Store the image of the glyphs*/
+static LV_ATTRIBUTE_LARGE_CONST const uint8_t glyph_bitmap[] = {{"""]
+    out += bitmap_lines
+    out.append("};")
+    out.append("")
+    out.append("static const lv_font_fmt_txt_glyph_dsc_t glyph_dsc[] = {")
+    out += dsc_lines
+    out.append("};")
+    out.append(f"""
+static const lv_font_fmt_txt_cmap_t cmaps[] = {{
+    {{
+        .range_start = {ord(CHARS[0])}, .range_length = {len(CHARS)}, .glyph_id_start = 1,
+        .unicode_list = NULL, .glyph_id_ofs_list = NULL, .list_length = 0, .type = LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY
+    }}
+}};
+""")
+    if pairs:
+        out.append("static const uint8_t kern_pair_glyph_ids[] = {")
+        out += [f"    {l}, {r}," for l, r, _ in pairs]
+        out.append("};")
+        out.append("")
+        out.append("static const int8_t kern_pair_values[] = {")
+        out.append("    " + ", ".join(str(v) for _, _, v in pairs))
+        out.append("};")
+        out.append(f"""
+static const lv_font_fmt_txt_kern_pair_t kern_pairs = {{
+    .glyph_ids = kern_pair_glyph_ids,
+    .values = kern_pair_values,
+    .pair_cnt = {len(pairs)},
+    .glyph_ids_size = 0
+}};
+""")
+    out.append(f"""static const lv_font_fmt_txt_dsc_t font_dsc = {{
+    .glyph_bitmap = glyph_bitmap,
+    .glyph_dsc = glyph_dsc,
+    .cmaps = cmaps,
+    .kern_dsc = {'&kern_pairs' if pairs else 'NULL'},
+    .kern_scale = {font['kern_scale'] if pairs else 0},
+    .cmap_num = 1,
+    .bpp = {bpp},
+    .kern_classes = 0,
+    .bitmap_format = 0,
+    .stride = {1 if bpp == 8 else 0},
+}};
+
+/* Same line height and baseline as the full font, the layout doesn't move */
+const lv_font_t {name} = {{
+    .get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt,
+    .get_glyph_bitmap = lv_font_get_bitmap_fmt_txt,
+    .line_height = {font['line_height']},
+    .base_line = {font['base_line']},
+    .subpx = LV_FONT_SUBPX_NONE,
+    .underline_position = {font['underline_position']},
+    .underline_thickness = {font['underline_thickness']},
+    .static_bitmap = {1 if bpp == 8 else 0},
+    .dsc = &font_dsc,
+    .fallback = NULL,
+    .user_data = NULL,
+}};
+""")
+    return "\n".join(out), index
+
+
+def main():
+    for name, size, bpp in FONTS:
+        path = os.path.join(HERE, name + ".c")
+        text, size_bytes = generate(name, size, bpp)
+        with open(path, "w", newline="\n") as f:
+            f.write(text)
+        print(f"{os.path.relpath(path)}: {size_bytes} bytes of glyphs")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
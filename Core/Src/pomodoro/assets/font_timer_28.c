@@ -0,0 +1,343 @@
+/* Generated by font_subset.py from lv_font_montserrat_28.c, do not edit.
+ * Size: 28 px, bpp: 8, glyphs: "0123456789:" */
+
+#ifdef __has_include
+    #if __has_include("lvgl.h")
+        #ifndef LV_LVGL_H_INCLUDE_SIMPLE
+            #define LV_LVGL_H_INCLUDE_SIMPLE
+        #endif
+    #endif
+#endif
+
+#if defined(LV_LVGL_H_INCLUDE_SIMPLE)
+    #include "lvgl.h"
+#else
+    #include "lvgl/lvgl.h"
+#endif
+
+/*Store the image of the glyphs*/
+static LV_ATTRIBUTE_LARGE_CONST const uint8_t glyph_bitmap[] = {
+
+    /* U+0030 "0" */
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x77, 0xcc, 0xff, 0xff, 0xee, 0xbb, 0x55, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x44, 0xee, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xbb, 0x11, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x44, 0xff, 0xff, 0xff, 0xdd, 0x99, 0x88, 0xaa, 0xff, 0xff, 0xff, 0xdd,
+    0x11, 0x00, 0x00, 0x00, 0x11, 0xee, 0xff, 0xff, 0x77, 0x00, 0x00, 0x00, 0x00, 0x11, 0xbb, 0xff,
+    0xff, 0xaa, 0x00, 0x00, 0x00, 0x88, 0xff, 0xff, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xdd, 0xff, 0xff, 0x33, 0x00, 0x00, 0xee, 0xff, 0xee, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x44, 0xff, 0xff, 0x99, 0x00, 0x33, 0xff, 0xff, 0x99, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xee, 0xff, 0xee, 0x00, 0x77, 0xff, 0xff, 0x55, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xbb, 0xff, 0xff, 0x11, 0x99, 0xff, 0xff, 0x33, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x88, 0xff, 0xff, 0x33, 0xaa, 0xff, 0xff, 0x22, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x77, 0xff, 0xff, 0x44, 0xaa, 0xff, 0xff, 0x22, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x77, 0xff, 0xff, 0x44, 0x99, 0xff, 0xff, 0x33, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x88, 0xff, 0xff, 0x33, 0x77, 0xff, 0xff, 0x55,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbb, 0xff, 0xff, 0x11, 0x33, 0xff, 0xff,
+    0x99, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xee, 0xff, 0xee, 0x00, 0x00, 0xee,
+    0xff, 0xee, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x44, 0xff, 0xff, 0x99, 0x00, 0x00,
+    0x88, 0xff, 0xff, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdd, 0xff, 0xff, 0x33, 0x00,
+    0x00, 0x11, 0xee, 0xff, 0xff, 0x77, 0x00, 0x00, 0x00, 0x00, 0x11, 0xbb, 0xff, 0xff, 0xaa, 0x00,
+    0x00, 0x00, 0x00, 0x44, 0xff, 0xff, 0xff, 0xdd, 0x99, 0x88, 0xaa, 0xff, 0xff, 0xff, 0xdd, 0x11,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x44, 0xee, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xcc, 0x11,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x77, 0xcc, 0xff, 0xff, 0xee, 0xbb, 0x55, 0x00,
+    0x00, 0x00, 0x00, 0x00,
+
+    /* U+0031 "1" */
+    0xcc, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x66, 0xcc, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x66,
+    0x55, 0x77, 0x77, 0x77, 0xaa, 0xff, 0xff, 0x66, 0x00, 0x00, 0x00, 0x00, 0x55, 0xff, 0xff, 0x66,
+    0x00, 0x00, 0x00, 0x00, 0x55, 0xff, 0xff, 0x66, 0x00, 0x00, 0x00, 0x00, 0x55, 0xff, 0xff, 0x66,
+    0x00, 0x00, 0x00, 0x00, 0x55, 0xff, 0xff, 0x66, 0x00, 0x00, 0x00, 0x00, 0x55, 0xff, 0xff, 0x66,
+    0x00, 0x00, 0x00, 0x00, 0x55, 0xff, 0xff, 0x66, 0x00, 0x00, 0x00, 0x00, 0x55, 0xff, 0xff, 0x66,
+    0x00, 0x00, 0x00, 0x00, 0x55, 0xff, 0xff, 0x66, 0x00, 0x00, 0x00, 0x00, 0x55, 0xff, 0xff, 0x66,
+    0x00, 0x00, 0x00, 0x00, 0x55, 0xff, 0xff, 0x66, 0x00, 0x00, 0x00, 0x00, 0x55, 0xff, 0xff, 0x66,
+    0x00, 0x00, 0x00, 0x00, 0x55, 0xff, 0xff, 0x66, 0x00, 0x00, 0x00, 0x00, 0x55, 0xff, 0xff, 0x66,
+    0x00, 0x00, 0x00, 0x00, 0x55, 0xff, 0xff, 0x66, 0x00, 0x00, 0x00, 0x00, 0x55, 0xff, 0xff, 0x66,
+    0x00, 0x00, 0x00, 0x00, 0x55, 0xff, 0xff, 0x66, 0x00, 0x00, 0x00, 0x00, 0x55, 0xff, 0xff, 0x66,
+
+    /* U+0032 "2" */
+    0x00, 0x00, 0x00, 0x33, 0x88, 0xcc, 0xee, 0xff, 0xff, 0xcc, 0x88, 0x22, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x22, 0xbb, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x66, 0x00, 0x00, 0x00,
+    0x22, 0xee, 0xff, 0xff, 0xff, 0xbb, 0x99, 0x88, 0xaa, 0xee, 0xff, 0xff, 0xff, 0x55, 0x00, 0x00,
+    0x22, 0xdd, 0xff, 0x99, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0x88, 0xff, 0xff, 0xee, 0x00, 0x00,
+    0x00, 0x11, 0x66, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xcc, 0xff, 0xff, 0x22, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x88, 0xff, 0xff, 0x44, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x99, 0xff, 0xff, 0x22, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xee, 0xff, 0xee, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x77, 0xff, 0xff, 0x99, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x44, 0xff, 0xff, 0xee, 0x11, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x33, 0xff, 0xff, 0xff, 0x44, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x44, 0xff, 0xff, 0xff, 0x44, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x44, 0xff, 0xff, 0xff, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x44, 0xff, 0xff, 0xff, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x44, 0xff, 0xff, 0xff, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x55, 0xff, 0xff, 0xff, 0x33, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x55, 0xff, 0xff, 0xff, 0x33, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x55, 0xff, 0xff, 0xff, 0xaa, 0x77, 0x77, 0x77, 0x77, 0x77, 0x77, 0x77, 0x77, 0x77, 0x00,
+    0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x22,
+    0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x22,
+
+    /* U+0033 "3" */
+    0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x66,
+    0x77, 0x77, 0x77, 0x77, 0x77, 0x77, 0x77, 0x77, 0xdd, 0xff, 0xff, 0x77, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x66, 0xff, 0xff, 0xaa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x33, 0xff, 0xff, 0xdd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x11, 0xee, 0xff, 0xff, 0x22, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xcc, 0xff, 0xff, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x99,
+    0xff, 0xff, 0x77, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55, 0xff, 0xff,
+    0xff, 0x99, 0x66, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x77, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0x77, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x33, 0x88, 0x88, 0xaa, 0xdd,
+    0xff, 0xff, 0xff, 0x99, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x44,
+    0xff, 0xff, 0xff, 0x33, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x66,
+    0xff, 0xff, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x11, 0xff,
+    0xff, 0xbb, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x11, 0xff, 0xff,
+    0xaa, 0x00, 0x55, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x66, 0xff, 0xff, 0x88,
+    0x33, 0xff, 0xcc, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55, 0xff, 0xff, 0xff, 0x22, 0xaa,
+    0xff, 0xff, 0xff, 0xee, 0xaa, 0x88, 0x88, 0x99, 0xdd, 0xff, 0xff, 0xff, 0x77, 0x00, 0x00, 0x99,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x77, 0x00, 0x00, 0x00, 0x00, 0x11,
+    0x66, 0xaa, 0xdd, 0xff, 0xff, 0xee, 0xcc, 0x77, 0x22, 0x00, 0x00, 0x00,
+
+    /* U+0034 "4" */
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x44, 0xff, 0xff, 0xbb, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x22, 0xee, 0xff, 0xee, 0x11, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xcc, 0xff, 0xff, 0x33,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x99, 0xff, 0xff,
+    0x77, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55, 0xff,
+    0xff, 0xaa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x22,
+    0xff, 0xff, 0xdd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xdd, 0xff, 0xff, 0x33, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xaa, 0xff, 0xff, 0x66, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x77, 0xff, 0xff, 0xaa, 0x00, 0x00, 0x00, 0x00, 0xaa, 0xbb, 0x77, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x33, 0xff, 0xff, 0xdd, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xaa,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x11, 0xee, 0xff, 0xff, 0x22, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff,
+    0xff, 0xaa, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbb, 0xff, 0xff, 0x55, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xff, 0xff, 0xaa, 0x00, 0x00, 0x00, 0x00, 0x88, 0xff, 0xff, 0xdd, 0x66, 0x66, 0x66, 0x66,
+    0x66, 0x66, 0x66, 0xff, 0xff, 0xcc, 0x66, 0x66, 0x66, 0x22, 0xee, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x66, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x66, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xaa, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xaa, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xaa,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff,
+    0xff, 0xaa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xff, 0xff, 0xaa, 0x00, 0x00, 0x00, 0x00,
+
+    /* U+0035 "5" */
+    0x00, 0x00, 0x11, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00,
+    0x00, 0x00, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00,
+    0x00, 0x00, 0x44, 0xff, 0xff, 0x99, 0x77, 0x77, 0x77, 0x77, 0x77, 0x77, 0x77, 0x77, 0x00, 0x00,
+    0x00, 0x00, 0x66, 0xff, 0xff, 0x33, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x88, 0xff, 0xff, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x99, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xbb, 0xff, 0xee, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xcc, 0xff, 0xdd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xee, 0xff, 0xff, 0xff, 0xff, 0xff, 0xee, 0xcc, 0x99, 0x44, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xcc, 0x22, 0x00, 0x00,
+    0x00, 0x00, 0x77, 0x77, 0x77, 0x77, 0x77, 0x77, 0x99, 0xcc, 0xff, 0xff, 0xff, 0xee, 0x11, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x22, 0xcc, 0xff, 0xff, 0x99, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x11, 0xff, 0xff, 0xee, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xcc, 0xff, 0xff, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xcc, 0xff, 0xff, 0x00,
+    0x00, 0x33, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x11, 0xff, 0xff, 0xdd, 0x00,
+    0x00, 0xdd, 0xee, 0x66, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x22, 0xcc, 0xff, 0xff, 0x77, 0x00,
+    0x55, 0xff, 0xff, 0xff, 0xff, 0xbb, 0x99, 0x88, 0x99, 0xbb, 0xff, 0xff, 0xff, 0xdd, 0x00, 0x00,
+    0x00, 0x55, 0xdd, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xbb, 0x11, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x44, 0x99, 0xcc, 0xee, 0xff, 0xee, 0xdd, 0x99, 0x44, 0x00, 0x00, 0x00, 0x00,
+
+    /* U+0036 "6" */
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x22, 0x88, 0xcc, 0xee, 0xff, 0xff, 0xdd, 0xaa, 0x44, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x11, 0xaa, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x44, 0x00,
+    0x00, 0x00, 0x11, 0xdd, 0xff, 0xff, 0xff, 0xbb, 0x88, 0x66, 0x88, 0x99, 0xee, 0xdd, 0x00, 0x00,
+    0x00, 0x00, 0xcc, 0xff, 0xff, 0xbb, 0x22, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x22, 0x00, 0x00,
+    0x00, 0x66, 0xff, 0xff, 0xbb, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xdd, 0xff, 0xff, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x22, 0xff, 0xff, 0xaa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x66, 0xff, 0xff, 0x66, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x88, 0xff, 0xff, 0x33, 0x00, 0x55, 0xaa, 0xee, 0xff, 0xee, 0xdd, 0x88, 0x22, 0x00, 0x00, 0x00,
+    0xaa, 0xff, 0xff, 0x33, 0xbb, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x77, 0x00, 0x00,
+    0xaa, 0xff, 0xff, 0xdd, 0xff, 0xff, 0x99, 0x55, 0x44, 0x66, 0xaa, 0xff, 0xff, 0xff, 0x66, 0x00,
+    0x99, 0xff, 0xff, 0xff, 0xdd, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0x44, 0xff, 0xff, 0xee, 0x00,
+    0x77, 0xff, 0xff, 0xff, 0x33, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x88, 0xff, 0xff, 0x55,
+    0x44, 0xff, 0xff, 0xee, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x44, 0xff, 0xff, 0x77,
+    0x11, 0xff, 0xff, 0xee, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x44, 0xff, 0xff, 0x66,
+    0x00, 0xaa, 0xff, 0xff, 0x33, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x88, 0xff, 0xff, 0x44,
+    0x00, 0x22, 0xff, 0xff, 0xdd, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0x44, 0xff, 0xff, 0xdd, 0x00,
+    0x00, 0x00, 0x77, 0xff, 0xff, 0xff, 0x99, 0x55, 0x44, 0x55, 0xaa, 0xff, 0xff, 0xff, 0x44, 0x00,
+    0x00, 0x00, 0x00, 0x66, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xee, 0x44, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x11, 0x77, 0xcc, 0xee, 0xff, 0xee, 0xcc, 0x77, 0x11, 0x00, 0x00, 0x00,
+
+    /* U+0037 "7" */
+    0x22, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xaa,
+    0x22, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x99,
+    0x22, 0xff, 0xff, 0xbb, 0x77, 0x77, 0x77, 0x77, 0x77, 0x77, 0x77, 0x77, 0xcc, 0xff, 0xff, 0x55,
+    0x22, 0xff, 0xff, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xee, 0x00,
+    0x22, 0xff, 0xff, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x66, 0xff, 0xff, 0x77, 0x00,
+    0x22, 0xff, 0xff, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdd, 0xff, 0xff, 0x11, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x44, 0xff, 0xff, 0x99, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xcc, 0xff, 0xff, 0x22, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x33, 0xff, 0xff, 0xbb, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xaa, 0xff, 0xff, 0x44, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x11, 0xff, 0xff, 0xdd, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x88, 0xff, 0xff, 0x66, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xee, 0xff, 0xee, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x66, 0xff, 0xff, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdd, 0xff, 0xff, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x44, 0xff, 0xff, 0xaa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbb, 0xff, 0xff, 0x33, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x22, 0xff, 0xff, 0xcc, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x99, 0xff, 0xff, 0x55, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x11, 0xff, 0xff, 0xee, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+
+    /* U+0038 "8" */
+    0x00, 0x00, 0x00, 0x00, 0x55, 0xaa, 0xdd, 0xff, 0xff, 0xdd, 0xaa, 0x66, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x33, 0xdd, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xdd, 0x33, 0x00, 0x00,
+    0x00, 0x22, 0xee, 0xff, 0xff, 0xdd, 0x77, 0x55, 0x55, 0x77, 0xdd, 0xff, 0xff, 0xff, 0x22, 0x00,
+    0x00, 0xaa, 0xff, 0xff, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x88, 0xff, 0xff, 0xaa, 0x00,
+    0x00, 0xee, 0xff, 0xee, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdd, 0xff, 0xff, 0x00,
+    0x00, 0xff, 0xff, 0xbb, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xaa, 0xff, 0xff, 0x00,
+    0x00, 0xff, 0xff, 0xdd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xcc, 0xff, 0xff, 0x00,
+    0x00, 0xaa, 0xff, 0xff, 0x55, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55, 0xff, 0xff, 0xaa, 0x00,
+    0x00, 0x11, 0xee, 0xff, 0xff, 0xaa, 0x44, 0x22, 0x22, 0x55, 0xaa, 0xff, 0xff, 0xee, 0x11, 0x00,
+    0x00, 0x00, 0x22, 0xcc, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xcc, 0x22, 0x00, 0x00,
+    0x00, 0x00, 0x88, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x88, 0x00, 0x00,
+    0x00, 0xbb, 0xff, 0xff, 0xcc, 0x55, 0x22, 0x00, 0x00, 0x22, 0x66, 0xdd, 0xff, 0xff, 0xbb, 0x00,
+    0x55, 0xff, 0xff, 0xbb, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xaa, 0xff, 0xff, 0x55,
+    0xaa, 0xff, 0xff, 0x22, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x22, 0xff, 0xff, 0xaa,
+    0xbb, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xcc,
+    0x99, 0xff, 0xff, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x44, 0xff, 0xff, 0xaa,
+    0x44, 0xff, 0xff, 0xdd, 0x22, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x22, 0xdd, 0xff, 0xff, 0x55,
+    0x00, 0xaa, 0xff, 0xff, 0xff, 0xaa, 0x66, 0x44, 0x55, 0x66, 0xaa, 0xff, 0xff, 0xff, 0xbb, 0x00,
+    0x00, 0x00, 0x99, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x99, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x22, 0x77, 0xcc, 0xee, 0xff, 0xff, 0xee, 0xcc, 0x77, 0x22, 0x00, 0x00, 0x00,
+
+    /* U+0039 "9" */
+    0x00, 0x00, 0x00, 0x00, 0x55, 0xbb, 0xee, 0xff, 0xee, 0xdd, 0x99, 0x33, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x22, 0xcc, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x99, 0x00, 0x00, 0x00,
+    0x00, 0x11, 0xdd, 0xff, 0xff, 0xcc, 0x66, 0x44, 0x55, 0x88, 0xdd, 0xff, 0xff, 0xaa, 0x00, 0x00,
+    0x00, 0x99, 0xff, 0xff, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xaa, 0xff, 0xff, 0x66, 0x00,
+    0x00, 0xff, 0xff, 0xdd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xee, 0xff, 0xee, 0x00,
+    0x22, 0xff, 0xff, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x99, 0xff, 0xff, 0x55,
+    0x22, 0xff, 0xff, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x99, 0xff, 0xff, 0x99,
+    0x00, 0xff, 0xff, 0xdd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xee, 0xff, 0xff, 0xcc,
+    0x00, 0xaa, 0xff, 0xff, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xaa, 0xff, 0xff, 0xff, 0xdd,
+    0x00, 0x22, 0xff, 0xff, 0xff, 0xdd, 0x77, 0x55, 0x55, 0x88, 0xdd, 0xff, 0xee, 0xee, 0xff, 0xee,
+    0x00, 0x00, 0x33, 0xee, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xee, 0x33, 0xee, 0xff, 0xee,
+    0x00, 0x00, 0x00, 0x00, 0x77, 0xcc, 0xee, 0xff, 0xee, 0xbb, 0x66, 0x00, 0x00, 0xff, 0xff, 0xdd,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x22, 0xff, 0xff, 0xaa,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x66, 0xff, 0xff, 0x77,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xcc, 0xff, 0xff, 0x11,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x77, 0xff, 0xff, 0xaa, 0x00,
+    0x00, 0x00, 0x11, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x88, 0xff, 0xff, 0xee, 0x11, 0x00,
+    0x00, 0x00, 0x88, 0xff, 0xaa, 0x88, 0x66, 0x77, 0xaa, 0xee, 0xff, 0xff, 0xff, 0x33, 0x00, 0x00,
+    0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xcc, 0x22, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x33, 0x99, 0xcc, 0xff, 0xff, 0xff, 0xdd, 0x99, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00,
+
+    /* U+003A ":" */
+    0x22, 0xdd, 0xee, 0x66, 0x00, 0xaa, 0xff, 0xff, 0xff, 0x00, 0x99, 0xff, 0xff, 0xee, 0x00, 0x11,
+    0xaa, 0xcc, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x11, 0xaa, 0xcc, 0x44, 0x00, 0x99, 0xff, 0xff, 0xee,
+    0x00, 0xaa, 0xff, 0xff, 0xff, 0x00, 0x22, 0xdd, 0xee, 0x66, 0x00,
+};
+
+static const lv_font_fmt_txt_glyph_dsc_t glyph_dsc[] = {
+    {.bitmap_index = 0, .adv_w = 0, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0} /* id = 0 reserved */,
+    {.bitmap_index = 0, .adv_w = 299, .box_w = 17, .box_h = 20, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 340, .adv_w = 166, .box_w = 8, .box_h = 20, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 500, .adv_w = 257, .box_w = 16, .box_h = 20, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 820, .adv_w = 256, .box_w = 15, .box_h = 20, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 1120, .adv_w = 300, .box_w = 18, .box_h = 20, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 1480, .adv_w = 257, .box_w = 16, .box_h = 20, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 1800, .adv_w = 276, .box_w = 16, .box_h = 20, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 2120, .adv_w = 268, .box_w = 16, .box_h = 20, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 2440, .adv_w = 289, .box_w = 16, .box_h = 20, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 2760, .adv_w = 276, .box_w = 16, .box_h = 20, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 3080, .adv_w = 102, .box_w = 5, .box_h = 15, .ofs_x = 1, .ofs_y = 0}
+};
+
+static const lv_font_fmt_txt_cmap_t cmaps[] = {
+    {
+        .range_start = 48, .range_length = 11, .glyph_id_start = 1,
+        .unicode_list = NULL, .glyph_id_ofs_list = NULL, .list_length = 0, .type = LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY
+    }
+};
+
+static const uint8_t kern_pair_glyph_ids[] = {
+    1, 2,
+    1, 3,
+    1, 4,
+    1, 8,
+    3, 1,
+    3, 5,
+    3, 7,
+    3, 8,
+    4, 3,
+    4, 4,
+    4, 6,
+    4, 8,
+    5, 2,
+    5, 3,
+    5, 4,
+    5, 6,
+    5, 8,
+    5, 9,
+    5, 10,
+    5, 11,
+    6, 3,
+    6, 4,
+    6, 6,
+    6, 8,
+    7, 8,
+    8, 1,
+    8, 2,
+    8, 4,
+    8, 5,
+    8, 6,
+    8, 7,
+    8, 9,
+    8, 11,
+    10, 2,
+    10, 3,
+    10, 4,
+    10, 8,
+    11, 8,
+};
+
+static const int8_t kern_pair_values[] = {
+    -1, -1, -4, -3, -1, -9, -1, -1, -2, -2, -4, -5, -11, -1, -5, -1, -21, 4, -3, 3, -2, -2, -2, -6, -3, -9, 4, -4, -29, -8, -9, -8, -9, -1, -1, -4, -3, 3
+};
+
+static const lv_font_fmt_txt_kern_pair_t kern_pairs = {
+    .glyph_ids = kern_pair_glyph_ids,
+    .values = kern_pair_values,
+    .pair_cnt = 38,
+    .glyph_ids_size = 0
+};
+
+static const lv_font_fmt_txt_dsc_t font_dsc = {
+    .glyph_bitmap = glyph_bitmap,
+    .glyph_dsc = glyph_dsc,
+    .cmaps = cmaps,
+    .kern_dsc = &kern_pairs,
+    .kern_scale = 16,
+    .cmap_num = 1,
+    .bpp = 8,
+    .kern_classes = 0,
+    .bitmap_format = 0,
+    .stride = 1,
+};
+
+/* Same line height and baseline as the full font, the layout doesn't move */
+const lv_font_t font_timer_28 = {
+    .get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt,
+    .get_glyph_bitmap = lv_font_get_bitmap_fmt_txt,
+    .line_height = 30,
+    .base_line = 5,
+    .subpx = LV_FONT_SUBPX_NONE,
+    .underline_position = -2,
+    .underline_thickness = 1,
+    .static_bitmap = 1,
+    .dsc = &font_dsc,
+    .fallback = NULL,
+    .user_data = NULL,
+};
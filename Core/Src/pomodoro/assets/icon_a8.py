@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+"""Generate the mode icons as alpha only (A8) LVGL images.
+
+The icons are always drawn fully recoloured, so only their alpha is kept.
+Each one is pre-scaled with an area average to the size it has on every
+SCREEN_SIZE_* build, so it is drawn as a plain recoloured alpha blend
+instead of going through the image transform.
+
+    python3 icon_a8.py          # rewrites the icon .c files next to it
+
+Needs nothing but the Python standard library.
+"""
+
+import os
+import struct
+import sys
+import zlib
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+# Descriptor name and source png, the png name without .png if not given
+ICONS = [
+    ("get_ready_64x64", None),
+    ("run", None),
+    ("race", None),
+    ("speed", None),
+    ("short_break", None),
+    ("long_break", None),
+]
+
+# Build macro and on-screen size. The first match wins, None is the default.
+# 45 px is the 64 px source at the old 0.7 zoom.
+SIZES = [
+    ("SCREEN_SIZE_240x320", 45),
+    (None, 64),
+]
+
+
+def read_png_alpha(path):
+    """Return (w, h, alpha rows) of an 8 bit RGBA or grey+alpha png"""
+    data = open(path, "rb").read()
+    if data[:8] != b"\x89PNG\r\n\x1a\n":
+        raise ValueError(f"{path}: not a png")
+
+    pos = 8
+    idat = b""
+    while pos < len(data):
+        length, kind = struct.unpack(">I4s", data[pos:pos + 8])
+        body = data[pos + 8:pos + 8 + length]
+        if kind == b"IHDR":
+            w, h, depth, ctype, _, _, interlace = struct.unpack(">IIBBBBB", body)
+        elif kind == b"IDAT":
+            idat += body
+        pos += 12 + length
+
+    channels = {6: 4, 4: 2}.get(ctype)
+    if depth != 8 or channels is None or interlace:
+        raise ValueError(f"{path}: only 8 bit non-interlaced RGBA or grey+alpha")
+
+    raw = zlib.decompress(idat)
+    stride = w * channels
+    rows = []
+    prev = bytearray(stride)
+    for y in range(h):
+        line = raw[y * (stride + 1):(y + 1) * (stride + 1)]
+        ftype, cur = line[0], bytearray(line[1:])
+        for i in range(stride):
+            a = cur[i - channels] if i >= channels else 0
+            b = prev[i]
+            c = prev[i - channels] if i >= channels else 0
+            if ftype == 1:
+                cur[i] = (cur[i] + a) & 0xFF
+            elif ftype == 2:
+                cur[i] = (cur[i] + b) & 0xFF
+            elif ftype == 3:
+                cur[i] = (cur[i] + ((a + b) >> 1)) & 0xFF
+            elif ftype == 4:
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                pred = a if pa <= pb and pa <= pc else (b if pb <= pc else c)
+                cur[i] = (cur[i] + pred) & 0xFF
+        rows.append([cur[x * channels + channels - 1] for x in range(w)])
+        prev = cur
+    return w, h, rows
+
+
+def scale(rows, w, h, size):
+    """Area average of the alpha to size x size"""
+    if (w, h) == (size, size):
+        return [list(r) for r in rows]
+
+    def spans(src, dst):
+        # Source pixels covered by each destination pixel, with their weight
+        out = []
+        for d in range(dst):
+            lo, hi = d * src / dst, (d + 1) * src / dst
+            cells = []
+            s = int(lo)
+            while s < hi:
+                cover = min(hi, s + 1) - max(lo, s)
+                if cover > 0:
+                    cells.append((s, cover))
+                s += 1
+            out.append(cells)
+        return out
+
+    xs, ys = spans(w, size), spans(h, size)
+    area = (w / size) * (h / size)
+    result = []
+    for ycells in ys:
+        line = []
+        for xcells in xs:
+            acc = 0.0
+            for sy, wy in ycells:
+                row = rows[sy]
+                for sx, wx in xcells:
+                    acc += row[sx] * wx * wy
+            line.append(min(255, int(acc / area + 0.5)))
+        result.append(line)
+    return result
+
+
+def c_array(name, rows, attr):
+    lines = [f"const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST {attr} uint8_t {name}[] = {{"]
+    for row in rows:
+        lines.append("  " + ", ".join(f"0x{v:02x}" for v in row) + ",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def c_dsc(name, size, data, static=False):
+    return "\n".join([
+        f"{'static ' if static else ''}const lv_image_dsc_t {name} = {{",
+        "  .header.cf = LV_COLOR_FORMAT_A8,",
+        "  .header.magic = LV_IMAGE_HEADER_MAGIC,",
+        f"  .header.w = {size},",
+        f"  .header.h = {size},",
+        f"  .header.stride = {size},",
+        f"  .data_size = {size} * {size},",
+        f"  .data = {data},",
+        "};",
+    ])
+
+
+def generate(name, png):
+    w, h, rows = read_png_alpha(os.path.join(HERE, "png", png + ".png"))
+    if w != h:
+        raise ValueError(f"{png}.png: icons must be square")
+    attr = "LV_ATTRIBUTE_IMAGE_" + name.upper()
+
+    out = [f"""/* Generated by icon_a8.py from png/{png}.png, do not edit.
+ * Alpha only, pre-scaled for each SCREEN_SIZE_* build. {name}_src keeps the
+ * {w}x{h} source for the icon benchmark, unused it is dropped at link time. */
+
+#ifdef __has_include
+    #if __has_include("lvgl.h")
+        #ifndef LV_LVGL_H_INCLUDE_SIMPLE
+            #define LV_LVGL_H_INCLUDE_SIMPLE
+        #endif
+    #endif
+#endif
+
+#if defined(LV_LVGL_H_INCLUDE_SIMPLE)
+    #include "lvgl.h"
+#else
+    #include "lvgl/lvgl.h"
+#endif
+
+
+#ifndef LV_ATTRIBUTE_MEM_ALIGN
+#define LV_ATTRIBUTE_MEM_ALIGN
+#endif
+
+#ifndef {attr}
+#define {attr}
+#endif
+""", c_array(f"{name}_src_map", rows, attr), ""]
+
+    first = True
+    for macro, size in SIZES:
+        if macro is None:
+            out.append("#else" if not first else "")
+        else:
+            out.append(f"#{'if' if first else 'elif'} defined({macro})")
+        if size == w:
+            out.append(c_dsc(name, size, f"{name}_src_map"))
+        else:
+            scaled = scale(rows, w, h, size)
+            out.append(c_array(f"{name}_map", scaled, attr).replace("const", "static const", 1))
+            out.append("")
+            out.append(c_dsc(name, size, f"{name}_map"))
+        first = False
+    out.append("#endif")
+    out.append("")
+    out.append(c_dsc(f"{name}_src", w, f"{name}_src_map"))
+    out.append("")
+    return "\n".join(out)
+
+
+def main():
+    for name, png in ICONS:
+        path = os.path.join(HERE, name + ".c")
+        with open(path, "w", newline="\n") as f:
+            f.write(generate(name, png or name))
+        print(f"{os.path.relpath(path)}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -23,11 +23,18 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "../lvgl/lvgl.h"
+#include "hw_def.h"
+#include "XPT2046.h"
+#include "idle.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
 /* USER CODE BEGIN TD */
 extern DMA_HandleTypeDef lcd_dma_handle;
+#if USE_TSC_PENIRQ
+extern DMA_HandleTypeDef tsc_dma_rx_handle;
+extern DMA_HandleTypeDef tsc_dma_tx_handle;
+#endif
 /* USER CODE END TD */
 
 /* Private define ------------------------------------------------------------*/
@@ -220,4 +227,58 @@ void USART2_IRQHandler(void)
   HAL_UART_IRQHandler(&huart2);
 }
 
+#if USE_LCD_TE_SYNC
+/**
+  * @brief This function handles EXTI line[15:10] interrupts (LCD TE).
+  */
+void EXTI15_10_IRQHandler(void)
+{
+  HAL_GPIO_EXTI_IRQHandler(LCD_TE_PIN);
+}
+#endif
+
+#if USE_TSC_PENIRQ
+/**
+  * @brief This function handles EXTI line[9:5] interrupts (touch PENIRQ).
+  */
+void EXTI9_5_IRQHandler(void)
+{
+  HAL_GPIO_EXTI_IRQHandler(TSC_PENIRQ_PIN);
+}
+
+/**
+  * @brief This function handles TIM7 global interrupt (touch sampling).
+  */
+void TIM7_IRQHandler(void)
+{
+  xpt2046_timer_irq_handler();
+  idle_notify();
+}
+
+/**
+  * @brief This function handles DMA2 stream0 global interrupt (touch SPI1 RX).
+  */
+void DMA2_Stream0_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&tsc_dma_rx_handle);
+  idle_notify();
+}
+
+/**
+  * @brief This function handles DMA2 stream3 global interrupt (touch SPI1 TX).
+  */
+void DMA2_Stream3_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&tsc_dma_tx_handle);
+}
+#endif
+
+/**
+  * @brief This function handles TIM2 global interrupt (idle wakeup).
+  */
+void TIM2_IRQHandler(void)
+{
+  idle_wake_irq_handler();
+}
+
 /* USER CODE END 1 */
@@ -2,9 +2,29 @@
 /* This will use HAL API in lcd_write_command()and lcd_write_data() */
 // #define USE_STM32_API 		1
 
-#define USE_DMA_FLUSH_LCD	    0
+#define USE_DMA_FLUSH_LCD	    1
 #if USE_DMA_FLUSH_LCD
 /* Should define 1 of these macro to select DMA API*/
     // #define USE_DMA_IN_POLLING_MODE 1
-    // #define USE_DMA_IN_IT_MODE      1
+    #define USE_DMA_IN_IT_MODE      1
 #endif // USE_DMA_FLUSH_LCD
+
+/* 1: drive CS/DCX (LCD) and the touch CS with a single BSRR store
+ * 0: go through HAL_GPIO_WritePin() */
+#define USE_LCD_GPIO_BSRR      1
+
+/* 1: lcd_pin_bench() is built, it times a CS write through both backends
+ *    with the DWT cycle counter */
+#define LCD_PIN_BENCH          0
+
+/* 1: start each frame after the panel's tearing effect pulse (needs the
+ *    TE pad wired to LCD_TE_PIN), 0: TE is not used */
+#define USE_LCD_TE_SYNC        0
+
+/* 1: a touch (PENIRQ falling edge) starts a timer driven sampler that queues
+ *    samples for xpt2046_read(), 0: xpt2046_read() polls the controller */
+#define USE_TSC_PENIRQ         1
+
+/* Size of each of the two draw buffers in bytes. They are allocated back to
+ * back, so a single render buffer may use both (see TFT_BUF_COUNT) */
+#define LCD_DRAW_BUF_SIZE      (10UL * 1024UL)
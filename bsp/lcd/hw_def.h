@@ -4,6 +4,7 @@
 #include "stm32f4xx_hal.h"
 #include "stm32f4xx_hal_spi.h"
 #include "stm32f4xx_hal_gpio.h"
+#include "config.h"
 
 #define LCD_SPI             SPI2
 
@@ -25,5 +26,39 @@
 #define LCD_DCX_PORT		GPIOD
 #define LCD_DCX_PIN			GPIO_PIN_9
 
+#define LCD_TE_PORT			GPIOD
+#define LCD_TE_PIN			GPIO_PIN_11
+#define LCD_TE_IRQn			EXTI15_10_IRQn
+
+/* XPT2046 touch controller on SPI1 */
+#define TSC_CS_PORT			GPIOA
+#define TSC_CS_PIN			GPIO_PIN_15
+
+#define TSC_PENIRQ_PORT		GPIOA
+#define TSC_PENIRQ_PIN		GPIO_PIN_8
+#define TSC_PENIRQ_IRQn		EXTI9_5_IRQn
+
+#define TSC_SAMPLE_TIM		TIM7		/* paces the samples while the pen is down */
+#define TSC_SAMPLE_TIM_IRQn	TIM7_IRQn
+
+#define TSC_DMA_RX_STREAM	DMA2_Stream0	/* SPI1_RX, channel 3 */
+#define TSC_DMA_RX_IRQn		DMA2_Stream0_IRQn
+#define TSC_DMA_TX_STREAM	DMA2_Stream3	/* SPI1_TX, channel 3 */
+#define TSC_DMA_TX_IRQn		DMA2_Stream3_IRQn
+
+/* Last flash sector (128 KB), kept out of FLASH in STM32F407VGTX_FLASH.ld */
+#define TSC_CAL_FLASH_ADDR	0x080E0000UL	/* touch calibration records */
+#define TSC_CAL_FLASH_SIZE	0x20000UL
+#define TSC_CAL_FLASH_SECTOR	FLASH_SECTOR_11
+
+/* Output pin helpers shared by the LCD and touch drivers.
+ * BSRR writes are atomic, so no read-modify-write and no function call. */
+#if USE_LCD_GPIO_BSRR
+#define LCD_GPIO_SET(port, pin)     ((port)->BSRR = (uint32_t)(pin))
+#define LCD_GPIO_RESET(port, pin)   ((port)->BSRR = ((uint32_t)(pin) << 16U))
+#else
+#define LCD_GPIO_SET(port, pin)     HAL_GPIO_WritePin(port, pin, GPIO_PIN_SET)
+#define LCD_GPIO_RESET(port, pin)   HAL_GPIO_WritePin(port, pin, GPIO_PIN_RESET)
+#endif
 
 #endif /* __HW_DEF_H__ */
\ No newline at end of file
@@ -11,6 +11,7 @@
 #include "lcd.h"
 #include "hw_def.h"
 #include "ili9341_reg.h"
+#include "mem_place.h"
 
 
 #define SET_SPI_16BIT_MODE(hspi) do { \
@@ -40,18 +41,54 @@ lcd_handle_t lcd_handle;
 lcd_handle_t *hlcd = &lcd_handle;
 
 
-#define LCD_CS_LOW()    HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_RESET)
-#define LCD_CS_HIGH()   HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_SET)
-#define LCD_RESX_LOW()  HAL_GPIO_WritePin(LCD_RESX_PORT, LCD_RESX_PIN, GPIO_PIN_RESET)
-#define LCD_RESX_HIGH() HAL_GPIO_WritePin(LCD_RESX_PORT, LCD_RESX_PIN, GPIO_PIN_SET)
-#define LCD_DCX_LOW()   HAL_GPIO_WritePin(LCD_DCX_PORT, LCD_DCX_PIN, GPIO_PIN_RESET)
-#define LCD_DCX_HIGH()  HAL_GPIO_WritePin(LCD_DCX_PORT, LCD_DCX_PIN, GPIO_PIN_SET)
+/* CS and DCX are toggled several times per window, count them for lcd_take_bus_stats() */
+#define LCD_CS_LOW()    do { LCD_GPIO_RESET(LCD_CS_PORT, LCD_CS_PIN); lcd_bus_stats.pin_writes++; } while(0)
+#define LCD_CS_HIGH()   do { LCD_GPIO_SET(LCD_CS_PORT, LCD_CS_PIN); lcd_bus_stats.pin_writes++; } while(0)
+#define LCD_RESX_LOW()  LCD_GPIO_RESET(LCD_RESX_PORT, LCD_RESX_PIN)
+#define LCD_RESX_HIGH() LCD_GPIO_SET(LCD_RESX_PORT, LCD_RESX_PIN)
+#define LCD_DCX_LOW()   do { LCD_GPIO_RESET(LCD_DCX_PORT, LCD_DCX_PIN); lcd_bus_stats.pin_writes++; } while(0)
+#define LCD_DCX_HIGH()  do { LCD_GPIO_SET(LCD_DCX_PORT, LCD_DCX_PIN); lcd_bus_stats.pin_writes++; } while(0)
 
 
 
-#define DB_SIZE 	(10UL * 1024UL)
-uint8_t db[DB_SIZE];
-uint8_t wb[DB_SIZE];
+#define DB_SIZE 	LCD_DRAW_BUF_SIZE
+/* wb follows db, a single LVGL buffer can span both. LVGL wants them 4-byte aligned */
+DMA_BUFFER uint8_t db[2UL * DB_SIZE] __attribute__((aligned(4)));
+uint8_t * const wb = &db[DB_SIZE];
+
+/* Current SPI2 frame size. Pixel and window writes keep the bus in 16-bit
+ * mode, only the byte oriented init/config commands switch back to 8-bit */
+static uint8_t lcd_spi_16bit = FALSE;
+
+/* Bytes put on the wire since the last lcd_take_bus_stats() */
+static lcd_bus_stats_t lcd_bus_stats;
+
+#if USE_DMA_FLUSH_LCD
+/* lcd_xfer.c chains the segments of a pixel transfer, these run them */
+static void lcd_dma_start_segment(const uint16_t *src, uint16_t words);
+static void lcd_dma_end(void);
+
+static const lcd_xfer_port_t lcd_dma_port = {
+	.start = lcd_dma_start_segment,
+	.end = lcd_dma_end,
+	.max_words = LCD_XFER_MAX_SEGMENT,
+};
+#endif
+
+#if LCD_ORIENTATION == PORTRAIT
+/* Hardware scroll area in panel rows (see lcd_scroll_set_area()) */
+static uint16_t lcd_scroll_top = 0;
+static uint16_t lcd_scroll_height = LCD_ACTIVE_HEIGHT;
+#endif
+
+#if USE_LCD_TE_SYNC
+static lcd_te_cb_t lcd_te_cb = NULL;
+#endif
+
+/* Source word of lcd_fill_rect_fast(). Read by the DMA, so it must stay in
+ * SRAM, and it is only rewritten once the previous transfer finished.
+ * Global so the linker scripts can check where it landed. */
+DMA_BUFFER uint16_t lcd_fill_color;
 
 static void lcd_pin_init(void);
 static void lcd_spi_init(void);
@@ -65,10 +102,14 @@ static void lcd_buffer_init(lcd_handle_t *lcd);
 static void lcd_set_orientation(uint8_t orientation);
 #if USE_DMA_FLUSH_LCD
 static void lcd_dma_init(void);
-static void lcd_write_dma(uint8_t *buffer, uint32_t length);
-#else
-void lcd_write(uint8_t *buffer, uint32_t length);
+static void lcd_write_dma(uint8_t *buffer, uint32_t length, lcd_xfer_done_cb_t done_cb);
+static void lcd_start_dma(uint16_t *src, uint32_t words, uint8_t mem_inc, lcd_xfer_done_cb_t done_cb);
+static void lcd_flush_done(void);
 #endif
+static void lcd_wait_idle(void);
+static void lcd_spi_set_16bit_mode(uint8_t enable);
+static void lcd_write_window(uint16_t x1, uint16_t x2, uint16_t y1, uint16_t y2, uint8_t gram_write);
+static void lcd_write_reg16(uint8_t cmd, const uint16_t *params, uint8_t count);
 
 /* Utils functions*/
 static uint32_t copy_to_draw_buffer(lcd_handle_t *hlcd,uint32_t nbytes,uint32_t rgb888);
@@ -223,6 +264,7 @@ static void lcd_dma_init(void)
     }
 
     __HAL_LINKDMA(&lcd_spi_handle, hdmatx, lcd_dma_handle);
+    lcd_xfer_set_port(&lcd_dma_port);
 
 }
 #endif // USE_DMA_FLUSH_LCD
@@ -230,11 +272,9 @@ static void lcd_dma_init(void)
 static void lcd_reset(void)
 {
     LCD_RESX_LOW();
-    HAL_Delay(50); // Wait for 50 ms
+    HAL_Delay(1); // RESX pulse only has to be > 10 us
     LCD_RESX_HIGH();
-    HAL_Delay(50); // Wait for 50 ms
-
-
+    HAL_Delay(5); // 5 ms until the controller accepts commands
 }
 
 
@@ -243,6 +283,9 @@ static void lcd_write_command(uint8_t cmd)
 #ifndef USE_STM32_API
 	SPI_TypeDef *pSPI = LCD_SPI;
 #endif
+    lcd_wait_idle(); // Never interleave a command with a pixel transfer
+    lcd_spi_set_16bit_mode(FALSE);
+    lcd_bus_stats.setup_bytes += 1;
     LCD_CS_LOW();
     LCD_DCX_LOW(); // Command mode
 	
@@ -268,6 +311,9 @@ static void lcd_write_data(uint8_t *buffer, uint32_t length)
 	SPI_TypeDef *pSPI = LCD_SPI;
 #endif
 
+    lcd_wait_idle();
+    lcd_spi_set_16bit_mode(FALSE);
+    lcd_bus_stats.setup_bytes += length;
     LCD_DCX_HIGH(); // Data mode
 	LCD_CS_LOW();
 	
@@ -286,133 +332,96 @@ static void lcd_write_data(uint8_t *buffer, uint32_t length)
     LCD_CS_HIGH();
 }
 
+/* ILI9341 power-up sequence, kept in flash and streamed by lcd_config().
+ * Each entry is: command, parameter count [| LCD_INIT_DELAY], parameters...,
+ * [delay in ms]. Delays are the datasheet minimums. */
+#define LCD_INIT_DELAY		0x80U
+#define LCD_INIT_NPARAMS	0x7FU
+
+static const uint8_t lcd_init_seq[] = {
+	ILI9341_SWRESET,		LCD_INIT_DELAY | 0, 5,		/* 5 ms before the next command */
+	ILI9341_POWERB,			3, 0x00, 0xD9, 0x30,
+	ILI9341_POWER_SEQ,		4, 0x64, 0x03, 0x12, 0x81,
+	ILI9341_DTCA,			3, 0x85, 0x10, 0x7A,
+	ILI9341_POWERA,			5, 0x39, 0x2C, 0x00, 0x34, 0x02,
+	ILI9341_PRC,			1, 0x20,
+	ILI9341_DTCB,			2, 0x00, 0x00,
+	ILI9341_POWER1,			1, 0x1B,
+	ILI9341_POWER2,			1, 0x12,
+	ILI9341_VCOM1,			2, 0x08, 0x26,
+	ILI9341_VCOM2,			1, 0xB7,
+	ILI9341_PIXEL_FORMAT,	1, 0x55,					/* RGB565 */
+	ILI9341_FRMCTR1,		2, 0x00, 0x1B,				/* frame rate = 70 */
+	ILI9341_DFC,			2, 0x0A, 0xA2,				/* Display Function Control */
+	ILI9341_3GAMMA_EN,		1, 0x02,					/* 3Gamma Function Disable */
+	ILI9341_GAMMA,			1, 0x01,
+	ILI9341_PGAMMA,			15, 0x0F, 0x1D, 0x1A, 0x0A, 0x0D, 0x07, 0x49, 0x66,
+							0x3B, 0x07, 0x11, 0x01, 0x09, 0x05, 0x04,
+	ILI9341_NGAMMA,			15, 0x00, 0x18, 0x1D, 0x02, 0x0F, 0x04, 0x36, 0x13,
+							0x4C, 0x07, 0x13, 0x0F, 0x2E, 0x2F, 0x05,
+	ILI9341_SLEEP_OUT,		LCD_INIT_DELAY | 0, 120,	/* Exit Sleep, supply settles in 120 ms */
+	ILI9341_DISPLAY_ON,		0,
+};
+
 static void lcd_config(void)
 {
-     uint8_t params[15];
-	lcd_write_command(ILI9341_SWRESET);
-	lcd_write_command(ILI9341_POWERB);
-	params[0] = 0x00;
-	params[1] = 0xD9;
-	params[2] = 0x30;
-	lcd_write_data(params, 3);
-
-	lcd_write_command(ILI9341_POWER_SEQ);
-	params[0]= 0x64;
-	params[1]= 0x03;
-	params[2]= 0X12;
-	params[3]= 0X81;
-	lcd_write_data(params, 4);
-
-	lcd_write_command(ILI9341_DTCA);
-	params[0]= 0x85;
-	params[1]= 0x10;
-	params[2]= 0x7A;
-	lcd_write_data(params, 3);
-
-	lcd_write_command(ILI9341_POWERA);
-	params[0]= 0x39;
-	params[1]= 0x2C;
-	params[2]= 0x00;
-	params[3]= 0x34;
-	params[4]= 0x02;
-	lcd_write_data(params, 5);
-
-	lcd_write_command(ILI9341_PRC);
-	params[0]= 0x20;
-	lcd_write_data(params, 1);
-
-	lcd_write_command(ILI9341_DTCB);
-	params[0]= 0x00;
-	params[1]= 0x00;
-	lcd_write_data(params, 2);
-
-	lcd_write_command(ILI9341_POWER1);
-	params[0]= 0x1B;
-	lcd_write_data(params, 1);
-
-	lcd_write_command(ILI9341_POWER2);
-	params[0]= 0x12;
-	lcd_write_data(params, 1);
-
-	lcd_write_command(ILI9341_VCOM1);
-	params[0]= 0x08;
-	params[1]= 0x26;
-	lcd_write_data(params, 2);
-
-	lcd_write_command(ILI9341_VCOM2);
-	params[0]= 0XB7;
-	lcd_write_data(params, 1);
-
-
-	lcd_write_command(ILI9341_PIXEL_FORMAT);
-	params[0]= 0x55; //select RGB565
-	lcd_write_data(params, 1);
-
-	lcd_write_command(ILI9341_FRMCTR1);
-	params[0]= 0x00;
-	params[1]= 0x1B;//frame rate = 70
-	lcd_write_data(params, 2);
-
-	lcd_write_command(ILI9341_DFC);    // Display Function Control
-	params[0]= 0x0A;
-	params[1]= 0xA2;
-	lcd_write_data(params, 2);
-
-	lcd_write_command(ILI9341_3GAMMA_EN);    // 3Gamma Function Disable
-	params[0]= 0x02; //LCD_WR_DATA(0x00);
-	lcd_write_data(params, 1);
-
-	lcd_write_command(ILI9341_GAMMA);
-	params[0]= 0x01;
-	lcd_write_data(params, 1);
-
-	lcd_write_command(ILI9341_PGAMMA);    //Set Gamma
-	params[0]= 0x0F;
-	params[1]= 0x1D;
-	params[2]= 0x1A;
-	params[3]= 0x0A;
-	params[4]= 0x0D;
-	params[5]= 0x07;
-	params[6]= 0x49;
-	params[7]= 0X66;
-	params[8]= 0x3B;
-	params[9]= 0x07;
-	params[10]= 0x11;
-	params[11]= 0x01;
-	params[12]= 0x09;
-	params[13]= 0x05;
-	params[14]= 0x04;
-	lcd_write_data(params, 15);
-
-	lcd_write_command(ILI9341_NGAMMA);
-	params[0]= 0x00;
-	params[1]= 0x18;
-	params[2]= 0x1D;
-	params[3]= 0x02;
-	params[4]= 0x0F;
-	params[5]= 0x04;
-	params[6]= 0x36;
-	params[7]= 0x13;
-	params[8]= 0x4C;
-	params[9]= 0x07;
-	params[10]= 0x13;
-	params[11]= 0x0F;
-	params[12]= 0x2E;
-	params[13]= 0x2F;
-	params[14]= 0x05;
-	lcd_write_data(params, 15);
-
-	lcd_write_command(ILI9341_SLEEP_OUT); //Exit Sleep
-	HAL_Delay(50); // Wait for 50 ms
-	HAL_Delay(50); // Wait for 50 ms
-	lcd_write_command(ILI9341_DISPLAY_ON); //display on
+	const uint8_t *p = lcd_init_seq;
+	const uint8_t *end = lcd_init_seq + sizeof(lcd_init_seq);
+
+	while(p < end){
+		uint8_t cmd = *p++;
+		uint8_t nparams = *p & LCD_INIT_NPARAMS;
+		uint8_t has_delay = *p & LCD_INIT_DELAY;
+		p++;
+
+		lcd_write_command(cmd);
+		if(nparams){
+			lcd_write_data((uint8_t *)p, nparams);
+			p += nparams;
+		}
+		if(has_delay){
+			HAL_Delay(*p++);
+		}
+	}
 }
 
 
 
 void lcd_set_background_color(uint32_t rgb888)
 {
-    lcd_fill_rect(rgb888, 0, (LCD_ACTIVE_WIDTH), 0, (LCD_ACTIVE_HEIGHT));
+    lcd_fill_rect_fast(rgb888, 0, (LCD_ACTIVE_WIDTH), 0, (LCD_ACTIVE_HEIGHT));
+}
+
+/* Solid fill without a draw buffer: the color is converted once and the same
+ * 16-bit word is streamed into the window (DMA memory increment disabled).
+ * Returns as soon as the transfer is started in DMA IT mode. */
+void lcd_fill_rect_fast(uint32_t rgb888, uint32_t x_start, uint32_t x_width, uint32_t y_start, uint32_t y_height)
+{
+	uint32_t npixels = x_width * y_height;
+
+	if((x_start+x_width) > LCD_ACTIVE_WIDTH) return;
+	if((y_start+y_height) > LCD_ACTIVE_HEIGHT) return;
+	if(npixels == 0) return;
+
+	/* Waits for any running transfer, so lcd_fill_color is free afterwards */
+	lcd_set_gram_window(x_start, x_start + x_width - 1, y_start, y_start + y_height - 1);
+	lcd_fill_color = convert_rgb888_to_rgb565(rgb888);
+
+#if USE_DMA_FLUSH_LCD
+	lcd_start_dma(&lcd_fill_color, npixels, FALSE, NULL);
+#else
+	SPI_TypeDef *pSPI = LCD_SPI;
+
+	lcd_bus_stats.payload_bytes += pixels_to_bytes(npixels, hlcd->pixel_format);
+	LCD_CS_LOW();
+	for(uint32_t i = 0; i < npixels; i++) {
+		while(!(pSPI->SR & SPI_SR_TXE));
+		pSPI->DR = lcd_fill_color;
+	}
+	while(!(pSPI->SR & SPI_SR_TXE));
+	while(pSPI->SR & SPI_SR_BSY);
+	LCD_CS_HIGH();
+#endif
 }
 
 void lcd_fill_rect(uint32_t rgb888, uint32_t x_start, uint32_t x_width, uint32_t y_start,uint32_t y_height)
@@ -470,25 +479,237 @@ void lcd_set_orientation(uint8_t orientation)
 
 void lcd_set_display_area(uint16_t x1, uint16_t x2, uint16_t y1, uint16_t y2)
 {
-	uint8_t params[4];
-	//Set the column address
-	params[0] = HIGH_16(x1);
-	params[1] = LOW_16(x1);
-	params[2] = HIGH_16(x2);
-	params[3] = LOW_16(x2);
-	lcd_write_command(ILI9341_CASET);
-	lcd_write_data(params, 4);
-
-	//Set the row address
-	params[0] = HIGH_16(y1);
-	params[1] = LOW_16(y1);
-	params[2] = HIGH_16(y2);
-	params[3] = LOW_16(y2);
-	lcd_write_command(ILI9341_RASET);
-	lcd_write_data(params, 4);
-	
+	lcd_write_window(x1, x2, y1, y2, FALSE);
+}
+
+/* CASET + RASET + RAMWR in one go, the next lcd_write*() lands in the window */
+void lcd_set_gram_window(uint16_t x1, uint16_t x2, uint16_t y1, uint16_t y2)
+{
+	lcd_write_window(x1, x2, y1, y2, TRUE);
+}
+
+/* Rows [top, top + height) scroll, the rows above and below stay fixed.
+ * The ILI9341 scrolls along its gate lines, which are the panel rows in
+ * portrait only; in landscape this is a no-op. */
+void lcd_scroll_set_area(uint16_t top, uint16_t height)
+{
+#if LCD_ORIENTATION == PORTRAIT
+	uint16_t params[3];
+
+	if(height == 0 || (top + height) > LCD_ACTIVE_HEIGHT) return;
+
+	lcd_scroll_top = top;
+	lcd_scroll_height = height;
+
+	/* MY mirrors rows into GRAM, so the top fixed area of the controller
+	 * is the bottom one on screen */
+	params[0] = LCD_ACTIVE_HEIGHT - top - height;	/* TFA */
+	params[1] = height;								/* VSA */
+	params[2] = top;								/* BFA */
+	lcd_write_reg16(ILI9341_VSCRDEF, params, 3);
+
+	lcd_scroll_set_offset(0);
+#endif
+}
+
+/* Show the scroll area moved up by offset rows: screen row top + k displays
+ * GRAM row top + ((k + offset) % height) */
+void lcd_scroll_set_offset(uint16_t offset)
+{
+#if LCD_ORIENTATION == PORTRAIT
+	uint16_t tfa = LCD_ACTIVE_HEIGHT - lcd_scroll_top - lcd_scroll_height;
+	uint16_t vsp;
+
+	offset %= lcd_scroll_height;
+	vsp = tfa + ((lcd_scroll_height - offset) % lcd_scroll_height);
+	lcd_write_reg16(ILI9341_VSCRSADD, &vsp, 1);
+#endif
+}
+
+/* Sends one command word in 16-bit mode. The high byte is 0x00 which the
+ * ILI9341 decodes as NOP, so the command itself is the low byte. */
+static void lcd_write_command16(SPI_TypeDef *pSPI, uint8_t cmd)
+{
+	LCD_DCX_LOW();
+	while (!(pSPI->SR & SPI_SR_TXE));
+	pSPI->DR = cmd;
+	while (!(pSPI->SR & SPI_SR_TXE));
+	while (pSPI->SR & SPI_SR_BSY);
+	LCD_DCX_HIGH();
+}
+
+/* CASET/RASET take start and end as big-endian 16-bit values, which is
+ * exactly one 16-bit SPI frame each */
+static void lcd_write_params16(SPI_TypeDef *pSPI, uint16_t start, uint16_t end)
+{
+	while (!(pSPI->SR & SPI_SR_TXE));
+	pSPI->DR = start;
+	while (!(pSPI->SR & SPI_SR_TXE));
+	pSPI->DR = end;
+	while (!(pSPI->SR & SPI_SR_TXE));
+	while (pSPI->SR & SPI_SR_BSY);
+}
+
+static void lcd_write_window(uint16_t x1, uint16_t x2, uint16_t y1, uint16_t y2, uint8_t gram_write)
+{
+	SPI_TypeDef *pSPI = LCD_SPI;
+
+	lcd_wait_idle();
+	lcd_spi_set_16bit_mode(TRUE);
+
+	/* Single CS assertion for the whole window setup */
+	LCD_CS_LOW();
+
+	lcd_write_command16(pSPI, ILI9341_CASET);
+	lcd_write_params16(pSPI, x1, x2);
+
+	lcd_write_command16(pSPI, ILI9341_RASET);
+	lcd_write_params16(pSPI, y1, y2);
+
+	if(gram_write){
+		lcd_write_command16(pSPI, ILI9341_GRAM);
+	}
+
+	LCD_CS_HIGH();
+
+	lcd_bus_stats.windows++;
+	lcd_bus_stats.setup_bytes += gram_write ? 14U : 12U;
+}
+
+/* Command with 16-bit big-endian parameters (VSCRDEF, VSCRSADD) */
+static void lcd_write_reg16(uint8_t cmd, const uint16_t *params, uint8_t count)
+{
+	SPI_TypeDef *pSPI = LCD_SPI;
+
+	lcd_wait_idle();
+	lcd_spi_set_16bit_mode(TRUE);
+
+	LCD_CS_LOW();
+	lcd_write_command16(pSPI, cmd);
+	for(uint8_t i = 0; i < count; i++){
+		while (!(pSPI->SR & SPI_SR_TXE));
+		pSPI->DR = params[i];
+	}
+	while (!(pSPI->SR & SPI_SR_TXE));
+	while (pSPI->SR & SPI_SR_BSY);
+	LCD_CS_HIGH();
+
+	lcd_bus_stats.setup_bytes += 2U + 2U * count;
+}
+
+static void lcd_spi_set_16bit_mode(uint8_t enable)
+{
+	if(lcd_spi_16bit == enable){
+		return;
+	}
+
+	__HAL_SPI_DISABLE(&lcd_spi_handle);
+	if(enable){
+		SET_SPI_16BIT_MODE(&lcd_spi_handle);
+	}else{
+		SET_SPI_8BIT_MODE(&lcd_spi_handle);
+	}
+	__HAL_SPI_ENABLE(&lcd_spi_handle);
+
+	lcd_spi_16bit = enable;
+}
+
+#if USE_LCD_TE_SYNC
+/* TE goes high once per panel refresh, when the vertical blanking starts */
+void lcd_te_enable(lcd_te_cb_t te_cb)
+{
+	GPIO_InitTypeDef GPIO_InitStruct = {0};
+	uint8_t param = 0x00;	/* TE on V-blanking only */
+
+	lcd_te_cb = te_cb;
+
+	GPIO_InitStruct.Pin = LCD_TE_PIN;
+	GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING;
+	GPIO_InitStruct.Pull = GPIO_PULLDOWN;
+	HAL_GPIO_Init(LCD_TE_PORT, &GPIO_InitStruct);
+
+	HAL_NVIC_SetPriority(LCD_TE_IRQn, 1, 0);
+	HAL_NVIC_EnableIRQ(LCD_TE_IRQn);
+
+	lcd_write_command(ILI9341_TEON);
+	lcd_write_data(&param, 1);
+}
+
+void lcd_te_irq_handler(void)
+{
+	if(lcd_te_cb){
+		lcd_te_cb();
+	}
+}
+#endif
+
+void lcd_take_bus_stats(lcd_bus_stats_t *stats)
+{
+	__disable_irq();
+	*stats = lcd_bus_stats;
+	lcd_bus_stats.setup_bytes = 0;
+	lcd_bus_stats.payload_bytes = 0;
+	lcd_bus_stats.windows = 0;
+	lcd_bus_stats.pin_writes = 0;
+	__enable_irq();
+}
+
+#if LCD_PIN_BENCH
+#define LCD_PIN_BENCH_ROUNDS	1000U	/* 8 CS writes each */
+
+/* Cycles of LCD_PIN_BENCH_ROUNDS rounds of 8 CS writes, or of the bare loop */
+static uint32_t lcd_pin_bench_run(uint8_t backend)
+{
+	uint32_t t0, i;
+
+	t0 = DWT->CYCCNT;
+	for(i = 0; i < LCD_PIN_BENCH_ROUNDS; i++){
+		if(backend == 1){
+			for(uint32_t j = 0; j < 4; j++){
+				HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_RESET);
+				HAL_GPIO_WritePin(LCD_CS_PORT, LCD_CS_PIN, GPIO_PIN_SET);
+			}
+		}else if(backend == 2){
+			for(uint32_t j = 0; j < 4; j++){
+				LCD_CS_PORT->BSRR = (uint32_t)LCD_CS_PIN << 16U;
+				LCD_CS_PORT->BSRR = (uint32_t)LCD_CS_PIN;
+			}
+		}else{
+			for(uint32_t j = 0; j < 4; j++){
+				__asm volatile("" ::: "memory");
+			}
+		}
+	}
+	return DWT->CYCCNT - t0;
 }
 
+/* Times a CS write through HAL_GPIO_WritePin() and as a BSRR store with the
+ * DWT cycle counter, whatever USE_LCD_GPIO_BSRR selects. The loop overhead
+ * is measured separately and taken off. Interrupts are masked while it
+ * runs, CS ends high. Toggling CS without clocks leaves the panel idle. */
+void lcd_pin_bench(lcd_pin_bench_t *result)
+{
+	const uint32_t writes = LCD_PIN_BENCH_ROUNDS * 8U;
+	uint32_t loop, hal, bsrr;
+
+	lcd_wait_idle();
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	__disable_irq();
+	loop = lcd_pin_bench_run(0);
+	hal = lcd_pin_bench_run(1);
+	bsrr = lcd_pin_bench_run(2);
+	__enable_irq();
+
+	hal = (hal > loop) ? hal - loop : 0;
+	bsrr = (bsrr > loop) ? bsrr - loop : 0;
+	result->hal_cycles_x100 = hal * 100U / writes;
+	result->bsrr_cycles_x100 = bsrr * 100U / writes;
+}
+#endif
+
 static void lcd_buffer_init(lcd_handle_t *lcd)
 {
 	lcd->draw_buffer1 = db;
@@ -499,12 +720,13 @@ static void lcd_buffer_init(lcd_handle_t *lcd)
 
 static uint8_t is_lcd_write_allowed(lcd_handle_t *hlcd)
 {
+	uint8_t allowed;
+
 	__disable_irq();
-	if(!hlcd->buff_to_flush)
-		return TRUE;
+	allowed = (hlcd->buff_to_flush == NULL) ? TRUE : FALSE;
 	__enable_irq();
 
-	return FALSE;
+	return allowed;
 }
 
 void lcd_send_cmd_mem_write(void)
@@ -518,15 +740,16 @@ static void lcd_flush(lcd_handle_t *hlcd)
 	uint16_t x2 = hlcd->display_area.x2;
 	uint16_t y1 = hlcd->display_area.y1;
 	uint16_t y2 = hlcd->display_area.y2;
-	lcd_set_display_area(x1, x2, y1, y2);
-	lcd_send_cmd_mem_write();
+	lcd_set_gram_window(x1, x2, y1, y2);
 
 #if USE_DMA_FLUSH_LCD
-	lcd_write_dma(hlcd->buff_to_flush, hlcd->write_length);
+	/* buff_to_flush is released from the DMA completion, so the next
+	 * chunk can be prepared in the other buffer meanwhile */
+	lcd_write_dma(hlcd->buff_to_flush, hlcd->write_length, lcd_flush_done);
 #else
 	lcd_write(hlcd->buff_to_flush, hlcd->write_length);
-#endif
 	hlcd->buff_to_flush = NULL;
+#endif
 }
 
 static uint16_t convert_rgb888_to_rgb565(uint32_t rgb888)
@@ -572,18 +795,19 @@ static uint8_t *get_buff(lcd_handle_t *hlcd)
 {
 	uint32_t buf1 = (uint32_t)hlcd->draw_buffer1;
 	uint32_t buf2 = (uint32_t)hlcd->draw_buffer2;
+	uint8_t *buff = NULL;
 
 	__disable_irq();
 	if(hlcd->buff_to_draw == NULL && hlcd->buff_to_flush == NULL){
-		return  hlcd->draw_buffer1;
+		buff = hlcd->draw_buffer1;
 	}else if((uint32_t)hlcd->buff_to_flush == buf1 && hlcd->buff_to_draw == NULL ){
-		return  hlcd->draw_buffer2;
+		buff = hlcd->draw_buffer2;
 	}else if ((uint32_t)hlcd->buff_to_flush == buf2 && hlcd->buff_to_draw == NULL){
-		return  hlcd->draw_buffer1;
+		buff = hlcd->draw_buffer1;
 	}
 	__enable_irq();
 
-	return NULL;
+	return buff;
 }
 
 static uint32_t bytes_to_pixels(uint32_t nbytes, uint8_t pixel_format)
@@ -624,45 +848,87 @@ static uint32_t copy_to_draw_buffer(lcd_handle_t *hlcd,uint32_t nbytes,uint32_t
 }
 
 #if USE_DMA_FLUSH_LCD
-static void lcd_write_dma(uint8_t *buffer, uint32_t length)
+static void lcd_write_dma(uint8_t *buffer, uint32_t length, lcd_xfer_done_cb_t done_cb)
 {
-	// Modify SPI data size to 16 bits
-	__HAL_SPI_DISABLE(&lcd_spi_handle);
-	SET_SPI_16BIT_MODE(&lcd_spi_handle);
-	__HAL_SPI_ENABLE(&lcd_spi_handle);    
+	lcd_start_dma((uint16_t *)buffer, length / 2, TRUE, done_cb);
+}
+
+/* Streams words 16-bit frames from src. With mem_inc FALSE the DMA keeps
+ * re-reading *src, which turns the transfer into a solid fill. */
+static void lcd_start_dma(uint16_t *src, uint32_t words, uint8_t mem_inc, lcd_xfer_done_cb_t done_cb)
+{
+	/* Only one transfer may own the bus, wait for the previous one */
+	lcd_wait_idle();
+	lcd_spi_set_16bit_mode(TRUE);
+
+	lcd_bus_stats.payload_bytes += words * 2UL;
 
-	uint16_t *data_ptr = (uint16_t *)buffer;
+	/* The stream is disabled while idle, so MINC can be changed here */
+	if(mem_inc){
+		SET_BIT(lcd_dma_handle.Instance->CR, DMA_SxCR_MINC);
+	}else{
+		CLEAR_BIT(lcd_dma_handle.Instance->CR, DMA_SxCR_MINC);
+	}
 	LCD_CS_LOW();
 
+	lcd_xfer_begin(src, words, mem_inc ? true : false, done_cb);
+
 #ifdef USE_DMA_IN_POLLING_MODE //This mode is for learning purpose only
+	/* Every segment was sent before lcd_dma_start_segment() returned */
+	while(lcd_xfer_is_busy()){
+		lcd_xfer_segment_done();
+	}
+#else /* USE_DMA_IN_IT_MODE */
+	/* Returns immediately, HAL_SPI_TxCpltCallback() re-arms the following
+	 * segments and finishes the transfer from the DMA1_Stream4 interrupt */
+#endif
+}
+
+/* Hands one segment to the DMA, CS stays low in between */
+static void lcd_dma_start_segment(const uint16_t *src, uint16_t words)
+{
+#ifdef USE_DMA_IN_POLLING_MODE
 	/* This will enable SPI request to DMA to start put data in SPI2->DR,
 	 * When SPI TX buffer is empty.
 	 */
     SET_BIT(lcd_spi_handle.Instance->CR2, SPI_CR2_TXDMAEN);
-	HAL_DMA_Start(&lcd_dma_handle, (uint32_t)data_ptr, (uint32_t)&LCD_SPI->DR, length/2);
+	HAL_DMA_Start(&lcd_dma_handle, (uint32_t)src, (uint32_t)&LCD_SPI->DR, words);
 	HAL_DMA_PollForTransfer(&lcd_dma_handle, HAL_DMA_FULL_TRANSFER, HAL_MAX_DELAY);
 
-	// Restore back to 8-bit mode
-	__HAL_SPI_DISABLE(&lcd_spi_handle);
-	SET_SPI_8BIT_MODE(&lcd_spi_handle);
-	__HAL_SPI_ENABLE(&lcd_spi_handle);
-#elif USE_DMA_IN_IT_MODE
-	
+	// DMA is done once the last word is in DR, wait until it is shifted out
+	while(!(lcd_spi_handle.Instance->SR & SPI_SR_TXE));
+	while(lcd_spi_handle.Instance->SR & SPI_SR_BSY);
+	CLEAR_BIT(lcd_spi_handle.Instance->CR2, SPI_CR2_TXDMAEN);
 #else
-// Make sure previous flags are cleared before starting DMA
+	HAL_SPI_Transmit_DMA(&lcd_spi_handle, (uint8_t *)src, words);
+#endif
+}
 
+/* The last segment left the SPI, release the bus. It is left in 16-bit
+ * mode for the next window/pixel write */
+static void lcd_dma_end(void)
+{
+	LCD_CS_HIGH();
+}
 
-	HAL_SPI_Transmit_DMA(&lcd_spi_handle, (uint8_t *)buffer, length/2);
-#endif
+static void lcd_flush_done(void)
+{
+	hlcd->buff_to_flush = NULL;
+}
+
+/* Blocking write, kept for callers which reuse the buffer right away */
+void lcd_write(uint8_t *buffer, uint32_t length)
+{
+	lcd_write_dma(buffer, length, NULL);
+	lcd_wait_idle();
 }
 
 #else
 void lcd_write(uint8_t *buffer, uint32_t length)
 {
-    // Switch SPI to 16-bit mode
-    __HAL_SPI_DISABLE(&lcd_spi_handle);
-    SET_SPI_16BIT_MODE(&lcd_spi_handle);
-    __HAL_SPI_ENABLE(&lcd_spi_handle);
+    // Switch SPI to 16-bit mode (no-op unless a config command ran before)
+    lcd_spi_set_16bit_mode(TRUE);
+    lcd_bus_stats.payload_bytes += length;
 
     LCD_CS_LOW();
 
@@ -682,16 +948,36 @@ void lcd_write(uint8_t *buffer, uint32_t length)
     while(lcd_spi_handle.Instance->SR & SPI_SR_BSY);
 
     LCD_CS_HIGH();
-
-    // Restore back to 8-bit mode
-    __HAL_SPI_DISABLE(&lcd_spi_handle);
-    SET_SPI_8BIT_MODE(&lcd_spi_handle);
-    __HAL_SPI_ENABLE(&lcd_spi_handle);
 }
 
 
 #endif // USE_DMA_FLUSH_LCD
 
+/* Starts a pixel transfer and returns as soon as the bus is handed over to
+ * the DMA. done_cb is invoked once the last pixel left SPI2, the buffer must
+ * stay untouched until then. Without DMA this degrades to a blocking write. */
+void lcd_write_async(uint8_t *buffer, uint32_t length, lcd_xfer_done_cb_t done_cb)
+{
+#if USE_DMA_FLUSH_LCD
+	lcd_write_dma(buffer, length, done_cb);
+#else
+	lcd_write(buffer, length);
+	if(done_cb){
+		done_cb();
+	}
+#endif
+}
+
+bool lcd_is_busy(void)
+{
+	return lcd_xfer_is_busy();
+}
+
+static void lcd_wait_idle(void)
+{
+	while(lcd_xfer_is_busy());
+}
+
 void ili9341_test_draw_color_bars(void)
 {
     // === Set Column Address (0 to 239) ===
@@ -741,15 +1027,15 @@ void ili9341_test_draw_color_bars(void)
 
 void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
 {
-	__HAL_DMA_CLEAR_FLAG(&lcd_dma_handle, __HAL_DMA_GET_TC_FLAG_INDEX(&lcd_dma_handle));
-	__HAL_DMA_CLEAR_FLAG(&lcd_dma_handle, __HAL_DMA_GET_TC_FLAG_INDEX(&lcd_dma_handle));
-	__HAL_DMA_CLEAR_FLAG(&lcd_dma_handle, __HAL_DMA_GET_TC_FLAG_INDEX(&lcd_dma_handle));
-
-	LCD_CS_HIGH();
+	if(hspi->Instance != LCD_SPI){
+		return;
+	}
 
-	__HAL_SPI_DISABLE(hspi);
-	SET_SPI_8BIT_MODE(hspi);
-	__HAL_SPI_ENABLE(hspi);
+#if USE_DMA_FLUSH_LCD
+	/* HAL already waited for BSY to clear. Chain the next segment if the
+	 * write was longer than one DMA run, otherwise the transfer is done */
+	lcd_xfer_segment_done();
+#endif
 }
 
 void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
@@ -773,3 +1059,9 @@ void *lcd_get_draw_buffer2_addr(void)
 {
 	return (void*)hlcd->draw_buffer2;
 }
+
+/* Size of one draw buffer, buffer 2 starts right after buffer 1 */
+uint32_t lcd_get_draw_buffer_size(void)
+{
+	return DB_SIZE;
+}
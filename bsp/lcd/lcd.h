@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "config.h"
+#include "lcd_xfer.h"
 
 #define HIGH_16(x) (((uint16_t)x >> 0x8U) & 0xFFU)
 #define LOW_16(x)  (((uint16_t)x >> 0x0U) & 0xFFU)
@@ -39,16 +40,48 @@ typedef struct{
  	lcd_area_t display_area;
  } lcd_handle_t;
 
+/* Called on every TE pulse, from the EXTI interrupt */
+typedef void (*lcd_te_cb_t)(void);
+
+/* SPI2 traffic split into window/command overhead and pixel payload */
+typedef struct{
+ 	uint32_t setup_bytes;
+ 	uint32_t payload_bytes;
+ 	uint32_t windows;
+ 	uint32_t pin_writes;	/* CS/DCX toggles */
+ } lcd_bus_stats_t;
+
+/* Cost of one pin write in 1/100 CPU cycles */
+typedef struct{
+ 	uint32_t hal_cycles_x100;	/* HAL_GPIO_WritePin() */
+ 	uint32_t bsrr_cycles_x100;	/* a single BSRR store */
+ } lcd_pin_bench_t;
+
 /* Exported functions prototypes */
 void lcd_init(void);
 void lcd_set_background_color(uint32_t rgb888);
 void lcd_fill_rect(uint32_t rgb888, uint32_t x_start, uint32_t x_width, uint32_t y_start,uint32_t y_height);
+void lcd_fill_rect_fast(uint32_t rgb888, uint32_t x_start, uint32_t x_width, uint32_t y_start, uint32_t y_height);
 void ili9341_test_draw_color_bars(void);
 
 void lcd_set_display_area(uint16_t x1, uint16_t x2, uint16_t y1, uint16_t y2);
+void lcd_set_gram_window(uint16_t x1, uint16_t x2, uint16_t y1, uint16_t y2);
 void lcd_send_cmd_mem_write(void);
+void lcd_scroll_set_area(uint16_t top, uint16_t height);
+void lcd_scroll_set_offset(uint16_t offset);
 void lcd_write(uint8_t *buffer, uint32_t length);
+void lcd_write_async(uint8_t *buffer, uint32_t length, lcd_xfer_done_cb_t done_cb);
+bool lcd_is_busy(void);
+void lcd_take_bus_stats(lcd_bus_stats_t *stats);
+#if LCD_PIN_BENCH
+void lcd_pin_bench(lcd_pin_bench_t *result);
+#endif
+#if USE_LCD_TE_SYNC
+void lcd_te_enable(lcd_te_cb_t te_cb);
+void lcd_te_irq_handler(void);
+#endif
 void *lcd_get_draw_buffer1_addr(void);
 void *lcd_get_draw_buffer2_addr(void);
+uint32_t lcd_get_draw_buffer_size(void);
 
 #endif /* __LCD_H__ */
\ No newline at end of file
@@ -0,0 +1,235 @@
+#include <stddef.h>
+#include "lcd_xfer.h"
+
+static const lcd_xfer_port_t *xfer_port = NULL;
+static const uint16_t *xfer_next;			/* First word of the next segment */
+static volatile uint32_t xfer_remaining;	/* Words not yet handed to the DMA */
+static bool xfer_mem_inc;					/* false while streaming a solid fill */
+static lcd_xfer_done_cb_t xfer_done_cb = NULL;
+static volatile bool xfer_busy = false;		/* Cleared by lcd_xfer_complete() */
+
+static bool lcd_xfer_start_segment(void);
+static void lcd_xfer_complete(void);
+
+void lcd_xfer_set_port(const lcd_xfer_port_t *port)
+{
+	xfer_port = port;
+}
+
+const lcd_xfer_port_t *lcd_xfer_get_port(void)
+{
+	return xfer_port;
+}
+
+/* Streams words 16-bit frames from src. With mem_inc false every segment
+ * re-reads *src, which turns the transfer into a solid fill. The caller
+ * waits for lcd_xfer_is_busy() to clear before it starts the next one. */
+void lcd_xfer_begin(const uint16_t *src, uint32_t words, bool mem_inc, lcd_xfer_done_cb_t done_cb)
+{
+	xfer_done_cb = done_cb;
+	xfer_mem_inc = mem_inc;
+	xfer_next = src;
+	xfer_remaining = words;
+	xfer_busy = true;
+
+	if(!lcd_xfer_start_segment()){
+		lcd_xfer_complete();
+	}
+}
+
+/* A segment left the SPI (HAL_SPI_TxCpltCallback() on the target). Chains
+ * the next one, or finishes the transfer after the last. */
+void lcd_xfer_segment_done(void)
+{
+	if(!xfer_busy){
+		return;
+	}
+
+	if(!lcd_xfer_start_segment()){
+		lcd_xfer_complete();
+	}
+}
+
+bool lcd_xfer_is_busy(void)
+{
+	return xfer_busy;
+}
+
+/* Hands the next chunk (at most max_words of the port) to the DMA.
+ * CS stays low between segments so the panel sees one continuous GRAM write.
+ * Returns false when there was nothing left to send. */
+static bool lcd_xfer_start_segment(void)
+{
+	uint32_t words = xfer_remaining;
+	const uint16_t *src = xfer_next;
+
+	if(words == 0){
+		return false;
+	}
+	if(words > xfer_port->max_words){
+		words = xfer_port->max_words;
+	}
+
+	if(xfer_mem_inc){
+		xfer_next += words;
+	}
+	xfer_remaining -= words;
+
+	xfer_port->start(src, (uint16_t)words);
+	return true;
+}
+
+/* Releases the bus and notifies the requester, which may start the next
+ * transfer from the callback */
+static void lcd_xfer_complete(void)
+{
+	lcd_xfer_done_cb_t done_cb = xfer_done_cb;
+
+	xfer_port->end();
+
+	xfer_done_cb = NULL;
+	xfer_busy = false;
+
+	if(done_cb){
+		done_cb();
+	}
+}
+
+#if LCD_XFER_TEST
+#include "debug_test.h"
+
+/* Fake DMA controller: it records the segments it is handed, the test
+ * finishes them one at a time like the transfer complete interrupt does */
+static struct{
+	uintptr_t base;			/* src of the transfer */
+	uintptr_t expect;		/* where the next segment has to start */
+	bool mem_inc;
+	bool running;			/* a segment was started and not finished yet */
+	uint32_t bad_starts;	/* started while another one ran, empty or from the wrong address */
+	uint32_t segments;
+	uint32_t words;
+	uint32_t max_words;
+	uint32_t ends;			/* CS released */
+	uint32_t dones;			/* done callbacks */
+	uint32_t done_segments;	/* segments started when the done callback ran */
+	bool busy_in_done;		/* lcd_xfer_is_busy() seen from the done callback */
+} fake_dma;
+
+static void fake_dma_start(const uint16_t *src, uint16_t words)
+{
+	if(fake_dma.running || (uintptr_t)src != fake_dma.expect || words == 0){
+		fake_dma.bad_starts++;
+	}
+	fake_dma.running = true;
+	fake_dma.segments++;
+	fake_dma.words += words;
+	if(words > fake_dma.max_words){
+		fake_dma.max_words = words;
+	}
+	if(fake_dma.mem_inc){
+		fake_dma.expect += (uintptr_t)words * sizeof(uint16_t);
+	}
+}
+
+static void fake_dma_end(void)
+{
+	fake_dma.ends++;
+}
+
+static void fake_dma_done(void)
+{
+	fake_dma.dones++;
+	fake_dma.done_segments = fake_dma.segments;
+	fake_dma.busy_in_done = lcd_xfer_is_busy();
+}
+
+static const lcd_xfer_port_t fake_dma_port = {
+	.start = fake_dma_start,
+	.end = fake_dma_end,
+	.max_words = LCD_XFER_MAX_SEGMENT,
+};
+
+/* Streams one transfer through the fake controller and checks the chain */
+static uint32_t lcd_xfer_test_case(uint32_t words, bool mem_inc)
+{
+	static const uint16_t pixels[1];
+	uint32_t expected = (words + LCD_XFER_MAX_SEGMENT - 1) / LCD_XFER_MAX_SEGMENT;
+
+	fake_dma.base = (uintptr_t)pixels;
+	fake_dma.expect = fake_dma.base;
+	fake_dma.mem_inc = mem_inc;
+	fake_dma.running = false;
+	fake_dma.bad_starts = 0;
+	fake_dma.segments = 0;
+	fake_dma.words = 0;
+	fake_dma.max_words = 0;
+	fake_dma.ends = 0;
+	fake_dma.dones = 0;
+
+	lcd_xfer_begin(pixels, words, mem_inc, fake_dma_done);
+
+	while(fake_dma.running){
+		/* Nothing is reported before the last segment finished */
+		TEST_CHECK(lcd_xfer_is_busy());
+		TEST_CHECK(fake_dma.dones == 0 && fake_dma.ends == 0);
+
+		fake_dma.running = false;
+		lcd_xfer_segment_done();
+	}
+
+	TEST_CHECK(!lcd_xfer_is_busy());
+	TEST_CHECK(fake_dma.bad_starts == 0);
+	TEST_CHECK(fake_dma.segments == expected);
+	TEST_CHECK(fake_dma.words == words);
+	TEST_CHECK(fake_dma.max_words <= LCD_XFER_MAX_SEGMENT);
+	TEST_CHECK(fake_dma.ends == 1);
+	TEST_CHECK(fake_dma.dones == 1);
+	TEST_CHECK(fake_dma.done_segments == expected);
+	TEST_CHECK(!fake_dma.busy_in_done);
+
+	/* A late or spurious completion doesn't report the transfer again */
+	lcd_xfer_segment_done();
+	TEST_CHECK(fake_dma.segments == expected);
+	TEST_CHECK(fake_dma.ends == 1 && fake_dma.dones == 1);
+
+	return 0;
+}
+
+static uint32_t lcd_xfer_test_run(void)
+{
+	static const uint32_t lengths[] = {
+		0, 1, 10240,
+		LCD_XFER_MAX_SEGMENT - 1, LCD_XFER_MAX_SEGMENT, LCD_XFER_MAX_SEGMENT + 1,
+		2 * LCD_XFER_MAX_SEGMENT, 2 * LCD_XFER_MAX_SEGMENT + 1,
+		240UL * 320UL,						/* a whole frame, 2 segments */
+	};
+	uint32_t line;
+
+	for(uint32_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++){
+		line = lcd_xfer_test_case(lengths[i], true);
+		if(line) return line;
+		line = lcd_xfer_test_case(lengths[i], false);
+		if(line) return line;
+	}
+
+	return 0;
+}
+
+/* Runs the segment chain against the fake DMA controller and puts the real
+ * port back. Returns 0 if all checks passed, else the line of the first
+ * failed one. */
+uint32_t lcd_xfer_test(void)
+{
+	const lcd_xfer_port_t *port;
+	uint32_t line;
+
+	while(xfer_busy);
+
+	port = xfer_port;
+	xfer_port = &fake_dma_port;
+	line = lcd_xfer_test_run();
+	xfer_port = port;
+
+	return line;
+}
+#endif
@@ -0,0 +1,41 @@
+#ifndef __LCD_XFER_H__
+#define __LCD_XFER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Pixel transfer engine of the LCD driver. NDTR (and the HAL Size argument)
+ * is 16 bits wide, so one write is streamed as a chain of DMA segments and
+ * the requester is notified once, after the last one. No hardware access:
+ * lcd.c plugs the DMA start and the chip select in through lcd_xfer_port_t
+ * and reports every finished segment, so the chaining runs the same against
+ * a fake DMA controller on the host. */
+
+/* 1: lcd_xfer_test() is built, it runs the chain against a fake DMA controller */
+#ifndef LCD_XFER_TEST
+#define LCD_XFER_TEST			0
+#endif
+
+/* Most frames one DMA run can move, NDTR is 16 bits wide */
+#define LCD_XFER_MAX_SEGMENT	0xFFFFUL
+
+/* Called once a pixel transfer started by lcd_write_async() has left the SPI.
+ * In DMA IT mode this runs in the DMA1_Stream4 interrupt context. */
+typedef void (*lcd_xfer_done_cb_t)(void);
+
+typedef struct{
+	void (*start)(const uint16_t *src, uint16_t words);	/* hand one segment to the DMA */
+	void (*end)(void);									/* the last segment left the SPI */
+	uint16_t max_words;									/* longest segment start() takes */
+} lcd_xfer_port_t;
+
+void lcd_xfer_set_port(const lcd_xfer_port_t *port);
+const lcd_xfer_port_t *lcd_xfer_get_port(void);
+void lcd_xfer_begin(const uint16_t *src, uint32_t words, bool mem_inc, lcd_xfer_done_cb_t done_cb);
+void lcd_xfer_segment_done(void);
+bool lcd_xfer_is_busy(void);
+#if LCD_XFER_TEST
+uint32_t lcd_xfer_test(void);
+#endif
+
+#endif /* __LCD_XFER_H__ */
@@ -0,0 +1,234 @@
+#include <string.h>
+#include "te_sched.h"
+
+static void te_sched_end_wait(te_sched_t *s, uint32_t now);
+
+void te_sched_init(te_sched_t *s, uint32_t window, uint32_t timeout)
+{
+	memset(s, 0, sizeof(*s));
+	s->window = window;
+	s->timeout = timeout;
+}
+
+/* Called on every TE rising edge (interrupt context on the target) */
+void te_sched_on_te(te_sched_t *s, uint32_t now)
+{
+	s->te_last = now;
+	s->te_count++;
+}
+
+/* A flush is about to write GRAM. Only the first area of a frame is
+ * synchronized, the rest follows it back to back.
+ * Returns true if the write may start now, false if te_sched_poll() has
+ * to be called until it does. */
+bool te_sched_begin(te_sched_t *s, bool first_of_frame, uint32_t now)
+{
+	uint32_t count;
+	uint32_t last;
+
+	if(!first_of_frame){
+		return true;
+	}
+
+	s->stats.frames++;
+
+	/* Re-read if an edge came in between */
+	do{
+		count = s->te_count;
+		last = s->te_last;
+	}while(count != s->te_count);
+
+	/* The scan line is still close to the top, start right away */
+	if(count != 0 && (now - last) <= s->window){
+		s->stats.synced++;
+		return true;
+	}
+
+	s->waiting = true;
+	s->wait_count = count;
+	s->wait_start = now;
+	return false;
+}
+
+/* Returns true once the waiting write may start: on the next TE edge, or
+ * after the timeout if the panel does not deliver one */
+bool te_sched_poll(te_sched_t *s, uint32_t now)
+{
+	if(!s->waiting){
+		return true;
+	}
+
+	if(s->te_count != s->wait_count){
+		s->stats.synced++;
+	}else if((now - s->wait_start) >= s->timeout){
+		s->stats.missed++;
+	}else{
+		return false;
+	}
+
+	te_sched_end_wait(s, now);
+	return true;
+}
+
+void te_sched_take_stats(te_sched_t *s, te_sched_stats_t *stats)
+{
+	*stats = s->stats;
+	memset(&s->stats, 0, sizeof(s->stats));
+}
+
+static void te_sched_end_wait(te_sched_t *s, uint32_t now)
+{
+	uint32_t waited = now - s->wait_start;
+
+	s->waiting = false;
+	s->stats.wait_total += waited;
+	if(waited > s->stats.wait_max){
+		s->stats.wait_max = waited;
+	}
+}
+
+#if TE_SCHED_TEST
+#include "debug_test.h"
+
+/* Simulated time runs in 0.1 ms steps: TE at 70 Hz, the window and the
+ * timeout tft.c uses (TFT_TE_WINDOW_MS, TFT_TE_TIMEOUT_MS) */
+#define TE_SIM_PERIOD		143
+#define TE_SIM_WINDOW		20
+#define TE_SIM_TIMEOUT		200
+
+/* Simulated panel: a TE pulse every period while it is running */
+typedef struct{
+	uint32_t now;
+	uint32_t next_te;
+	uint32_t te_last;		/* time of the last pulse, for the checks */
+	uint32_t te_count;
+	bool running;
+} te_sim_t;
+
+/* Advances time by one step, pulsing TE like the EXTI interrupt does */
+static void te_sim_step(te_sim_t *sim, te_sched_t *s)
+{
+	sim->now++;
+	if(sim->running && sim->now == sim->next_te){
+		sim->next_te += TE_SIM_PERIOD;
+		sim->te_last = sim->now;
+		sim->te_count++;
+		te_sched_on_te(s, sim->now);
+	}
+}
+
+static void te_sim_advance(te_sim_t *sim, te_sched_t *s, uint32_t steps)
+{
+	while(steps--){
+		te_sim_step(sim, s);
+	}
+}
+
+/* Starts a frame like tft_flush() does: begin, then poll once per step.
+ * Returns the time it waited. */
+static uint32_t te_sim_frame(te_sim_t *sim, te_sched_t *s)
+{
+	uint32_t start = sim->now;
+
+	if(!te_sched_begin(s, true, sim->now)){
+		while(!te_sched_poll(s, sim->now)){
+			te_sim_step(sim, s);
+		}
+	}
+	return sim->now - start;
+}
+
+static void te_sim_init(te_sim_t *sim, te_sched_t *s, uint32_t now, uint32_t first_te)
+{
+	te_sched_init(s, TE_SIM_WINDOW, TE_SIM_TIMEOUT);
+	sim->now = now;
+	sim->next_te = first_te;
+	sim->te_last = 0;
+	sim->te_count = 0;
+	sim->running = true;
+}
+
+static uint32_t te_sched_test_run(uint32_t base)
+{
+	te_sched_t s;
+	te_sim_t sim;
+	te_sched_stats_t st;
+	uint32_t wait, i, phase;
+
+	/* No pulse seen yet: wait for the first one */
+	te_sim_init(&sim, &s, base, base + 50);
+	wait = te_sim_frame(&sim, &s);
+	TEST_CHECK(wait == 50 && sim.now == sim.te_last);
+
+	/* Inside the window: start right away, also on its last step */
+	te_sim_advance(&sim, &s, TE_SIM_WINDOW);
+	TEST_CHECK(te_sched_begin(&s, true, sim.now));
+
+	/* Just past the window: wait for the next pulse and start on it */
+	te_sim_advance(&sim, &s, 1);
+	wait = te_sim_frame(&sim, &s);
+	TEST_CHECK(sim.now == sim.te_last);
+	TEST_CHECK(wait == TE_SIM_PERIOD - TE_SIM_WINDOW - 1);
+
+	/* The other areas of a frame follow without waiting, and aren't counted */
+	te_sim_advance(&sim, &s, 70);
+	TEST_CHECK(te_sched_begin(&s, false, sim.now));
+	TEST_CHECK(te_sched_poll(&s, sim.now));
+
+	te_sched_take_stats(&s, &st);
+	TEST_CHECK(st.frames == 3 && st.synced == 3 && st.missed == 0);
+	TEST_CHECK(st.wait_total == 50 + TE_SIM_PERIOD - TE_SIM_WINDOW - 1);
+	TEST_CHECK(st.wait_max == TE_SIM_PERIOD - TE_SIM_WINDOW - 1);
+	te_sched_take_stats(&s, &st);
+	TEST_CHECK(st.frames == 0 && st.wait_total == 0 && st.wait_max == 0);
+
+	/* Frames at every phase of the scan: each starts inside a window and
+	 * never waits longer than one period */
+	for(i = 0; i < 3 * TE_SIM_PERIOD; i++){
+		phase = (i * 37U) % TE_SIM_PERIOD;
+		te_sim_advance(&sim, &s, phase + 1);
+		wait = te_sim_frame(&sim, &s);
+		TEST_CHECK(sim.now - sim.te_last <= TE_SIM_WINDOW);
+		TEST_CHECK(wait < TE_SIM_PERIOD);
+		TEST_CHECK(wait == 0 || sim.now == sim.te_last);
+	}
+	te_sched_take_stats(&s, &st);
+	TEST_CHECK(st.frames == 3 * TE_SIM_PERIOD && st.synced == st.frames && st.missed == 0);
+	TEST_CHECK(st.wait_max < TE_SIM_PERIOD);
+
+	/* The panel stops pulsing: give up after exactly the timeout */
+	sim.running = false;
+	te_sim_advance(&sim, &s, TE_SIM_WINDOW + 1);
+	wait = te_sim_frame(&sim, &s);
+	TEST_CHECK(wait == TE_SIM_TIMEOUT);
+	wait = te_sim_frame(&sim, &s);
+	TEST_CHECK(wait == TE_SIM_TIMEOUT);
+	te_sched_take_stats(&s, &st);
+	TEST_CHECK(st.frames == 2 && st.missed == 2 && st.synced == 0);
+	TEST_CHECK(st.wait_total == 2 * TE_SIM_TIMEOUT && st.wait_max == TE_SIM_TIMEOUT);
+
+	/* It comes back: the next frame waits for its pulse again */
+	sim.running = true;
+	sim.next_te = sim.now + 30;
+	wait = te_sim_frame(&sim, &s);
+	TEST_CHECK(wait == 30 && sim.now == sim.te_last);
+	te_sched_take_stats(&s, &st);
+	TEST_CHECK(st.synced == 1 && st.missed == 0);
+
+	return 0;
+}
+
+/* Runs the scheduler against a simulated 70 Hz TE source, once from zero
+ * and once across the wrap of the time counter. Returns 0 if all checks
+ * passed, else the line of the first failed one. */
+uint32_t te_sched_test(void)
+{
+	uint32_t line;
+
+	line = te_sched_test_run(0);
+	if(line == 0){
+		line = te_sched_test_run(UINT32_MAX - 1000U);
+	}
+	return line;
+}
+#endif
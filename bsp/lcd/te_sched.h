@@ -0,0 +1,45 @@
+#ifndef __TE_SCHED_H__
+#define __TE_SCHED_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Decides when a frame may start its GRAM write relative to the panel's
+ * tearing effect (TE) pulses. No hardware access: the caller feeds the TE
+ * edges and the current time, so it runs the same on a simulated TE source.
+ * Times are in the caller's unit (HAL ticks on the target). */
+
+/* 1: te_sched_test() is built, it runs the scheduler against a simulated TE source */
+#ifndef TE_SCHED_TEST
+#define TE_SCHED_TEST			0
+#endif
+
+typedef struct{
+	uint32_t frames;		/* frames that asked to be synchronized */
+	uint32_t synced;		/* started inside a TE window */
+	uint32_t missed;		/* no TE before the timeout, started anyway */
+	uint32_t wait_total;	/* time spent waiting for TE */
+	uint32_t wait_max;
+} te_sched_stats_t;
+
+typedef struct{
+	uint32_t window;				/* a write may still start this long after a TE edge */
+	uint32_t timeout;				/* stop waiting for TE after this long */
+	volatile uint32_t te_count;		/* TE edges seen, written by te_sched_on_te() */
+	volatile uint32_t te_last;		/* time of the last TE edge */
+	uint32_t wait_count;			/* te_count when the wait started */
+	uint32_t wait_start;
+	bool waiting;
+	te_sched_stats_t stats;
+} te_sched_t;
+
+void te_sched_init(te_sched_t *s, uint32_t window, uint32_t timeout);
+void te_sched_on_te(te_sched_t *s, uint32_t now);
+bool te_sched_begin(te_sched_t *s, bool first_of_frame, uint32_t now);
+bool te_sched_poll(te_sched_t *s, uint32_t now);
+void te_sched_take_stats(te_sched_t *s, te_sched_stats_t *stats);
+#if TE_SCHED_TEST
+uint32_t te_sched_test(void);
+#endif
+
+#endif /* __TE_SCHED_H__ */
@@ -9,6 +9,11 @@
 #include "XPT2046.h"
 #include "stm32f4xx.h"
 #include "tft.h"
+#include "hw_def.h"
+#include "touch_ring.h"
+#include "touch_filter.h"
+#include "touch_calib.h"
+#include "mem_place.h"
 
 #if USE_XPT2046
 
@@ -21,6 +26,15 @@
  *********************/
 #define CMD_X_READ  0b10010000
 #define CMD_Y_READ  0b11010000
+#define CMD_Z1_READ 0b10110000
+#define CMD_Z2_READ 0b11000000
+
+#if USE_TSC_PENIRQ
+/*One burst converts X, Y, Z1, Z2 XPT2046_BURST times. Every command goes out
+ *while the previous result is shifted in, so a conversion costs 2 bytes*/
+#define BURST_CONV  (XPT2046_BURST * 4)
+#define BURST_LEN   (BURST_CONV * 2 + 1)
+#endif
 
 /**********************
  *      TYPEDEFS
@@ -29,15 +43,40 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-static void xpt2046_corr(int16_t * x, int16_t * y);
-static void xpt2046_avg(int16_t * x, int16_t * y);
+static void xpt2046_cal_default(touch_cal_t * c);
+static uint32_t xpt2046_spi_br(void);
+#if USE_TSC_PENIRQ
+static void xpt2046_dma_init(void);
+static void xpt2046_sample(void);
+static void xpt2046_burst_done(void);
+static void xpt2046_timer_init(void);
+static uint32_t xpt2046_timer_psc(void);
+static void sampler_start(void);
+static void sampler_stop(void);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
-int16_t avg_buf_x[XPT2046_AVG];
-int16_t avg_buf_y[XPT2046_AVG];
-uint8_t avg_last;
+static touch_mean_t mean;
+static touch_press_t press;
+static CCM_BSS touch_cal_t cal;
+static int16_t raw_x;           /*Last averaged reading, before the matrix*/
+static int16_t raw_y;
+static uint32_t spi_hz;         /*SPI1 bit rate at boot, kept when HCLK changes*/
+static volatile uint32_t spi_br;
+
+#if USE_TSC_PENIRQ
+static touch_ring_t ring;
+static volatile bool sampling;  /*The timer runs and PENIRQ is masked*/
+static volatile bool burst_busy;
+
+DMA_HandleTypeDef tsc_dma_rx_handle;
+DMA_HandleTypeDef tsc_dma_tx_handle;
+/*Global so the linker scripts can check where they landed*/
+DMA_BUFFER uint8_t xpt2046_burst_tx[BURST_LEN];
+DMA_BUFFER uint8_t xpt2046_burst_rx[BURST_LEN];
+#endif
 
 /**********************
  *      MACROS
@@ -65,9 +104,9 @@ uint8_t xpt2046_xchg_value(uint8_t val)
 void xpt2046_cs(uint8_t val)
 {
 	if(val){
-		HAL_GPIO_WritePin(GPIOA, GPIO_PIN_15, GPIO_PIN_SET);
+		LCD_GPIO_SET(TSC_CS_PORT, TSC_CS_PIN);
 	}else{
-		HAL_GPIO_WritePin(GPIOA, GPIO_PIN_15, GPIO_PIN_RESET);
+		LCD_GPIO_RESET(TSC_CS_PORT, TSC_CS_PIN);
 	}
 }
 
@@ -97,11 +136,11 @@ void HAL_SPI_MspInit(SPI_HandleTypeDef* hspi)
     GPIO_InitStruct.Alternate = GPIO_AF5_SPI1;
     HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
 
-    GPIO_InitStruct.Pin = GPIO_PIN_15;
+    GPIO_InitStruct.Pin = TSC_CS_PIN;
     GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
     GPIO_InitStruct.Pull = GPIO_NOPULL;
     GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_MEDIUM;
-    HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+    HAL_GPIO_Init(TSC_CS_PORT, &GPIO_InitStruct);
 
   /* USER CODE BEGIN SPI1_MspInit 1 */
 
@@ -155,28 +194,204 @@ void xpt2046_init(void)
   __HAL_RCC_GPIOA_CLK_ENABLE();
 
 
-  /*Configure GPIO pin : PA8 */
-  GPIO_InitStruct.Pin = GPIO_PIN_8;
+  /*Configure GPIO pin : PA8 (PENIRQ) */
+  GPIO_InitStruct.Pin = TSC_PENIRQ_PIN;
+#if USE_TSC_PENIRQ
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
+#else
   GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+#endif
   GPIO_InitStruct.Pull = GPIO_NOPULL;
-  HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+  HAL_GPIO_Init(TSC_PENIRQ_PORT, &GPIO_InitStruct);
 
 	MX_SPI1_Init();
+	spi_hz = HAL_RCC_GetPCLK2Freq() / 16;
+	spi_br = SPI1->CR1 & SPI_CR1_BR;
 
 	LV_DRV_INDEV_SPI_CS(0);
 	LV_DRV_INDEV_SPI_XCHG_BYTE(0x80);
 	LV_DRV_INDEV_SPI_XCHG_BYTE(0);
 	LV_DRV_INDEV_SPI_XCHG_BYTE(0);
 	LV_DRV_INDEV_SPI_CS(1);
+
+	touch_mean_init(&mean, XPT2046_AVG);
+	touch_press_init(&press, XPT2046_RT_PRESS, XPT2046_RT_RELEASE);
+	xpt2046_set_cal(NULL);
+
+#if USE_TSC_PENIRQ
+	touch_ring_init(&ring);
+	xpt2046_dma_init();
+	xpt2046_timer_init();
+
+	/*SPI1 belongs to the sampler from now on*/
+	HAL_NVIC_SetPriority(TSC_PENIRQ_IRQn, 2, 0);
+	HAL_NVIC_EnableIRQ(TSC_PENIRQ_IRQn);
+#endif
 }
 
 
 uint8_t xpt2046_irq_pin_read(void)
 {
-	return HAL_GPIO_ReadPin(GPIOA, GPIO_PIN_8);
+	return HAL_GPIO_ReadPin(TSC_PENIRQ_PORT, TSC_PENIRQ_PIN);
+}
+
+/**
+ * Change the pressure thresholds
+ * @param press_rt pressed once the touch resistance (ohm) drops below this
+ * @param release_rt released once it rises above this
+ */
+void xpt2046_set_pressure(uint32_t press_rt, uint32_t release_rt)
+{
+    __disable_irq();
+    touch_press_init(&press, press_rt, release_rt);
+    __enable_irq();
+}
+
+
+/**
+ * Replace the raw-to-screen matrix
+ * @param c the new matrix, NULL: the one made of XPT2046_X_MIN/MAX etc.
+ */
+void xpt2046_set_cal(const touch_cal_t * c)
+{
+    if(c) cal = *c;
+    else xpt2046_cal_default(&cal);
 }
 
+/**
+ * Keep the SPI1 bit rate and the sample period after HCLK changed.
+ * Called by clock_perf_set() with interrupts disabled.
+ */
+void xpt2046_clock_update(void)
+{
+    spi_br = xpt2046_spi_br();
+
+#if USE_TSC_PENIRQ
+    /*Both take effect at the next update and the next burst*/
+    TSC_SAMPLE_TIM->PSC = xpt2046_timer_psc();
+#else
+    MODIFY_REG(SPI1->CR1, SPI_CR1_BR, spi_br);
+#endif
+}
+
+/**
+ * Get the last reading before it was mapped to the screen, for calibration
+ * @param x store the raw x here
+ * @param y store the raw y here
+ */
+void xpt2046_get_raw(int16_t * x, int16_t * y)
+{
+    *x = raw_x;
+    *y = raw_y;
+}
+
+
+#if USE_TSC_PENIRQ
+/**
+ * Called on the falling edge of PENIRQ. Takes the first sample right away
+ * and lets the timer pace the next ones until the pen is lifted.
+ */
+void xpt2046_penirq_handler(void)
+{
+    if(sampling) return;
+
+    sampler_start();
+    xpt2046_sample();
+}
+
+/**
+ * Check for samples that xpt2046_read() didn't take yet
+ * @return true if a touch is waiting to be read
+ */
+bool xpt2046_has_samples(void)
+{
+    return touch_ring_count(&ring) != 0;
+}
+
+/**
+ * Called from the interrupt of TSC_SAMPLE_TIM
+ */
+void xpt2046_timer_irq_handler(void)
+{
+    if(TSC_SAMPLE_TIM->SR & TIM_SR_UIF) {
+        TSC_SAMPLE_TIM->SR = (uint32_t)~TIM_SR_UIF;
+        if(sampling) xpt2046_sample();
+    }
+}
+
+/**
+ * End of a burst, HAL calls it from the SPI1 RX DMA interrupt
+ */
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    if(hspi->Instance != SPI1) return;
+
+    xpt2046_burst_done();
+}
+
+/**
+ * Get the current position and state of the touchpad from the queued samples
+ * @param indev the input device
+ * @param data store the read data here
+ */
+void xpt2046_read(lv_indev_t * indev, lv_indev_data_t * data)
+{
+    static int16_t last_x = 0;
+    static int16_t last_y = 0;
+    static bool last_pressed = false;
+
+    touch_sample_t s;
+    bool pressed = last_pressed;
+    bool taken = false;
+
+    LV_UNUSED(indev);
+
+    while(touch_ring_peek(&ring, &s)) {
+        bool down = (s.z != 0);
+
+        /*Report a press and the following release in separate reads,
+         *a short tap would be lost otherwise*/
+        if(taken && down != pressed) {
+            data->continue_reading = true;
+            break;
+        }
+
+        touch_ring_pop(&ring, NULL);
+        taken = true;
+        pressed = down;
+
+        if(down) {
+            int16_t x = s.x;
+            int16_t y = s.y;
+            touch_mean_push(&mean, &x, &y);
+            raw_x = x;
+            raw_y = y;
+            touch_cal_apply(&cal, &x, &y);
+            last_x = x;
+            last_y = y;
+        }
+        else {
+            /*Start the next touch with a fresh average*/
+            touch_mean_reset(&mean);
+        }
+    }
+
+    data->point.x = last_x;
+    data->point.y = last_y;
+    data->state   = pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+
+    /* Debug logs to verify */
+    if (pressed && !last_pressed)
+        LV_LOG_USER("[TOUCH] PRESSED (%d,%d)", last_x, last_y);
+    else if (!pressed && last_pressed) {
+      data->point.x = -1;
+      data->point.y = -1;
+      LV_LOG_USER("[TOUCH] RELEASED (%d,%d)", last_x, last_y);
+    }
 
+    last_pressed = pressed;
+}
+#else
 /**
  * Get the current position and state of the touchpad
  * @param data store the read data here
@@ -188,9 +403,9 @@ void xpt2046_read(lv_indev_t * indev, lv_indev_data_t * data)
     static int16_t last_y = 0;
     static bool last_pressed = false;
 
-    bool pressed = (LV_DRV_INDEV_IRQ_READ == 0);
+    bool pressed = false;
 
-    if (pressed) {
+    if (LV_DRV_INDEV_IRQ_READ == 0) {
         LV_DRV_INDEV_SPI_CS(0);
 
         LV_DRV_INDEV_SPI_XCHG_BYTE(CMD_X_READ);
@@ -201,20 +416,43 @@ void xpt2046_read(lv_indev_t * indev, lv_indev_data_t * data)
 
         buf = LV_DRV_INDEV_SPI_XCHG_BYTE(0);
         int16_t y = buf << 8;
-        buf = LV_DRV_INDEV_SPI_XCHG_BYTE(0);
+        buf = LV_DRV_INDEV_SPI_XCHG_BYTE(CMD_Z1_READ);
         y += buf;
 
+        buf = LV_DRV_INDEV_SPI_XCHG_BYTE(0);
+        uint16_t z1 = buf << 8;
+        buf = LV_DRV_INDEV_SPI_XCHG_BYTE(CMD_Z2_READ);
+        z1 += buf;
+
+        buf = LV_DRV_INDEV_SPI_XCHG_BYTE(0);
+        uint16_t z2 = buf << 8;
+        buf = LV_DRV_INDEV_SPI_XCHG_BYTE(0);
+        z2 += buf;
+
         LV_DRV_INDEV_SPI_CS(1);
 
         x >>= 3;
         y >>= 3;
-
-        xpt2046_corr(&x, &y);
-        xpt2046_avg(&x, &y);
-
-        last_x = x;
-        last_y = y;
+        z1 >>= 3;
+        z2 >>= 3;
+
+        /*PENIRQ also fires on a grazing touch, the pressure decides*/
+        pressed = touch_press_update(&press, touch_resistance(x, z1, z2, XPT2046_RX_PLATE));
+        if (pressed) {
+            touch_mean_push(&mean, &x, &y);
+            raw_x = x;
+            raw_y = y;
+            touch_cal_apply(&cal, &x, &y);
+
+            last_x = x;
+            last_y = y;
+        }
     }
+    else {
+        press.down = false;
+    }
+
+    if (!pressed && last_pressed) touch_mean_reset(&mean);
 
     data->point.x = last_x;
     data->point.y = last_y;
@@ -232,6 +470,7 @@ void xpt2046_read(lv_indev_t * indev, lv_indev_data_t * data)
 
     last_pressed = pressed;
 }
+#endif
 
 
 
@@ -239,66 +478,233 @@ void xpt2046_read(lv_indev_t * indev, lv_indev_data_t * data)
 /**********************
  *   STATIC FUNCTIONS
  **********************/
-static void xpt2046_corr(int16_t * x, int16_t * y)
+/**
+ * The matrix of the compile time range: XPT2046_X_MIN..XPT2046_X_MAX maps
+ * to 0..XPT2046_HOR_RES (Y alike), after XPT2046_XY_SWAP and before
+ * XPT2046_X_INV/Y_INV. Used until a calibration is loaded.
+ */
+static void xpt2046_cal_default(touch_cal_t * c)
 {
+    /*Corners of the range in the (swapped) raw space and their screen points*/
+    touch_cal_point_t p[3] = {
+        {XPT2046_X_MIN, XPT2046_Y_MIN, 0, 0},
+        {XPT2046_X_MAX, XPT2046_Y_MIN, XPT2046_HOR_RES, 0},
+        {XPT2046_X_MIN, XPT2046_Y_MAX, 0, XPT2046_VER_RES},
+    };
+    uint8_t i;
+
+    for(i = 0; i < 3; i++) {
 #if XPT2046_XY_SWAP != 0
-    int16_t swap_tmp;
-    swap_tmp = *x;
-    *x = *y;
-    *y = swap_tmp;
+        int16_t t = p[i].raw_x;
+        p[i].raw_x = p[i].raw_y;
+        p[i].raw_y = t;
 #endif
+#if XPT2046_X_INV != 0
+        p[i].x = XPT2046_HOR_RES - p[i].x;
+#endif
+#if XPT2046_Y_INV != 0
+        p[i].y = XPT2046_VER_RES - p[i].y;
+#endif
+    }
 
-    if((*x) > XPT2046_X_MIN)
-    	(*x) -= XPT2046_X_MIN;
-    else(*x) = 0;
-
-    if((*y) > XPT2046_Y_MIN)
-    	(*y) -= XPT2046_Y_MIN;
-    else
-    	(*y) = 0;
+    touch_cal_solve(c, p, 3);
+}
 
-    (*x) = (uint32_t)((uint32_t)(*x) * XPT2046_HOR_RES) /
-           (XPT2046_X_MAX - XPT2046_X_MIN);
+/**
+ * SPI1 BR bits for the fastest rate that is not above the one at boot
+ */
+static uint32_t xpt2046_spi_br(void)
+{
+    uint32_t pclk2 = HAL_RCC_GetPCLK2Freq();
+    uint32_t br = 0;
 
-    (*y) = (uint32_t)((uint32_t)(*y) * XPT2046_VER_RES) /
-           (XPT2046_Y_MAX - XPT2046_Y_MIN);
+    /*The prescaler is 2 << br*/
+    while(br < 7 && (pclk2 >> (br + 1)) > spi_hz) br++;
 
-#if XPT2046_X_INV != 0
-    (*x) =  XPT2046_HOR_RES - (*x);
-#endif
+    return br << SPI_CR1_BR_Pos;
+}
 
-#if XPT2046_Y_INV != 0
-    (*y) =  XPT2046_VER_RES - (*y);
-#endif
+#if USE_TSC_PENIRQ
+/**
+ * Queue a release (z = 0) if the pen is up, otherwise start a burst.
+ * Runs in interrupt context.
+ */
+static void xpt2046_sample(void)
+{
+    touch_sample_t s;
+
+    /*The previous burst is still running*/
+    if(burst_busy) return;
+
+    if(LV_DRV_INDEV_IRQ_READ != 0) {
+        /*Only a touch that was reported needs a release*/
+        if(press.down) {
+            s.x = 0;
+            s.y = 0;
+            s.z = 0;
+            s.tick = HAL_GetTick();
+            touch_ring_push(&ring, &s);
+            press.down = false;
+        }
+        sampler_stop();
+        return;
+    }
 
+    burst_busy = true;
+    MODIFY_REG(SPI1->CR1, SPI_CR1_BR, spi_br);
+    LV_DRV_INDEV_SPI_CS(0);
+    if(HAL_SPI_TransmitReceive_DMA(&hspi1, xpt2046_burst_tx, xpt2046_burst_rx, BURST_LEN) != HAL_OK) {
+        LV_DRV_INDEV_SPI_CS(1);
+        burst_busy = false;
+    }
 }
 
+/**
+ * Filter a finished burst into one sample. Runs in the DMA interrupt.
+ */
+static void xpt2046_burst_done(void)
+{
+    uint16_t conv[4][XPT2046_BURST];
+    uint16_t x, y, z1, z2;
+    touch_sample_t s;
+    bool was_down = press.down;
+    uint32_t rt;
+    uint32_t i;
+
+    LV_DRV_INDEV_SPI_CS(1);
+    burst_busy = false;
+
+    /*Result i is in the 2 bytes after its command*/
+    for(i = 0; i < BURST_CONV; i++) {
+        conv[i % 4][i / 4] = ((xpt2046_burst_rx[2 * i + 1] << 8) | xpt2046_burst_rx[2 * i + 2]) >> 3;
+    }
+
+    /*A noisy burst is dropped, the next one comes after XPT2046_SAMPLE_MS*/
+    if(!touch_median(conv[0], XPT2046_BURST, XPT2046_MAX_DEV, &x)) return;
+    if(!touch_median(conv[1], XPT2046_BURST, XPT2046_MAX_DEV, &y)) return;
+    touch_median(conv[2], XPT2046_BURST, UINT16_MAX, &z1);
+    touch_median(conv[3], XPT2046_BURST, UINT16_MAX, &z2);
+
+    s.x = 0;
+    s.y = 0;
+    s.z = 0;
+    s.tick = HAL_GetTick();
+
+    /*PENIRQ also fires on a grazing touch, the pressure decides*/
+    rt = touch_resistance(x, z1, z2, XPT2046_RX_PLATE);
+    if(!touch_press_update(&press, rt)) {
+        if(was_down) touch_ring_push(&ring, &s);
+        return;
+    }
+
+    s.x = x;
+    s.y = y;
+    s.z = touch_pressure(rt);
 
-static void xpt2046_avg(int16_t * x, int16_t * y)
+    touch_ring_push(&ring, &s);
+}
+
+/**
+ * SPI1 RX on DMA2 stream 0 and TX on DMA2 stream 3, both channel 3.
+ * The command part of the burst never changes, it is written once here.
+ */
+static void xpt2046_dma_init(void)
 {
-    /*Shift out the oldest data*/
-    uint8_t i;
-    for(i = XPT2046_AVG - 1; i > 0 ; i--) {
-        avg_buf_x[i] = avg_buf_x[i - 1];
-        avg_buf_y[i] = avg_buf_y[i - 1];
+    static const uint8_t cmds[4] = {CMD_X_READ, CMD_Y_READ, CMD_Z1_READ, CMD_Z2_READ};
+    uint32_t i;
+
+    for(i = 0; i < BURST_LEN; i++) {
+        xpt2046_burst_tx[i] = (i % 2 == 0 && i / 2 < BURST_CONV) ? cmds[(i / 2) % 4] : 0;
+    }
+
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    tsc_dma_rx_handle.Instance = TSC_DMA_RX_STREAM;
+    tsc_dma_rx_handle.Init.Channel = DMA_CHANNEL_3;
+    tsc_dma_rx_handle.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    tsc_dma_rx_handle.Init.PeriphInc = DMA_PINC_DISABLE;
+    tsc_dma_rx_handle.Init.MemInc = DMA_MINC_ENABLE;
+    tsc_dma_rx_handle.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    tsc_dma_rx_handle.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    tsc_dma_rx_handle.Init.Mode = DMA_NORMAL;
+    tsc_dma_rx_handle.Init.Priority = DMA_PRIORITY_LOW;
+    tsc_dma_rx_handle.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if(HAL_DMA_Init(&tsc_dma_rx_handle) != HAL_OK) {
+        while(1);
     }
+    __HAL_LINKDMA(&hspi1, hdmarx, tsc_dma_rx_handle);
 
-    /*Insert the new point*/
-    avg_buf_x[0] = *x;
-    avg_buf_y[0] = *y;
-    if(avg_last < XPT2046_AVG) avg_last++;
-
-    /*Sum the x and y coordinates*/
-    int32_t x_sum = 0;
-    int32_t y_sum = 0;
-    for(i = 0; i < avg_last ; i++) {
-        x_sum += avg_buf_x[i];
-        y_sum += avg_buf_y[i];
+    tsc_dma_tx_handle.Instance = TSC_DMA_TX_STREAM;
+    tsc_dma_tx_handle.Init = tsc_dma_rx_handle.Init;
+    tsc_dma_tx_handle.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    if(HAL_DMA_Init(&tsc_dma_tx_handle) != HAL_OK) {
+        while(1);
     }
+    __HAL_LINKDMA(&hspi1, hdmatx, tsc_dma_tx_handle);
+
+    HAL_NVIC_SetPriority(TSC_DMA_RX_IRQn, 2, 0);
+    HAL_NVIC_EnableIRQ(TSC_DMA_RX_IRQn);
+    HAL_NVIC_SetPriority(TSC_DMA_TX_IRQn, 2, 0);
+    HAL_NVIC_EnableIRQ(TSC_DMA_TX_IRQn);
+}
 
-    /*Normalize the sums*/
-    (*x) = (int32_t)x_sum / avg_last;
-    (*y) = (int32_t)y_sum / avg_last;
+/**
+ * Run TSC_SAMPLE_TIM at 10 kHz with an update every XPT2046_SAMPLE_MS.
+ * It is started by the first touch.
+ */
+static void xpt2046_timer_init(void)
+{
+    __HAL_RCC_TIM7_CLK_ENABLE();
+    TSC_SAMPLE_TIM->CR1 = 0;
+    TSC_SAMPLE_TIM->PSC = xpt2046_timer_psc();
+    TSC_SAMPLE_TIM->ARR = XPT2046_SAMPLE_MS * 10 - 1;
+    TSC_SAMPLE_TIM->EGR = TIM_EGR_UG;   /*Load PSC*/
+    TSC_SAMPLE_TIM->SR = 0;
+    TSC_SAMPLE_TIM->DIER = TIM_DIER_UIE;
+
+    HAL_NVIC_SetPriority(TSC_SAMPLE_TIM_IRQn, 2, 0);
+    HAL_NVIC_EnableIRQ(TSC_SAMPLE_TIM_IRQn);
 }
 
+/**
+ * Prescaler for 10 kHz from the current APB1 timer clock
+ */
+static uint32_t xpt2046_timer_psc(void)
+{
+    uint32_t clk = HAL_RCC_GetPCLK1Freq();
+
+    /*The APB1 timers run at twice PCLK1 if APB1 is divided*/
+    if((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) clk *= 2;
+
+    return clk / 10000 - 1;
+}
+
+/**
+ * Mask PENIRQ, it also toggles during the conversions, and start the timer
+ */
+static void sampler_start(void)
+{
+    EXTI->IMR &= ~TSC_PENIRQ_PIN;
+    sampling = true;
+
+    TSC_SAMPLE_TIM->CNT = 0;
+    TSC_SAMPLE_TIM->CR1 |= TIM_CR1_CEN;
+}
+
+/**
+ * Stop the timer and wait for the next touch
+ */
+static void sampler_stop(void)
+{
+    TSC_SAMPLE_TIM->CR1 &= ~TIM_CR1_CEN;
+    sampling = false;
+
+    __HAL_GPIO_EXTI_CLEAR_IT(TSC_PENIRQ_PIN);
+    EXTI->IMR |= TSC_PENIRQ_PIN;
+
+    /*Touched again before the edge detection was back*/
+    if(LV_DRV_INDEV_IRQ_READ == 0) sampler_start();
+}
+#endif
+
 #endif
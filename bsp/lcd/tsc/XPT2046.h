@@ -8,6 +8,8 @@
 
 #define USE_XPT2046 1
 
+#include "config.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -31,6 +33,8 @@ extern "C" {
 #include "lvgl/lvgl.h"
 #endif
 
+#include "touch_calib.h"
+
 /*********************
  *      DEFINES
  *********************/
@@ -44,6 +48,15 @@ extern "C" {
  **********************/
 void xpt2046_init(void);
 void xpt2046_read(lv_indev_t * indev, lv_indev_data_t * data);
+void xpt2046_set_pressure(uint32_t press_rt, uint32_t release_rt);
+void xpt2046_set_cal(const touch_cal_t * c);
+void xpt2046_get_raw(int16_t * x, int16_t * y);
+void xpt2046_clock_update(void);
+#if USE_TSC_PENIRQ
+bool xpt2046_has_samples(void);
+void xpt2046_penirq_handler(void);
+void xpt2046_timer_irq_handler(void);
+#endif
 
 /**********************
  *      MACROS
@@ -0,0 +1,157 @@
+/**
+ * @file touch_cal_flash.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "touch_cal_flash.h"
+#include "hw_def.h"
+
+#include <stddef.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define CAL_MAGIC       0x4C414354UL    /*"TCAL"*/
+#define CAL_ERASED      0xFFFFFFFFUL
+
+#define CAL_WORDS       (sizeof(cal_record_t) / 4)
+#define CAL_SLOTS       (TSC_CAL_FLASH_SIZE / sizeof(cal_record_t))
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint32_t magic;
+    touch_cal_t cal;
+    uint32_t check;
+} cal_record_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t cal_check(const touch_cal_t * cal);
+static bool slot_erased(const cal_record_t * rec);
+static bool cal_program(uint32_t addr, const uint32_t * w);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Read the last saved calibration
+ * @param cal store the matrix here
+ * @return false if none was saved yet
+ */
+bool touch_cal_load(touch_cal_t * cal)
+{
+    const cal_record_t * rec = (const cal_record_t *)TSC_CAL_FLASH_ADDR;
+    const cal_record_t * last = NULL;
+    uint32_t i;
+
+    for(i = 0; i < CAL_SLOTS; i++, rec++) {
+        if(slot_erased(rec)) break;
+
+        /*Skip a record that a reset cut short*/
+        if(rec->magic == CAL_MAGIC && rec->check == cal_check(&rec->cal)) last = rec;
+    }
+
+    if(last == NULL) return false;
+
+    *cal = last->cal;
+    return true;
+}
+
+/**
+ * Append the calibration to the flash sector. Erasing the full sector
+ * stalls the CPU for about a second, it happens once every CAL_SLOTS saves.
+ * @param cal the matrix
+ * @return false if the flash couldn't be written
+ */
+bool touch_cal_save(const touch_cal_t * cal)
+{
+    const cal_record_t * slot = (const cal_record_t *)TSC_CAL_FLASH_ADDR;
+    cal_record_t rec;
+    uint32_t i;
+    bool ok;
+
+    /*First slot that was not written since the last erase*/
+    for(i = 0; i < CAL_SLOTS; i++, slot++) {
+        if(slot_erased(slot)) break;
+    }
+
+    rec.magic = CAL_MAGIC;
+    rec.cal = *cal;
+    rec.check = cal_check(cal);
+
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR |
+                           FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR);
+
+    if(i == CAL_SLOTS) {
+        FLASH_EraseInitTypeDef erase = {0};
+        uint32_t bad_sector;
+
+        erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+        erase.Sector = TSC_CAL_FLASH_SECTOR;
+        erase.NbSectors = 1;
+        erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+        if(HAL_FLASHEx_Erase(&erase, &bad_sector) != HAL_OK) {
+            HAL_FLASH_Lock();
+            return false;
+        }
+        i = 0;
+    }
+
+    ok = cal_program(TSC_CAL_FLASH_ADDR + i * sizeof(cal_record_t), (const uint32_t *)&rec);
+    HAL_FLASH_Lock();
+
+    return ok;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static uint32_t cal_check(const touch_cal_t * cal)
+{
+    const uint32_t * w = (const uint32_t *)cal;
+    uint32_t sum = CAL_MAGIC;
+    uint32_t i;
+
+    for(i = 0; i < sizeof(touch_cal_t) / 4; i++) {
+        sum = ((sum << 5) | (sum >> 27)) ^ w[i];
+    }
+
+    /*An erased check word never matches*/
+    return sum == CAL_ERASED ? 0 : sum;
+}
+
+static bool slot_erased(const cal_record_t * rec)
+{
+    const uint32_t * w = (const uint32_t *)rec;
+    uint32_t i;
+
+    for(i = 0; i < CAL_WORDS; i++) {
+        if(w[i] != CAL_ERASED) return false;
+    }
+
+    return true;
+}
+
+/**
+ * Program one record. The magic goes last, so an interrupted write leaves
+ * a slot that touch_cal_load() skips.
+ */
+static bool cal_program(uint32_t addr, const uint32_t * w)
+{
+    uint32_t i;
+
+    for(i = 1; i < CAL_WORDS; i++) {
+        if(HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, addr + i * 4, w[i]) != HAL_OK) return false;
+    }
+
+    return HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, addr, w[0]) == HAL_OK;
+}
@@ -0,0 +1,44 @@
+/**
+ * @file touch_cal_flash.h
+ *
+ * Touch calibration matrix kept in its own flash sector. Every save appends
+ * a record, the sector is erased only when it is full. The last valid record
+ * is the current calibration.
+ */
+
+#ifndef TOUCH_CAL_FLASH_H
+#define TOUCH_CAL_FLASH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include "touch_calib.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+bool touch_cal_load(touch_cal_t * cal);
+bool touch_cal_save(const touch_cal_t * cal);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TOUCH_CAL_FLASH_H */
@@ -0,0 +1,108 @@
+/**
+ * @file touch_calib.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "touch_calib.h"
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static double det3(const double m[3][3]);
+static bool solve3(const double m[3][3], const double r[3], double out[3]);
+static int32_t to_fixed(double v);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Fit the affine matrix to the calibration points. 3 points give the exact
+ * solution, more points the least squares one. Runs once per calibration,
+ * so it is done in double precision.
+ * @param cal the resulting matrix
+ * @param p the calibration points
+ * @param n number of points, at least 3
+ * @return false if the points don't define a mapping (e.g. on one line)
+ */
+bool touch_cal_solve(touch_cal_t * cal, const touch_cal_point_t * p, uint8_t n)
+{
+    double m[3][3] = {{0}};
+    double rx[3] = {0};
+    double ry[3] = {0};
+    double abc[3];
+    double def[3];
+    uint8_t i;
+
+    if(n < 3) return false;
+
+    /*Normal equations of [raw_x raw_y 1] * [a b c]' = x, same for y*/
+    for(i = 0; i < n; i++) {
+        double v[3] = {p[i].raw_x, p[i].raw_y, 1.0};
+        uint8_t r, c;
+
+        for(r = 0; r < 3; r++) {
+            for(c = 0; c < 3; c++) m[r][c] += v[r] * v[c];
+            rx[r] += v[r] * p[i].x;
+            ry[r] += v[r] * p[i].y;
+        }
+    }
+
+    if(!solve3(m, rx, abc) || !solve3(m, ry, def)) return false;
+
+    cal->a = to_fixed(abc[0]);
+    cal->b = to_fixed(abc[1]);
+    cal->d = to_fixed(def[0]);
+    cal->e = to_fixed(def[1]);
+
+    /*Half a pixel, so the shift in touch_cal_apply() rounds*/
+    cal->c = to_fixed(abc[2] + 0.5);
+    cal->f = to_fixed(def[2] + 0.5);
+
+    return true;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static double det3(const double m[3][3])
+{
+    return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+           m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+           m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+}
+
+/**
+ * Cramer's rule
+ */
+static bool solve3(const double m[3][3], const double r[3], double out[3])
+{
+    double d = det3(m);
+    uint8_t col, i;
+
+    /*The matrix scales with the squared raw range, anything this small is degenerate*/
+    if(d > -1e-3 && d < 1e-3) return false;
+
+    for(col = 0; col < 3; col++) {
+        double t[3][3];
+        for(i = 0; i < 3; i++) {
+            t[i][0] = m[i][0];
+            t[i][1] = m[i][1];
+            t[i][2] = m[i][2];
+            t[i][col] = r[i];
+        }
+        out[col] = det3(t) / d;
+    }
+
+    return true;
+}
+
+static int32_t to_fixed(double v)
+{
+    v *= (double)(1L << TOUCH_CAL_SHIFT);
+    return (int32_t)(v >= 0 ? v + 0.5 : v - 0.5);
+}
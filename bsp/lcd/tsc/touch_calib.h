@@ -0,0 +1,72 @@
+/**
+ * @file touch_calib.h
+ *
+ * Affine raw-to-screen mapping of the touch panel. The matrix is solved once
+ * from 3 or more calibration points (least squares above 3) and applied as a
+ * fixed-point multiply-shift, without a division. No hardware access.
+ */
+
+#ifndef TOUCH_CALIB_H
+#define TOUCH_CALIB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TOUCH_CAL_SHIFT     16      /*Fraction bits of the matrix*/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/*x' = (a * x + b * y + c) >> TOUCH_CAL_SHIFT
+ *y' = (d * x + e * y + f) >> TOUCH_CAL_SHIFT*/
+typedef struct {
+    int32_t a, b, c;
+    int32_t d, e, f;
+} touch_cal_t;
+
+typedef struct {
+    int16_t raw_x;          /*Controller reading*/
+    int16_t raw_y;
+    int16_t x;              /*Screen point that was touched*/
+    int16_t y;
+} touch_cal_point_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+bool touch_cal_solve(touch_cal_t * cal, const touch_cal_point_t * p, uint8_t n);
+
+/**
+ * Map a raw reading to the screen
+ * @param cal the matrix
+ * @param x raw x, screen x on return
+ * @param y raw y, screen y on return
+ */
+static inline void touch_cal_apply(const touch_cal_t * cal, int16_t * x, int16_t * y)
+{
+    int32_t rx = *x;
+    int32_t ry = *y;
+
+    *x = (int16_t)((cal->a * rx + cal->b * ry + cal->c) >> TOUCH_CAL_SHIFT);
+    *y = (int16_t)((cal->d * rx + cal->e * ry + cal->f) >> TOUCH_CAL_SHIFT);
+}
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TOUCH_CALIB_H */
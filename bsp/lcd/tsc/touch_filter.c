@@ -0,0 +1,332 @@
+/**
+ * @file touch_filter.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "touch_filter.h"
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Median of a burst of conversions. The burst is rejected if the majority
+ * of the values isn't close to the median, e.g. while the pen settles or lifts.
+ * @param v the conversions, sorted in place
+ * @param n number of conversions
+ * @param max_dev largest distance from the median that still counts as agreeing
+ * @param out the median
+ * @return false if the burst is too noisy, `out` is not written then
+ */
+bool touch_median(uint16_t * v, uint8_t n, uint16_t max_dev, uint16_t * out)
+{
+    uint16_t med;
+    uint8_t agree = 0;
+    uint8_t i, j;
+
+    if(n == 0) return false;
+
+    /*Insertion sort, n is small*/
+    for(i = 1; i < n; i++) {
+        uint16_t tmp = v[i];
+        for(j = i; j > 0 && v[j - 1] > tmp; j--) {
+            v[j] = v[j - 1];
+        }
+        v[j] = tmp;
+    }
+
+    med = v[n / 2];
+    for(i = 0; i < n; i++) {
+        uint16_t d = v[i] > med ? v[i] - med : med - v[i];
+        if(d <= max_dev) agree++;
+    }
+
+    if(agree <= n / 2) return false;
+
+    *out = med;
+    return true;
+}
+
+/**
+ * Set up a running mean
+ * @param m the filter
+ * @param len number of points to average, at most TOUCH_MEAN_MAX
+ */
+void touch_mean_init(touch_mean_t * m, uint8_t len)
+{
+    if(len == 0) len = 1;
+    if(len > TOUCH_MEAN_MAX) len = TOUCH_MEAN_MAX;
+
+    m->len = len;
+    touch_mean_reset(m);
+}
+
+/**
+ * Forget the averaged points, e.g. when the pen is lifted
+ * @param m the filter
+ */
+void touch_mean_reset(touch_mean_t * m)
+{
+    m->sum_x = 0;
+    m->sum_y = 0;
+    m->idx = 0;
+    m->cnt = 0;
+}
+
+/**
+ * Add a point and replace it with the mean of the last points.
+ * The oldest point leaves the sums, so the cost doesn't grow with the length.
+ * @param m the filter
+ * @param x the new x, the mean on return
+ * @param y the new y, the mean on return
+ */
+void touch_mean_push(touch_mean_t * m, int16_t * x, int16_t * y)
+{
+    if(m->cnt == m->len) {
+        m->sum_x -= m->x[m->idx];
+        m->sum_y -= m->y[m->idx];
+    }
+    else {
+        m->cnt++;
+    }
+
+    m->x[m->idx] = *x;
+    m->y[m->idx] = *y;
+    m->sum_x += *x;
+    m->sum_y += *y;
+
+    m->idx++;
+    if(m->idx == m->len) m->idx = 0;
+
+    *x = (int16_t)(m->sum_x / m->cnt);
+    *y = (int16_t)(m->sum_y / m->cnt);
+}
+
+/**
+ * Touch resistance from a 12-bit X position and the Z1/Z2 conversions
+ * (XPT2046 datasheet: Rx-plate * X / 4096 * (Z2 / Z1 - 1)).
+ * The harder the press, the lower the resistance.
+ * @param x raw X conversion
+ * @param z1 raw Z1 conversion
+ * @param z2 raw Z2 conversion
+ * @param rx_plate resistance of the X plate in ohms
+ * @return touch resistance in ohms, UINT32_MAX if there is no contact
+ */
+uint32_t touch_resistance(uint16_t x, uint16_t z1, uint16_t z2, uint16_t rx_plate)
+{
+    if(z1 == 0) return UINT32_MAX;
+    if(z2 <= z1) return 0;
+
+    /*Split the / 4096 so the product fits into 32 bits*/
+    return ((((uint32_t)rx_plate * x) >> 4) * (uint32_t)(z2 - z1) / z1) >> 8;
+}
+
+/**
+ * Map a touch resistance to a pressure
+ * @param rt touch resistance in ohms
+ * @return pressure, higher is harder, never 0
+ */
+uint16_t touch_pressure(uint32_t rt)
+{
+    if(rt >= UINT16_MAX - 1) return 1;
+    return (uint16_t)(UINT16_MAX - rt);
+}
+
+/**
+ * Set up the press detection
+ * @param p the detector
+ * @param press_rt pressed below this touch resistance
+ * @param release_rt released above this touch resistance
+ */
+void touch_press_init(touch_press_t * p, uint32_t press_rt, uint32_t release_rt)
+{
+    p->press_rt = press_rt;
+    p->release_rt = release_rt < press_rt ? press_rt : release_rt;
+    p->down = false;
+}
+
+/**
+ * Feed a touch resistance. Between the two thresholds the state is kept,
+ * so a touch near the threshold doesn't chatter.
+ * @param p the detector
+ * @param rt touch resistance in ohms
+ * @return true while pressed
+ */
+bool touch_press_update(touch_press_t * p, uint32_t rt)
+{
+    if(p->down) {
+        if(rt > p->release_rt) p->down = false;
+    }
+    else {
+        if(rt < p->press_rt) p->down = true;
+    }
+
+    return p->down;
+}
+
+#if TOUCH_FILTER_TEST
+
+#include "debug_test.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TEST_BURST      5       /*XPT2046_BURST*/
+#define TEST_MAX_DEV    24      /*XPT2046_MAX_DEV*/
+#define TEST_UNSET      0xBEEF  /*touch_median() didn't write the result*/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint16_t conv[TEST_BURST];  /*12-bit conversions of one burst, as read*/
+    uint16_t median;            /*Expected result, TEST_UNSET: rejected*/
+} test_burst_t;
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+/*Bursts of X conversions shaped like the XPT2046 ones*/
+static const test_burst_t test_bursts[] = {
+    /*Steady press, a few LSB of noise*/
+    {{2051, 2047, 2049, 2050, 2046}, 2049},
+    /*A single spike doesn't move the median*/
+    {{2048, 2050, 3990, 2047, 2049}, 2049},
+    /*Two spikes on the same side, the rest still agrees*/
+    {{2048, 2050, 3990, 3987, 2049}, 2050},
+    /*Spikes on both sides*/
+    {{2048, 12, 2049, 4095, 2047}, 2048},
+    /*The pen settles: the conversions still slide*/
+    {{3120, 2790, 2460, 2210, 2080}, TEST_UNSET},
+    /*The pen lifts: the plate floats*/
+    {{2049, 2612, 3380, 4095, 1204}, TEST_UNSET},
+    /*Exactly TEST_MAX_DEV off still counts as close*/
+    {{1000, 1024, 1024, 1048, 976}, 1024},
+    /*Only two are within TEST_MAX_DEV, one LSB too far for the others*/
+    {{1000, 1024, 1049, 1050, 998}, TEST_UNSET},
+};
+
+/*X of a drag with ADC jitter, a jump and a press on the left edge*/
+static const int16_t test_drag_x[] = {
+    100, 104, 98, 102, 110, 117, 121, 130, 128, 141, 150, 149,
+    230, 232, 229, 231, 0, 1, 0, 2, -1, 0, 3, 1,
+};
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static uint32_t test_median(void)
+{
+    uint16_t v[TEST_BURST];
+    uint16_t out;
+    uint32_t i, j;
+
+    for(i = 0; i < sizeof(test_bursts) / sizeof(test_bursts[0]); i++) {
+        for(j = 0; j < TEST_BURST; j++) v[j] = test_bursts[i].conv[j];
+
+        out = TEST_UNSET;
+        TEST_CHECK(touch_median(v, TEST_BURST, TEST_MAX_DEV, &out) == (test_bursts[i].median != TEST_UNSET));
+        TEST_CHECK(out == test_bursts[i].median);
+
+        /*Sorted in place*/
+        for(j = 1; j < TEST_BURST; j++) TEST_CHECK(v[j - 1] <= v[j]);
+    }
+
+    /*Z1/Z2 are never rejected*/
+    for(j = 0; j < TEST_BURST; j++) v[j] = test_bursts[5].conv[j];
+    TEST_CHECK(touch_median(v, TEST_BURST, UINT16_MAX, &out) && out == 2612);
+
+    /*Degenerate bursts*/
+    out = TEST_UNSET;
+    TEST_CHECK(!touch_median(v, 0, TEST_MAX_DEV, &out) && out == TEST_UNSET);
+    v[0] = 77;
+    TEST_CHECK(touch_median(v, 1, 0, &out) && out == 77);
+    v[0] = 10;
+    v[1] = 500;
+    TEST_CHECK(!touch_median(v, 2, TEST_MAX_DEV, &out));
+
+    return 0;
+}
+
+/*Runs the drag through a mean of len points and compares every output
+ *with the mean recomputed from the trace*/
+static uint32_t test_mean_len(uint8_t len, uint8_t expected_len)
+{
+    touch_mean_t m;
+    uint32_t n = sizeof(test_drag_x) / sizeof(test_drag_x[0]);
+    uint32_t i, j, from;
+    int32_t sum, sum_win;
+    int16_t x, y;
+
+    touch_mean_init(&m, len);
+    TEST_CHECK(m.len == expected_len);
+
+    for(i = 0; i < n; i++) {
+        x = test_drag_x[i];
+        y = (int16_t)(-test_drag_x[i]);
+        touch_mean_push(&m, &x, &y);
+
+        from = i + 1 >= expected_len ? i + 1 - expected_len : 0;
+        sum = 0;
+        for(j = from; j <= i; j++) sum += test_drag_x[j];
+        TEST_CHECK(x == (int16_t)(sum / (int32_t)(i + 1 - from)));
+        TEST_CHECK(y == (int16_t)(-sum / (int32_t)(i + 1 - from)));
+
+        /*The running sums match the window, nothing drifts as it wraps*/
+        TEST_CHECK(m.cnt == i + 1 - from);
+        sum_win = 0;
+        for(j = 0; j < m.cnt; j++) sum_win += m.x[j];
+        TEST_CHECK(m.sum_x == sum_win && m.sum_x == sum && m.sum_y == -sum);
+    }
+
+    /*Lifted: the next press starts from its own first point*/
+    touch_mean_reset(&m);
+    x = 300;
+    y = 40;
+    touch_mean_push(&m, &x, &y);
+    TEST_CHECK(x == 300 && y == 40 && m.cnt == 1);
+
+    return 0;
+}
+
+static uint32_t test_mean(void)
+{
+    uint32_t line;
+    uint8_t len;
+
+    for(len = 1; len <= TOUCH_MEAN_MAX; len++) {
+        line = test_mean_len(len, len);
+        if(line) return line;
+    }
+
+    /*Out of range lengths are clamped*/
+    line = test_mean_len(0, 1);
+    if(line == 0) line = test_mean_len(TOUCH_MEAN_MAX + 1, TOUCH_MEAN_MAX);
+
+    return line;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Run raw conversion bursts through the median and outlier rejection and a
+ * drag trace through the running mean of every length
+ * @return 0 if all checks passed, else the line of the first failed one
+ */
+uint32_t touch_filter_test(void)
+{
+    uint32_t line;
+
+    line = test_median();
+    if(line == 0) line = test_mean();
+
+    return line;
+}
+
+#endif /*TOUCH_FILTER_TEST*/
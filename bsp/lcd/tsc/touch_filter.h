@@ -0,0 +1,75 @@
+/**
+ * @file touch_filter.h
+ *
+ * Filter stages of the touch samples: median with outlier rejection over
+ * one burst of conversions, pressure threshold with hysteresis, then a
+ * running mean over the last points.
+ * No hardware access, so they can be fed with recorded raw traces on the host.
+ */
+
+#ifndef TOUCH_FILTER_H
+#define TOUCH_FILTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TOUCH_MEAN_MAX      8       /*Longest running mean*/
+
+/*1: touch_filter_test() is built, it runs raw traces through the filters*/
+#ifndef TOUCH_FILTER_TEST
+#define TOUCH_FILTER_TEST   0
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    int16_t x[TOUCH_MEAN_MAX];
+    int16_t y[TOUCH_MEAN_MAX];
+    int32_t sum_x;
+    int32_t sum_y;
+    uint8_t len;            /*Points averaged once the window is full*/
+    uint8_t idx;            /*Slot of the next point*/
+    uint8_t cnt;            /*Points in the window*/
+} touch_mean_t;
+
+typedef struct {
+    uint32_t press_rt;      /*Pressed once the touch resistance drops below this*/
+    uint32_t release_rt;    /*Released once it rises above this, >= press_rt*/
+    bool down;
+} touch_press_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+bool touch_median(uint16_t * v, uint8_t n, uint16_t max_dev, uint16_t * out);
+void touch_mean_init(touch_mean_t * m, uint8_t len);
+void touch_mean_reset(touch_mean_t * m);
+void touch_mean_push(touch_mean_t * m, int16_t * x, int16_t * y);
+uint32_t touch_resistance(uint16_t x, uint16_t z1, uint16_t z2, uint16_t rx_plate);
+uint16_t touch_pressure(uint32_t rt);
+void touch_press_init(touch_press_t * p, uint32_t press_rt, uint32_t release_rt);
+bool touch_press_update(touch_press_t * p, uint32_t rt);
+#if TOUCH_FILTER_TEST
+uint32_t touch_filter_test(void);
+#endif
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TOUCH_FILTER_H */
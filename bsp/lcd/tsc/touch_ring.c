@@ -0,0 +1,245 @@
+/**
+ * @file touch_ring.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stddef.h>
+#include "touch_ring.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#if (TOUCH_RING_SIZE & (TOUCH_RING_SIZE - 1)) != 0
+#error "TOUCH_RING_SIZE must be a power of 2"
+#endif
+
+/*The indexes run freely, the mask maps them into the buffer*/
+#define RING_MASK   (TOUCH_RING_SIZE - 1)
+
+/*Keeps the compiler from moving the sample copy across the index update.
+ *Producer and consumer run on the same core, no hardware barrier needed.*/
+#if defined(__GNUC__)
+#define RING_BARRIER()  __asm volatile("" ::: "memory")
+#else
+#define RING_BARRIER()
+#endif
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Empty the ring. Not safe while the producer runs.
+ * @param r the ring
+ */
+void touch_ring_init(touch_ring_t * r)
+{
+    r->head = 0;
+    r->tail = 0;
+    r->dropped = 0;
+}
+
+/**
+ * Add a sample, called by the producer only
+ * @param r the ring
+ * @param s the sample to copy in
+ * @return false if the ring was full and the sample was dropped
+ */
+bool touch_ring_push(touch_ring_t * r, const touch_sample_t * s)
+{
+    uint32_t head = r->head;
+
+    if(head - r->tail >= TOUCH_RING_SIZE) {
+        r->dropped++;
+        return false;
+    }
+
+    r->buf[head & RING_MASK] = *s;
+    RING_BARRIER();
+    r->head = head + 1;
+
+    return true;
+}
+
+/**
+ * Read the oldest sample without removing it, called by the consumer only
+ * @param r the ring
+ * @param s destination
+ * @return false if the ring is empty
+ */
+bool touch_ring_peek(const touch_ring_t * r, touch_sample_t * s)
+{
+    uint32_t tail = r->tail;
+
+    if(r->head == tail) return false;
+
+    RING_BARRIER();
+    *s = r->buf[tail & RING_MASK];
+
+    return true;
+}
+
+/**
+ * Remove the oldest sample, called by the consumer only
+ * @param r the ring
+ * @param s destination, can be NULL to just drop the sample
+ * @return false if the ring is empty
+ */
+bool touch_ring_pop(touch_ring_t * r, touch_sample_t * s)
+{
+    uint32_t tail = r->tail;
+
+    if(r->head == tail) return false;
+
+    RING_BARRIER();
+    if(s) *s = r->buf[tail & RING_MASK];
+    RING_BARRIER();
+    r->tail = tail + 1;
+
+    return true;
+}
+
+/**
+ * Number of samples waiting
+ * @param r the ring
+ * @return samples that can be popped
+ */
+uint32_t touch_ring_count(const touch_ring_t * r)
+{
+    return r->head - r->tail;
+}
+
+#if TOUCH_RING_TEST
+
+#include "debug_test.h"
+
+/*Samples are numbered, x is the sequence number and y its complement*/
+static void test_sample(touch_sample_t * s, uint32_t seq)
+{
+    s->x = (int16_t)seq;
+    s->y = (int16_t)~seq;
+    s->z = (uint16_t)(seq + 1);
+    s->tick = seq;
+}
+
+static bool test_is_sample(const touch_sample_t * s, uint32_t seq)
+{
+    touch_sample_t e;
+
+    test_sample(&e, seq);
+    return s->x == e.x && s->y == e.y && s->z == e.z && s->tick == e.tick;
+}
+
+/*Runs the ring from the given index: empty, full, overflow and a stream
+ *of pushes and pops that moves the indexes by several turns*/
+static uint32_t touch_ring_test_run(uint32_t base)
+{
+    touch_ring_t r;
+    touch_sample_t s;
+    uint32_t i, pushed, popped;
+
+    touch_ring_init(&r);
+    r.head = base;
+    r.tail = base;
+
+    /*Empty: nothing to read, the indexes don't move*/
+    TEST_CHECK(touch_ring_count(&r) == 0);
+    TEST_CHECK(!touch_ring_peek(&r, &s));
+    TEST_CHECK(!touch_ring_pop(&r, &s));
+    TEST_CHECK(!touch_ring_pop(&r, NULL));
+    TEST_CHECK(r.head == base && r.tail == base);
+
+    /*Fill up to the last free slot*/
+    for(i = 0; i < TOUCH_RING_SIZE; i++) {
+        test_sample(&s, i);
+        TEST_CHECK(touch_ring_push(&r, &s));
+        TEST_CHECK(touch_ring_count(&r) == i + 1);
+    }
+    TEST_CHECK(r.dropped == 0);
+
+    /*Full: the new samples are dropped and counted, the stored ones stay*/
+    test_sample(&s, 1000);
+    TEST_CHECK(!touch_ring_push(&r, &s));
+    TEST_CHECK(!touch_ring_push(&r, &s));
+    TEST_CHECK(r.dropped == 2);
+    TEST_CHECK(touch_ring_count(&r) == TOUCH_RING_SIZE);
+
+    /*Peek returns the oldest and leaves it in*/
+    TEST_CHECK(touch_ring_peek(&r, &s) && test_is_sample(&s, 0));
+    TEST_CHECK(touch_ring_peek(&r, &s) && test_is_sample(&s, 0));
+    TEST_CHECK(touch_ring_count(&r) == TOUCH_RING_SIZE);
+
+    /*Pop with NULL drops the oldest, one slot is free again*/
+    TEST_CHECK(touch_ring_pop(&r, NULL));
+    TEST_CHECK(touch_ring_count(&r) == TOUCH_RING_SIZE - 1);
+    test_sample(&s, TOUCH_RING_SIZE);
+    TEST_CHECK(touch_ring_push(&r, &s));
+    TEST_CHECK(!touch_ring_push(&r, &s));
+    TEST_CHECK(r.dropped == 3);
+
+    /*Drain in order, the dropped samples never show up*/
+    for(i = 1; i <= TOUCH_RING_SIZE; i++) {
+        TEST_CHECK(touch_ring_pop(&r, &s) && test_is_sample(&s, i));
+    }
+    TEST_CHECK(touch_ring_count(&r) == 0);
+    TEST_CHECK(!touch_ring_peek(&r, &s));
+    TEST_CHECK(!touch_ring_pop(&r, &s));
+    TEST_CHECK(r.head == base + TOUCH_RING_SIZE + 1 && r.tail == r.head);
+
+    /*Bursts of pushes and pops of changing sizes: the order holds and the
+     *count stays within the ring on every step*/
+    pushed = 0;
+    popped = 0;
+    for(i = 0; i < 8 * TOUCH_RING_SIZE; i++) {
+        uint32_t burst = (i * 3U) % (TOUCH_RING_SIZE + 3);
+        while(burst--) {
+            test_sample(&s, pushed);
+            if(touch_ring_push(&r, &s)) pushed++;
+        }
+        TEST_CHECK(touch_ring_count(&r) == pushed - popped);
+        TEST_CHECK(touch_ring_count(&r) <= TOUCH_RING_SIZE);
+
+        burst = (i * 2U) % (TOUCH_RING_SIZE + 3);
+        while(burst-- && touch_ring_pop(&r, &s)) {
+            TEST_CHECK(test_is_sample(&s, popped));
+            popped++;
+        }
+        TEST_CHECK(touch_ring_count(&r) == pushed - popped);
+    }
+    while(touch_ring_pop(&r, &s)) {
+        TEST_CHECK(test_is_sample(&s, popped));
+        popped++;
+    }
+    TEST_CHECK(popped == pushed);
+    TEST_CHECK(pushed > 4 * TOUCH_RING_SIZE);
+
+    /*Init empties the ring and clears the counter*/
+    test_sample(&s, 0);
+    TEST_CHECK(touch_ring_push(&r, &s));
+    touch_ring_init(&r);
+    TEST_CHECK(touch_ring_count(&r) == 0 && r.dropped == 0);
+    TEST_CHECK(!touch_ring_pop(&r, &s));
+
+    return 0;
+}
+
+/**
+ * Check the ring from index 0 and with the free-running indexes wrapping
+ * around UINT32_MAX while it is full
+ * @return 0 if all checks passed, else the line of the first failed one
+ */
+uint32_t touch_ring_test(void)
+{
+    uint32_t line;
+
+    line = touch_ring_test_run(0);
+    if(line == 0) line = touch_ring_test_run(UINT32_MAX - TOUCH_RING_SIZE / 2);
+    if(line == 0) line = touch_ring_test_run(UINT32_MAX);
+
+    return line;
+}
+
+#endif /*TOUCH_RING_TEST*/
@@ -0,0 +1,71 @@
+/**
+ * @file touch_ring.h
+ *
+ * Single producer / single consumer ring of touch samples. The producer is
+ * the sampling interrupt, the consumer is the LVGL indev read. No hardware
+ * access, so it runs the same on the host.
+ */
+
+#ifndef TOUCH_RING_H
+#define TOUCH_RING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#ifndef TOUCH_RING_SIZE
+#define TOUCH_RING_SIZE     16      /*Samples, must be a power of 2*/
+#endif
+
+/*1: touch_ring_test() is built, it checks the ring on its edges*/
+#ifndef TOUCH_RING_TEST
+#define TOUCH_RING_TEST     0
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    int16_t x;
+    int16_t y;
+    uint16_t z;             /*Pressure (see touch_pressure()), 0: the pen was lifted*/
+    uint32_t tick;          /*Time of the sample in ms*/
+} touch_sample_t;
+
+typedef struct {
+    touch_sample_t buf[TOUCH_RING_SIZE];
+    volatile uint32_t head;     /*Written by the producer only*/
+    volatile uint32_t tail;     /*Written by the consumer only*/
+    uint32_t dropped;           /*Samples lost because the ring was full*/
+} touch_ring_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void touch_ring_init(touch_ring_t * r);
+bool touch_ring_push(touch_ring_t * r, const touch_sample_t * s);
+bool touch_ring_peek(const touch_ring_t * r, touch_sample_t * s);
+bool touch_ring_pop(touch_ring_t * r, touch_sample_t * s);
+uint32_t touch_ring_count(const touch_ring_t * r);
+#if TOUCH_RING_TEST
+uint32_t touch_ring_test(void);
+#endif
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TOUCH_RING_H */
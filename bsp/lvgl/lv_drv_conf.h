@@ -360,7 +360,7 @@
 #if USE_XPT2046
 #  define XPT2046_HOR_RES     240
 #  define XPT2046_VER_RES     320
-#  define XPT2046_X_MIN       494
+#  define XPT2046_X_MIN       494     /*Raw range, the matrix until touchpad_cal_start() calibrates*/
 #  define XPT2046_Y_MIN       327
 #  define XPT2046_X_MAX       3503
 #  define XPT2046_Y_MAX       3729
@@ -368,6 +368,12 @@
 #  define XPT2046_X_INV       1
 #  define XPT2046_Y_INV       1
 #  define XPT2046_XY_SWAP     0
+#  define XPT2046_SAMPLE_MS   5       /*Sample period while the pen is down (USE_TSC_PENIRQ)*/
+#  define XPT2046_BURST       5       /*X/Y/Z1/Z2 conversions per sample, median of them is used*/
+#  define XPT2046_MAX_DEV     24      /*Drop the sample if most X or Y conversions are further from the median*/
+#  define XPT2046_RX_PLATE    400     /*X plate resistance [ohm], see the panel's datasheet*/
+#  define XPT2046_RT_PRESS    2500    /*Pressed below this touch resistance [ohm]*/
+#  define XPT2046_RT_RELEASE  3500    /*Released above this touch resistance [ohm]*/
 #endif
 
 /*-----------------
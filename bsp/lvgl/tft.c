@@ -11,7 +11,12 @@
 #include <string.h>
 
 #include "tft.h"
+#include "tft_fill.h"
+#include "tft_scroll.h"
+#include "tft_coalesce.h"
+#include "lvgl/src/lvgl_private.h"
 #include "stm32f4xx.h"
+#include "stm32f4xx_hal.h"
 
 
 extern  lcd_handle_t lcd_handle;
@@ -19,7 +24,9 @@ extern  lcd_handle_t lcd_handle;
 /*********************
  *      DEFINES
  *********************/
-
+#if TFT_BUF_COUNT < 1 || TFT_BUF_COUNT > 2
+#error "TFT_BUF_COUNT must be 1 or 2"
+#endif
 
 /**********************
  *      TYPEDEFS
@@ -31,6 +38,14 @@ extern  lcd_handle_t lcd_handle;
 
 /*These 3 functions are needed by LittlevGL*/
 static void tft_flush(lv_display_t * drv, const lv_area_t * area, uint8_t * color_p);
+static void tft_flush_done(void);
+static void boot_probe_cb(lv_event_t *e);
+#if TFT_TE_SYNC
+static void tft_te_cb(void);
+#endif
+#if TFT_COALESCE
+static void coalesce_cb(lv_event_t *e);
+#endif
 
 /*LCD*/
 
@@ -41,6 +56,30 @@ static void tft_flush(lv_display_t * drv, const lv_area_t * area, uint8_t * colo
 
 
 static lv_display_t *display;
+static tft_buf_config_t buf_config;
+
+/* HAL tick (ms since reset) when the first complete frame reached the panel */
+static volatile uint32_t boot_first_frame_ms = 0;
+
+#if TFT_COALESCE
+static tft_cost_model_t cost_model = {
+    .window_ns = TFT_COST_WINDOW_NS,
+    .byte_ns = TFT_COST_BYTE_NS,
+    .render_px_ns = TFT_COST_RENDER_PX_NS,
+};
+#if TFT_COALESCE_LOG
+/* Decision of the last frame, logged once its bytes are counted */
+static uint32_t coalesce_areas_in;
+static uint32_t coalesce_areas_out;
+static uint32_t coalesce_bytes_separate;
+static uint32_t coalesce_bytes_estimated;
+#endif
+#endif
+
+#if TFT_TE_SYNC
+static te_sched_t te_sched;
+static bool tft_frame_open = false;     /*An area of the frame was already flushed*/
+#endif
 
 /**********************
  *      MACROS
@@ -66,32 +105,115 @@ void monitor_cb(lv_event_t *e)
     }
 }
 
+#if TFT_BUS_STATS || (TFT_COALESCE && TFT_COALESCE_LOG)
+/* Logs how the SPI traffic of the finished frame splits into window setup and pixels */
+static void bus_stats_cb(lv_event_t *e)
+{
+    lcd_bus_stats_t stats;
+    LV_UNUSED(e);
+
+    lcd_take_bus_stats(&stats);
+    if(stats.windows == 0) return;
+
+#if TFT_BUS_STATS
+    LV_LOG_USER("Frame: %lu windows, setup %lu B, payload %lu B, %lu pin writes",
+                stats.windows, stats.setup_bytes, stats.payload_bytes, stats.pin_writes);
+#endif
+#if TFT_COALESCE && TFT_COALESCE_LOG
+    LV_LOG_USER("Coalesce: %lu -> %lu areas, estimated %lu B (separate %lu B), actual %lu B",
+                coalesce_areas_in, coalesce_areas_out, coalesce_bytes_estimated,
+                coalesce_bytes_separate, stats.setup_bytes + stats.payload_bytes);
+#endif
+}
+#endif
+
+#if TFT_DIRECT_FILL && TFT_FILL_STATS
+/* Logs how many rectangle fills of the finished frame bypassed the renderer */
+static void fill_stats_cb(lv_event_t *e)
+{
+    tft_fill_stats_t stats;
+    LV_UNUSED(e);
+
+    tft_fill_take_stats(&stats);
+    if(stats.claimed || stats.passed) {
+        LV_LOG_USER("Fill: %lu claimed, %lu passed to the renderer", stats.claimed, stats.passed);
+    }
+}
+#endif
+
+#if TFT_TE_SYNC && TFT_TE_STATS
+/* Logs how long the frame waited for TE and whether it missed the window */
+static void te_stats_cb(lv_event_t *e)
+{
+    te_sched_stats_t stats;
+    LV_UNUSED(e);
+
+    tft_take_te_stats(&stats);
+    if(stats.frames) {
+        LV_LOG_USER("TE: %lu synced, %lu missed, wait %lu ms (max %lu ms)",
+                    stats.synced, stats.missed, stats.wait_total, stats.wait_max);
+    }
+}
+#endif
+
 void tft_init(void)
 {
-    uint8_t *draw_buf1;
-    uint8_t *draw_buf2;
+    tft_buf_config_t config = {
+        .buf_count = TFT_BUF_COUNT,
+        .buf_lines = TFT_BUF_LINES,
+    };
+    bool buf_ok;
 
     lcd_init();
-    draw_buf1 = (uint8_t*)lcd_get_draw_buffer1_addr();
-    draw_buf2 = (uint8_t*)lcd_get_draw_buffer2_addr();
 
     display = lv_display_create(TFT_HOR_RES, TFT_VER_RES);
 
-    // buf_size is number of pixels
-    uint32_t buf_size = (10UL * 1024UL) / 2;  // 2 bytes per pixel in RGB565
-
-    lv_display_set_buffers(display, draw_buf1, draw_buf2, buf_size, LV_DISPLAY_RENDER_MODE_PARTIAL);
-
+    // The buffer height is derived from the stride, set the color format first
     lv_display_set_color_format(display, LV_COLOR_FORMAT_RGB565);
 
+    buf_ok = tft_set_buf_config(&config);
+    LV_ASSERT_MSG(buf_ok, "TFT_BUF_COUNT/TFT_BUF_LINES don't fit into the LCD draw buffers");
+
     // Set flush callback
     lv_display_set_flush_cb(display, tft_flush);
 
+#if TFT_DIRECT_FILL
+    // Send opaque full-width fills to the panel without rasterizing them
+    tft_fill_init(display);
+#if TFT_FILL_STATS
+    lv_display_add_event_cb(display, fill_stats_cb, LV_EVENT_REFR_READY, NULL);
+#endif
+#endif
+
+#if TFT_HW_SCROLL
+    // Containers attached with tft_scroll_attach() scroll in the panel
+    tft_scroll_init(display);
+#endif
+
+#if TFT_COALESCE
+    // Runs after LVGL joined the invalidated areas, before they are rendered
+    lv_display_add_event_cb(display, coalesce_cb, LV_EVENT_RENDER_START, NULL);
+#endif
+
+#if TFT_TE_SYNC
+    te_sched_init(&te_sched, TFT_TE_WINDOW_MS, TFT_TE_TIMEOUT_MS);
+    lcd_te_enable(tft_te_cb);
+#if TFT_TE_STATS
+    lv_display_add_event_cb(display, te_stats_cb, LV_EVENT_REFR_READY, NULL);
+#endif
+#endif
+
     // Optional: attach monitor callback
     // lv_display_add_event_cb(display, monitor_cb, LV_EVENT_FLUSH_FINISH, NULL);
+#if TFT_BUS_STATS || (TFT_COALESCE && TFT_COALESCE_LOG)
+    lv_display_add_event_cb(display, bus_stats_cb, LV_EVENT_REFR_READY, NULL);
+#endif
 
     lv_display_set_rotation(display, LV_DISPLAY_ROTATION_0);
 
+    // Report the reset-to-first-frame time once, then unregister
+    lv_display_add_event_cb(display, boot_probe_cb, LV_EVENT_REFR_READY, NULL);
+
     // Store user data if needed
     lv_display_set_user_data(display, (void *)&lcd_handle);
 }
@@ -117,22 +239,368 @@ static void tft_flush(lv_display_t * disp, const lv_area_t * area, uint8_t * col
         return;
     }
 
+#if TFT_TE_SYNC
+    /* The first area of a frame starts right after the panel's vertical sync,
+     * the panel then scans out behind the write instead of through it */
+    if(!te_sched_begin(&te_sched, !tft_frame_open, HAL_GetTick())) {
+        while(!te_sched_poll(&te_sched, HAL_GetTick()));
+    }
+    tft_frame_open = !lv_display_flush_is_last(disp);
+#endif
+
+#if TFT_DIRECT_FILL
+    /* Rows claimed by the fill unit are painted directly, only the rest is sent */
+    if(tft_fill_flush(area, color_p, tft_flush_done)) return;
+#endif
+
+#if TFT_HW_SCROLL
+    /* Rows of the hardware scroll area are kept rotated in GRAM */
+    tft_scroll_write_area(area, color_p, tft_flush_done);
+#else
     int32_t act_x1 = area->x1 < 0 ? 0 : area->x1;
     int32_t act_y1 = area->y1 < 0 ? 0 : area->y1;
     int32_t act_x2 = area->x2 > TFT_HOR_RES - 1 ? TFT_HOR_RES - 1 : area->x2;
     int32_t act_y2 = area->y2 > TFT_VER_RES - 1 ? TFT_VER_RES - 1 : area->y2;
 
-    lcd_set_display_area(act_x1, act_x2, act_y1, act_y2);
-    lcd_send_cmd_mem_write();
+    lcd_set_gram_window(act_x1, act_x2, act_y1, act_y2);
 
     /* Calculate total pixels in the draw buffer */
     uint32_t width  = (area->x2 - area->x1 + 1);
     uint32_t height = (area->y2 - area->y1 + 1);
     uint32_t total_bytes = width * height * 2;  // RGB565
 
-    /* Write all pixels at once */
-    lcd_write(color_p, total_bytes);
+    /* Hand the buffer to the DMA and return, LVGL keeps rendering into the
+     * other draw buffer until tft_flush_done() releases this one */
+    lcd_write_async(color_p, total_bytes, tft_flush_done);
+#endif
+}
+
+/**
+ * Called by the LCD driver once the flushed buffer left the SPI
+ * (from the DMA interrupt in DMA IT mode)
+ */
+static void tft_flush_done(void)
+{
+    if(boot_first_frame_ms == 0 && lv_display_flush_is_last(display)) {
+        boot_first_frame_ms = HAL_GetTick();
+    }
+
+    lv_display_flush_ready(display);
+}
+
+/**
+ * Return the time from reset to the first fully flushed frame
+ * @return milliseconds, 0 until the first frame is on the panel
+ */
+uint32_t tft_get_boot_time_ms(void)
+{
+    return boot_first_frame_ms;
+}
+
+/**
+ * Change the render buffers. The buffers are carved from the LCD draw
+ * buffers and always render partially: a full frame (150 KB) doesn't fit.
+ * The screen is redrawn with the new layout.
+ * Call it outside of lv_timer_handler().
+ * @param config buffer count and lines per buffer
+ * @return false if the layout doesn't fit, the old one is kept then
+ */
+bool tft_set_buf_config(const tft_buf_config_t *config)
+{
+    uint8_t *mem = (uint8_t *)lcd_get_draw_buffer1_addr();
+    uint32_t mem_size = 2 * lcd_get_draw_buffer_size();
+    uint32_t stride = TFT_HOR_RES * 2;
+    uint32_t lines = config->buf_lines;
+    uint32_t buf_size;
+
+    if(config->buf_count < 1 || config->buf_count > 2) return false;
+
+    if(lines == 0) {
+        lines = LV_MIN(mem_size / config->buf_count / stride, TFT_VER_RES);
+    }
+
+    buf_size = lines * stride;
+    if(lines == 0 || lines > TFT_VER_RES || buf_size * config->buf_count > mem_size) return false;
+
+    /*Don't take the buffers away from a running transfer*/
+    while(lcd_is_busy());
+
+    lv_display_set_buffers(display, mem, config->buf_count == 2 ? mem + buf_size : NULL,
+                           buf_size, LV_DISPLAY_RENDER_MODE_PARTIAL);
+
+    buf_config = *config;
+    buf_config.buf_lines = lines;
+
+    lv_obj_invalidate(lv_display_get_screen_active(display));
+
+    return true;
+}
+
+/**
+ * Get the render buffer layout in use
+ * @param config destination, buf_lines is the resolved line count
+ */
+void tft_get_buf_config(tft_buf_config_t *config)
+{
+    *config = buf_config;
+}
+
+#if TFT_BUF_BENCH
+/*Every layout of the 2 * LCD_DRAW_BUF_SIZE bytes worth comparing, 0 lines: as many as fit*/
+static const tft_buf_config_t bench_layouts[] = {
+    {1, 10}, {1, 20}, {1, 0},
+    {2, 5}, {2, 10}, {2, 0},
+};
+
+static uint32_t bench_flushes;
+static uint32_t bench_wait_cycles;
+static uint32_t bench_wait_start;
+
+static void bench_event_cb(lv_event_t *e)
+{
+    switch(lv_event_get_code(e)) {
+        case LV_EVENT_FLUSH_START:
+            bench_flushes++;
+            break;
+        case LV_EVENT_FLUSH_WAIT_START:
+            bench_wait_start = DWT->CYCCNT;
+            break;
+        case LV_EVENT_FLUSH_WAIT_FINISH:
+            bench_wait_cycles += DWT->CYCCNT - bench_wait_start;
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Redraw every scene under every buffer layout and log the frame time (until
+ * the last pixel left the SPI), how much of it LVGL spent waiting for a
+ * flush, the flush count and the bytes sent. The layout in use is restored.
+ * Leave TFT_BUS_STATS at 0, it takes the byte counts too.
+ * Call it outside of lv_timer_handler().
+ * @param scenes screen states to redraw
+ * @param cnt number of scenes
+ */
+void tft_buf_bench(const tft_bench_scene_t *scenes, uint32_t cnt)
+{
+    tft_buf_config_t saved = buf_config;
+    tft_buf_config_t layout;
+    lcd_bus_stats_t stats;
+    uint32_t i, j, t0, frame_cycles;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    lv_display_add_event_cb(display, bench_event_cb, LV_EVENT_ALL, NULL);
+
+    for(i = 0; i < sizeof(bench_layouts) / sizeof(bench_layouts[0]); i++) {
+        if(!tft_set_buf_config(&bench_layouts[i])) {
+            LV_LOG_USER("Layout %u x %u lines doesn't fit", bench_layouts[i].buf_count, bench_layouts[i].buf_lines);
+            continue;
+        }
+        tft_get_buf_config(&layout);
+
+        for(j = 0; j < cnt; j++) {
+            scenes[j].show();
+            /*Settle the scene first, only the full redraw is timed*/
+            lv_refr_now(display);
+            while(lcd_is_busy());
+
+            lv_obj_invalidate(lv_display_get_screen_active(display));
+            lcd_take_bus_stats(&stats);
+            bench_flushes = 0;
+            bench_wait_cycles = 0;
+
+            t0 = DWT->CYCCNT;
+            lv_refr_now(display);
+            while(lcd_is_busy());
+            frame_cycles = DWT->CYCCNT - t0;
+
+            lcd_take_bus_stats(&stats);
+            LV_LOG_USER("Layout %u x %lu lines, %s: frame %lu us (waiting %lu us), %lu flushes, %lu B",
+                        layout.buf_count, (uint32_t)layout.buf_lines, scenes[j].name,
+                        (uint32_t)((uint64_t)frame_cycles * 1000000ULL / SystemCoreClock),
+                        (uint32_t)((uint64_t)bench_wait_cycles * 1000000ULL / SystemCoreClock),
+                        bench_flushes, stats.setup_bytes + stats.payload_bytes);
+        }
+    }
+
+    lv_display_remove_event_cb_with_user_data(display, bench_event_cb, NULL);
+    tft_set_buf_config(&saved);
+}
+#endif
+
+#if TFT_COALESCE
+/**
+ * Replace the cost model of the area coalescing
+ * @param model window, byte and render cost in ns
+ */
+void tft_set_cost_model(const tft_cost_model_t *model)
+{
+    cost_model = *model;
+}
+
+/**
+ * Get the cost model of the area coalescing
+ * @param model destination
+ */
+void tft_get_cost_model(tft_cost_model_t *model)
+{
+    *model = cost_model;
+}
+
+#if TFT_COALESCE_CALIBRATE
+/**
+ * Measure the window and byte cost on the panel with the DWT cycle counter.
+ * Writes 8 black rows at the top of the screen and redraws the screen after.
+ * The render cost stays the fixed TFT_COST_RENDER_PX_NS.
+ * The render buffers are borrowed, call it outside of lv_timer_handler().
+ */
+void tft_calibrate_cost_model(void)
+{
+    const uint32_t rows = 8;
+    const uint32_t nbytes = TFT_HOR_RES * rows * 2;
+    uint8_t *buf = lcd_get_draw_buffer1_addr();
+    uint32_t t0, win_cycles, px_cycles, i;
+
+    /*Don't take the buffers away from a running transfer*/
+    while(lcd_is_busy());
+    lv_memzero(buf, nbytes);
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    t0 = DWT->CYCCNT;
+    for(i = 0; i < rows; i++) {
+        lcd_set_gram_window(0, TFT_HOR_RES - 1, 0, rows - 1);
+    }
+    win_cycles = (DWT->CYCCNT - t0) / rows;
+
+    t0 = DWT->CYCCNT;
+    lcd_write(buf, nbytes);
+    px_cycles = DWT->CYCCNT - t0;
+
+    cost_model.window_ns = (uint32_t)((uint64_t)win_cycles * 1000000000ULL / SystemCoreClock);
+    cost_model.byte_ns = (uint32_t)((uint64_t)px_cycles * 1000000000ULL / SystemCoreClock / nbytes);
+
+    LV_LOG_USER("Cost model: window %lu ns, byte %lu ns", cost_model.window_ns, cost_model.byte_ns);
+
+    /*The black rows are covered again by the next frame*/
+    lv_obj_invalidate(lv_display_get_screen_active(display));
+}
+#endif
+
+#if TFT_COALESCE_BENCH
+/**
+ * Replay the recorded invalidation traces with the cost model in use and
+ * the size of one render buffer, see tft_coalesce_bench_run().
+ * The render buffers are borrowed, call it outside of lv_timer_handler().
+ */
+void tft_coalesce_bench(void)
+{
+    /*Don't take the buffers away from a running transfer*/
+    while(lcd_is_busy());
+
+    tft_coalesce_bench_run(&cost_model, lcd_get_draw_buffer1_addr(), buf_config.buf_lines * TFT_HOR_RES * 2);
+}
+#endif
+
+/* Merge the joined invalidated areas further if fewer windows pay off */
+static void coalesce_cb(lv_event_t *e)
+{
+    lv_display_t *disp = lv_event_get_target(e);
+    uint32_t buf_px = buf_config.buf_lines * TFT_HOR_RES;
+    uint32_t i;
+
+#if TFT_COALESCE_LOG
+    coalesce_areas_in = 0;
+    coalesce_bytes_separate = 0;
+    for(i = 0; i < disp->inv_p; i++) {
+        if(disp->inv_area_joined[i]) continue;
+        /* One line per area, the trace can be replayed through tft_coalesce_plan() */
+        LV_LOG_USER("Inv: %ld %ld %ld %ld", (long)disp->inv_areas[i].x1, (long)disp->inv_areas[i].y1,
+                    (long)disp->inv_areas[i].x2, (long)disp->inv_areas[i].y2);
+        coalesce_areas_in++;
+        coalesce_bytes_separate += tft_coalesce_bytes(&disp->inv_areas[i], buf_px);
+    }
+#endif
+
+    tft_coalesce_plan(&cost_model, disp->inv_areas, disp->inv_area_joined, disp->inv_p, buf_px);
+
+#if TFT_COALESCE_LOG
+    coalesce_areas_out = 0;
+    coalesce_bytes_estimated = 0;
+    for(i = 0; i < disp->inv_p; i++) {
+        if(disp->inv_area_joined[i]) continue;
+        coalesce_areas_out++;
+        coalesce_bytes_estimated += tft_coalesce_bytes(&disp->inv_areas[i], buf_px);
+    }
+#else
+    LV_UNUSED(i);
+#endif
+}
+#endif
+
+#if LCD_PIN_BENCH
+/**
+ * Compare the HAL and the BSRR pin backend: log the cycles of one CS/DCX
+ * write through each and what the difference adds up to over a full redraw
+ * of the active screen. Leave TFT_BUS_STATS at 0, it takes the counts too.
+ * Call it outside of lv_timer_handler().
+ */
+void tft_pin_bench(void)
+{
+    lcd_pin_bench_t pins;
+    lcd_bus_stats_t stats;
+    uint32_t saved;
+
+    lcd_pin_bench(&pins);
+
+    while(lcd_is_busy());
+    lcd_take_bus_stats(&stats);
+    lv_obj_invalidate(lv_display_get_screen_active(display));
+    lv_refr_now(display);
+    /*The last flush releases CS from the DMA interrupt*/
+    while(lcd_is_busy());
+    lcd_take_bus_stats(&stats);
+
+    saved = pins.hal_cycles_x100 > pins.bsrr_cycles_x100 ? pins.hal_cycles_x100 - pins.bsrr_cycles_x100 : 0;
+    saved = saved * stats.pin_writes / 100;
+
+    LV_LOG_USER("Pins: HAL %lu.%02lu, BSRR %lu.%02lu cycles per write",
+                pins.hal_cycles_x100 / 100, pins.hal_cycles_x100 % 100,
+                pins.bsrr_cycles_x100 / 100, pins.bsrr_cycles_x100 % 100);
+    LV_LOG_USER("Pins: full redraw %lu windows, %lu writes, BSRR saves %lu cycles (%lu us)",
+                stats.windows, stats.pin_writes, saved,
+                (uint32_t)((uint64_t)saved * 1000000ULL / SystemCoreClock));
+}
+#endif
+
+#if TFT_TE_SYNC
+/**
+ * Copy the TE scheduling statistics and clear them
+ * @param stats destination of the statistics
+ */
+void tft_take_te_stats(te_sched_stats_t *stats)
+{
+    te_sched_take_stats(&te_sched, stats);
+}
+
+/* TE pulse, EXTI interrupt context */
+static void tft_te_cb(void)
+{
+    te_sched_on_te(&te_sched, HAL_GetTick());
+}
+#endif
+
+static void boot_probe_cb(lv_event_t *e)
+{
+    LV_UNUSED(e);
+
+    if(boot_first_frame_ms == 0) return;
 
-    lv_disp_flush_ready(disp);
+    LV_LOG_USER("Boot: first frame after %lu ms", boot_first_frame_ms);
+    lv_display_remove_event_cb_with_user_data(display, boot_probe_cb, NULL);
 }
 
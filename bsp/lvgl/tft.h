@@ -12,6 +12,9 @@
 #include <stdint.h>
 #include "lvgl.h"
 #include "lcd.h"
+#include "te_sched.h"
+#include "tft_coalesce.h"
+#include "tft_coalesce_bench.h"
 
 /*********************
  *      DEFINES
@@ -22,14 +25,69 @@
 #define TFT_EXT_FB		0		/*Frame buffer is located into an external SDRAM*/
 #define TFT_USE_GPU		0		/*Enable hardware accelerator*/
 
+/*Render buffers, carved from the LCD draw buffers (2 * LCD_DRAW_BUF_SIZE bytes)*/
+#define TFT_BUF_COUNT	2		/*1: render and flush in turn, 2: render while the other buffer is flushed*/
+#define TFT_BUF_LINES	0		/*Lines per buffer, 0: as many as fit. Always partial rendering, a frame is 150 KB*/
+
+#define TFT_BUF_BENCH	0		/*Build tft_buf_bench(), it times screens under every buffer layout*/
+#define TFT_BUS_STATS	0		/*Log SPI setup vs. pixel bytes of every frame*/
+#define TFT_DIRECT_FILL	1		/*Send opaque full-width fills straight to the panel*/
+#define TFT_FILL_STATS	0		/*Log claimed vs. passed fill tasks of every frame*/
+#define TFT_HW_SCROLL	0		/*Scroll a container attached with tft_scroll_attach() with the panel's scroll area, portrait only*/
+#define TFT_TE_SYNC		USE_LCD_TE_SYNC	/*Start each frame right after the panel's TE pulse*/
+#define TFT_TE_WINDOW_MS	2		/*Still start without waiting this long after a TE pulse*/
+#define TFT_TE_TIMEOUT_MS	20		/*Give up waiting for TE (one frame is ~14 ms at 70 Hz)*/
+#define TFT_TE_STATS	0		/*Log TE wait time and missed windows of every frame*/
+#define TFT_COALESCE	1		/*Merge invalidated areas when the cost model says it is cheaper*/
+#define TFT_COALESCE_LOG	0		/*Log the invalidated areas, the merge decision and the bytes*/
+#define TFT_COALESCE_CALIBRATE	0	/*Build tft_calibrate_cost_model(), main.c runs it once the UI is shown*/
+
+/*Cost model. Window and byte cost follow from the bus, tft_calibrate_cost_model()
+ *can measure them on the panel. The render cost is a fixed estimate, never measured.*/
+#define TFT_COST_WINDOW_NS	8000	/*Polled CASET/RASET/RAMWR incl. CS/DCX toggles: 11 bytes plus the polling*/
+#define TFT_COST_BYTE_NS	381		/*SPI2 at 21 MHz: 8 bits / 21 MHz*/
+#define TFT_COST_RENDER_PX_NS	40		/*Software rendering, average per pixel*/
+
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct {
+    uint8_t buf_count;                      /*1 or 2*/
+    uint16_t buf_lines;                     /*Lines per buffer, 0: as many as fit*/
+} tft_buf_config_t;
+
+/*A screen state tft_buf_bench() redraws*/
+typedef struct {
+    const char *name;
+    void (*show)(void);                     /*Bring the screen into that state*/
+} tft_bench_scene_t;
 
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
 void tft_init(void);
+uint32_t tft_get_boot_time_ms(void);
+bool tft_set_buf_config(const tft_buf_config_t *config);
+void tft_get_buf_config(tft_buf_config_t *config);
+#if TFT_BUF_BENCH
+void tft_buf_bench(const tft_bench_scene_t *scenes, uint32_t cnt);
+#endif
+#if TFT_TE_SYNC
+void tft_take_te_stats(te_sched_stats_t *stats);
+#endif
+#if TFT_COALESCE
+void tft_set_cost_model(const tft_cost_model_t *model);
+void tft_get_cost_model(tft_cost_model_t *model);
+#if TFT_COALESCE_CALIBRATE
+void tft_calibrate_cost_model(void);
+#endif
+#if TFT_COALESCE_BENCH
+void tft_coalesce_bench(void);
+#endif
+#endif
+#if LCD_PIN_BENCH
+void tft_pin_bench(void);
+#endif
 
 /**********************
  *      MACROS
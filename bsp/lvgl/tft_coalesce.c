@@ -0,0 +1,169 @@
+/**
+ * @file tft_coalesce.c
+ *
+ * Merges invalidated areas when one bigger window is cheaper to render and
+ * send than several small ones. Works on plain area lists (the layout of
+ * lv_display_t's inv_areas/inv_area_joined), so recorded invalidation
+ * traces can be replayed on the host.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "tft_coalesce.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void area_join(lv_area_t *res, const lv_area_t *a, const lv_area_t *b);
+static bool area_is_in(const lv_area_t *in, const lv_area_t *holder);
+static bool area_cuts_other(const lv_area_t *area, const lv_area_t *areas, const uint8_t *joined,
+                            uint32_t cnt, uint32_t i, uint32_t j);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Number of windows an area is flushed in
+ * @param area the area
+ * @param buf_px pixels of one draw buffer, the area is rendered in chunks of
+ *               as many full rows as fit
+ * @return number of flushes of the area
+ */
+uint32_t tft_coalesce_windows(const lv_area_t *area, uint32_t buf_px)
+{
+    uint32_t w = lv_area_get_width(area);
+    uint32_t h = lv_area_get_height(area);
+    uint32_t rows = buf_px / w;
+
+    if(rows == 0) rows = 1;
+
+    return (h + rows - 1) / rows;
+}
+
+/**
+ * Bytes on the SPI for an area, window setup included
+ */
+uint32_t tft_coalesce_bytes(const lv_area_t *area, uint32_t buf_px)
+{
+    return tft_coalesce_windows(area, buf_px) * TFT_COST_WINDOW_BYTES + lv_area_get_size(area) * 2;
+}
+
+/**
+ * Estimated time of rendering and sending an area
+ * @return ns
+ */
+uint64_t tft_coalesce_cost(const tft_cost_model_t *model, const lv_area_t *area, uint32_t buf_px)
+{
+    uint64_t px = lv_area_get_size(area);
+
+    return (uint64_t)tft_coalesce_windows(area, buf_px) * model->window_ns +
+           px * 2 * model->byte_ns + px * model->render_px_ns;
+}
+
+/**
+ * Greedily merge the pair of areas with the largest saving until merging
+ * doesn't pay off. Areas inside a merged one are dropped too. A merge whose
+ * box covers only a part of another area is not made: those pixels would be
+ * rendered and sent twice, which the cost doesn't see.
+ * @param model cost model
+ * @param areas the areas, merged ones are grown in place
+ * @param joined one flag per area, set for the areas merged into another one
+ * @param cnt number of areas
+ * @param buf_px pixels of one draw buffer
+ * @return number of areas merged away
+ */
+uint32_t tft_coalesce_plan(const tft_cost_model_t *model, lv_area_t *areas, uint8_t *joined,
+                           uint32_t cnt, uint32_t buf_px)
+{
+    uint32_t merged = 0;
+    uint32_t i, j, k;
+
+    while(1) {
+        uint64_t best_gain = 0;
+        uint32_t best_i = 0, best_j = 0;
+        lv_area_t best_area = {0};
+
+        for(i = 0; i < cnt; i++) {
+            if(joined[i]) continue;
+            uint64_t cost_i = tft_coalesce_cost(model, &areas[i], buf_px);
+
+            for(j = i + 1; j < cnt; j++) {
+                lv_area_t sum;
+                uint64_t separate, together;
+
+                if(joined[j]) continue;
+
+                area_join(&sum, &areas[i], &areas[j]);
+                separate = cost_i + tft_coalesce_cost(model, &areas[j], buf_px);
+                together = tft_coalesce_cost(model, &sum, buf_px);
+                if(together < separate && separate - together > best_gain &&
+                   !area_cuts_other(&sum, areas, joined, cnt, i, j)) {
+                    best_gain = separate - together;
+                    best_i = i;
+                    best_j = j;
+                    best_area = sum;
+                }
+            }
+        }
+
+        if(best_gain == 0) break;
+
+        areas[best_i] = best_area;
+        joined[best_j] = 1;
+        merged++;
+
+        for(k = 0; k < cnt; k++) {
+            if(k == best_i || joined[k]) continue;
+            if(area_is_in(&areas[k], &best_area)) {
+                joined[k] = 1;
+                merged++;
+            }
+        }
+    }
+
+    return merged;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void area_join(lv_area_t *res, const lv_area_t *a, const lv_area_t *b)
+{
+    res->x1 = LV_MIN(a->x1, b->x1);
+    res->y1 = LV_MIN(a->y1, b->y1);
+    res->x2 = LV_MAX(a->x2, b->x2);
+    res->y2 = LV_MAX(a->y2, b->y2);
+}
+
+static bool area_is_in(const lv_area_t *in, const lv_area_t *holder)
+{
+    return in->x1 >= holder->x1 && in->y1 >= holder->y1 &&
+           in->x2 <= holder->x2 && in->y2 <= holder->y2;
+}
+
+/*The area overlaps a remaining area other than i and j without covering it*/
+static bool area_cuts_other(const lv_area_t *area, const lv_area_t *areas, const uint8_t *joined,
+                            uint32_t cnt, uint32_t i, uint32_t j)
+{
+    uint32_t k;
+
+    for(k = 0; k < cnt; k++) {
+        if(k == i || k == j || joined[k]) continue;
+        if(areas[k].x1 > area->x2 || areas[k].x2 < area->x1 ||
+           areas[k].y1 > area->y2 || areas[k].y2 < area->y1) continue;
+        if(!area_is_in(&areas[k], area)) return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,43 @@
+/**
+ * @file tft_coalesce.h
+ *
+ */
+
+#ifndef TFT_COALESCE_H
+#define TFT_COALESCE_H
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include "lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TFT_COST_WINDOW_BYTES	14		/*CASET + RASET + RAMWR in 16-bit frames*/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/*Time estimate of sending an area, all values in ns*/
+typedef struct {
+    uint32_t window_ns;         /*Setting up one GRAM window*/
+    uint32_t byte_ns;           /*One pixel byte on the SPI*/
+    uint32_t render_px_ns;      /*Rendering one pixel*/
+} tft_cost_model_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+uint32_t tft_coalesce_windows(const lv_area_t *area, uint32_t buf_px);
+uint32_t tft_coalesce_bytes(const lv_area_t *area, uint32_t buf_px);
+uint64_t tft_coalesce_cost(const tft_cost_model_t *model, const lv_area_t *area, uint32_t buf_px);
+uint32_t tft_coalesce_plan(const tft_cost_model_t *model, lv_area_t *areas, uint8_t *joined,
+                           uint32_t cnt, uint32_t buf_px);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif
@@ -0,0 +1,251 @@
+/**
+ * @file tft_coalesce_bench.c
+ *
+ * Replays invalidation traces of the pomodoro UI through the area
+ * coalescing. Every trace is invalidated on a temporary display with the
+ * given render buffer, tft_coalesce_plan() runs on LV_EVENT_RENDER_START
+ * like in tft.c, and the flushes that follow are counted. No hardware
+ * access, so it runs on the host as well as on the board.
+ *
+ * The traces were recorded from TFT_COALESCE_LOG style "Inv:" lines of the
+ * UI running on the host (240 x 320, LVGL's own joining already applied).
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "tft_coalesce_bench.h"
+
+#if TFT_COALESCE_BENCH
+
+#include "lvgl.h"
+#include "lvgl/src/lvgl_private.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BENCH_HOR_RES   240
+#define BENCH_VER_RES   320
+#define BENCH_MAX_AREAS 8
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    const char *name;
+    const lv_area_t *areas;
+    uint32_t cnt;
+} bench_trace_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void bench_replay(const bench_trace_t *trace);
+static void bench_render_start_cb(lv_event_t *e);
+static void bench_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+/*Marquee of the quote, on every frame*/
+static const lv_area_t trace_quote[] = {
+    {16, 283, 223, 306},
+};
+/*Countdown digits of a new second*/
+static const lv_area_t trace_second[] = {
+    {16, 283, 223, 306}, {75, 117, 167, 160},
+};
+/*New second, the progress ring steps at the top*/
+static const lv_area_t trace_ring_top[] = {
+    {16, 283, 223, 306}, {171, 73, 201, 87}, {75, 117, 164, 160},
+};
+/*New second, the progress ring steps on the right*/
+static const lv_area_t trace_ring_right[] = {
+    {16, 283, 223, 306}, {200, 121, 221, 146}, {73, 117, 166, 160},
+};
+/*New second, the progress ring steps on the left*/
+static const lv_area_t trace_ring_left[] = {
+    {16, 283, 223, 306}, {21, 82, 50, 110}, {77, 117, 167, 160},
+};
+/*Start pressed: buttons, mode icon, quote*/
+static const lv_area_t trace_start[] = {
+    {56, 216, 91, 235}, {0, 213, 44, 238}, {139, 213, 192, 238}, {88, 7, 151, 70},
+    {16, 283, 223, 306},
+};
+/*Full screen countdown slides in*/
+static const lv_area_t trace_overlay[] = {
+    {18, 73, 221, 204}, {16, 283, 223, 306}, {45, 7, 193, 70},
+};
+/*Work ends, break starts: every indicator changes*/
+static const lv_area_t trace_mode_change[] = {
+    {56, 216, 91, 235}, {139, 213, 192, 238}, {18, 73, 221, 204}, {24, 7, 87, 70},
+    {88, 7, 151, 70}, {152, 7, 215, 70}, {78, 248, 161, 271}, {16, 283, 223, 306},
+};
+/*Pause pressed: ring, digits, button, pause label*/
+static const lv_area_t trace_pause[] = {
+    {184, 73, 213, 102}, {74, 117, 170, 160}, {56, 216, 91, 235}, {85, 160, 154, 183},
+    {16, 283, 223, 306},
+};
+/*Screen switch*/
+static const lv_area_t trace_screen[] = {
+    {0, 0, 239, 319},
+};
+
+#define BENCH_TRACE(name, areas)  { name, areas, sizeof(areas) / sizeof(areas[0]) }
+
+static const bench_trace_t bench_traces[] = {
+    BENCH_TRACE("quote", trace_quote),
+    BENCH_TRACE("second", trace_second),
+    BENCH_TRACE("ring top", trace_ring_top),
+    BENCH_TRACE("ring right", trace_ring_right),
+    BENCH_TRACE("ring left", trace_ring_left),
+    BENCH_TRACE("start", trace_start),
+    BENCH_TRACE("overlay", trace_overlay),
+    BENCH_TRACE("mode change", trace_mode_change),
+    BENCH_TRACE("pause", trace_pause),
+    BENCH_TRACE("screen", trace_screen),
+};
+
+static struct {
+    lv_display_t *disp;
+    const tft_cost_model_t *model;
+    uint32_t buf_px;
+    uint32_t areas_in;
+    uint32_t areas_out;
+    uint32_t bytes_separate;    /*Estimate without coalescing*/
+    uint32_t bytes_estimated;   /*Estimate of the planned areas*/
+    uint64_t cost_separate;     /*ns*/
+    uint64_t cost_planned;      /*ns*/
+    uint32_t bytes_actual;      /*Flushed, window setup included*/
+    uint32_t flushes;
+    lv_area_t in[BENCH_MAX_AREAS];
+    lv_area_t out[BENCH_MAX_AREAS];
+} bench;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Replay the recorded traces and log, per trace, the planned areas with the
+ * number of recorded areas each one covers, the estimated bytes without and
+ * with coalescing and the bytes actually flushed.
+ * Call it outside of lv_timer_handler().
+ * @param model cost model to plan with
+ * @param buf render buffer, its content is overwritten
+ * @param buf_size size of buf in bytes, as much as one render buffer of the display
+ */
+void tft_coalesce_bench_run(const tft_cost_model_t *model, void *buf, uint32_t buf_size)
+{
+    lv_display_t *def = lv_display_get_default();
+    uint32_t sep = 0, est = 0, act = 0;
+    uint32_t i;
+
+    bench.model = model;
+    bench.buf_px = buf_size / 2;
+
+    /*lv_display_create() makes the display the default only if there is none*/
+    bench.disp = lv_display_create(BENCH_HOR_RES, BENCH_VER_RES);
+    lv_display_set_default(def);
+    lv_display_set_color_format(bench.disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(bench.disp, buf, NULL, buf_size, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(bench.disp, bench_flush_cb);
+    lv_display_add_event_cb(bench.disp, bench_render_start_cb, LV_EVENT_RENDER_START, NULL);
+
+    /*The first frame of a new display is the whole screen*/
+    lv_refr_now(bench.disp);
+
+    LV_LOG_USER("Coalesce bench: %lu px per buffer, window %lu ns, byte %lu ns, render %lu ns/px",
+                (unsigned long)bench.buf_px, (unsigned long)model->window_ns,
+                (unsigned long)model->byte_ns, (unsigned long)model->render_px_ns);
+
+    for(i = 0; i < sizeof(bench_traces) / sizeof(bench_traces[0]); i++) {
+        bench_replay(&bench_traces[i]);
+        sep += bench.bytes_separate;
+        est += bench.bytes_estimated;
+        act += bench.bytes_actual;
+    }
+
+    LV_LOG_USER("Coalesce bench: total estimated %lu B (separate %lu B), actual %lu B",
+                (unsigned long)est, (unsigned long)sep, (unsigned long)act);
+
+    lv_display_delete(bench.disp);
+    bench.disp = NULL;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void bench_replay(const bench_trace_t *trace)
+{
+    uint32_t i, j, covered;
+
+    bench.areas_in = 0;
+    bench.areas_out = 0;
+    bench.bytes_actual = 0;
+    bench.flushes = 0;
+
+    for(i = 0; i < trace->cnt; i++) lv_inv_area(bench.disp, &trace->areas[i]);
+    lv_refr_now(bench.disp);
+
+    LV_LOG_USER("Coalesce %s: %lu -> %lu areas, estimated %lu B (separate %lu B), actual %lu B in %lu flushes, "
+                "cost %lu us (separate %lu us)",
+                trace->name, (unsigned long)bench.areas_in, (unsigned long)bench.areas_out,
+                (unsigned long)bench.bytes_estimated, (unsigned long)bench.bytes_separate,
+                (unsigned long)bench.bytes_actual, (unsigned long)bench.flushes,
+                (unsigned long)(bench.cost_planned / 1000), (unsigned long)(bench.cost_separate / 1000));
+
+    /*The merge decisions: every planned area with the recorded ones it covers*/
+    for(i = 0; i < LV_MIN(bench.areas_out, BENCH_MAX_AREAS); i++) {
+        covered = 0;
+        for(j = 0; j < LV_MIN(bench.areas_in, BENCH_MAX_AREAS); j++) {
+            if(lv_area_is_in(&bench.in[j], &bench.out[i], 0)) covered++;
+        }
+        if(covered < 2) continue;
+        LV_LOG_USER("  merged %lu areas into %ld %ld %ld %ld", (unsigned long)covered,
+                    (long)bench.out[i].x1, (long)bench.out[i].y1, (long)bench.out[i].x2, (long)bench.out[i].y2);
+    }
+}
+
+/*The same as coalesce_cb() in tft.c, with the numbers kept for the log*/
+static void bench_render_start_cb(lv_event_t *e)
+{
+    lv_display_t *disp = lv_event_get_target(e);
+    uint32_t i;
+
+    bench.bytes_separate = 0;
+    bench.cost_separate = 0;
+    for(i = 0; i < disp->inv_p; i++) {
+        if(disp->inv_area_joined[i]) continue;
+        if(bench.areas_in < BENCH_MAX_AREAS) bench.in[bench.areas_in] = disp->inv_areas[i];
+        bench.areas_in++;
+        bench.bytes_separate += tft_coalesce_bytes(&disp->inv_areas[i], bench.buf_px);
+        bench.cost_separate += tft_coalesce_cost(bench.model, &disp->inv_areas[i], bench.buf_px);
+    }
+
+    tft_coalesce_plan(bench.model, disp->inv_areas, disp->inv_area_joined, disp->inv_p, bench.buf_px);
+
+    bench.bytes_estimated = 0;
+    bench.cost_planned = 0;
+    for(i = 0; i < disp->inv_p; i++) {
+        if(disp->inv_area_joined[i]) continue;
+        if(bench.areas_out < BENCH_MAX_AREAS) bench.out[bench.areas_out] = disp->inv_areas[i];
+        bench.areas_out++;
+        bench.bytes_estimated += tft_coalesce_bytes(&disp->inv_areas[i], bench.buf_px);
+        bench.cost_planned += tft_coalesce_cost(bench.model, &disp->inv_areas[i], bench.buf_px);
+    }
+}
+
+/*Counts what would go to the panel: one window per flush and the pixels*/
+static void bench_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    LV_UNUSED(px_map);
+
+    bench.flushes++;
+    bench.bytes_actual += TFT_COST_WINDOW_BYTES + lv_area_get_size(area) * 2;
+
+    lv_display_flush_ready(disp);
+}
+
+#endif /*TFT_COALESCE_BENCH*/
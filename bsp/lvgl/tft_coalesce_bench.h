@@ -0,0 +1,30 @@
+/**
+ * @file tft_coalesce_bench.h
+ *
+ */
+
+#ifndef TFT_COALESCE_BENCH_H
+#define TFT_COALESCE_BENCH_H
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include "tft_coalesce.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/*1: tft_coalesce_bench_run() is built, it replays recorded invalidation traces*/
+#ifndef TFT_COALESCE_BENCH
+#define TFT_COALESCE_BENCH	0
+#endif
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+#if TFT_COALESCE_BENCH
+void tft_coalesce_bench_run(const tft_cost_model_t *model, void *buf, uint32_t buf_size);
+#endif
+
+#endif
@@ -0,0 +1,257 @@
+/**
+ * @file tft_fill.c
+ *
+ * Draw unit that sends opaque full-width rectangle fills straight to the
+ * panel. A claimed fill is not rasterized: its rows are skipped when the
+ * draw buffer is flushed and lcd_fill_rect_fast() paints them instead.
+ * If a later draw task lands on a claimed fill, the fill is handed back
+ * to the draw buffer, so the result is the same as software rendering.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "tft_fill.h"
+#include "tft.h"
+#include "tft_scroll.h"
+#include "lvgl/src/lvgl_private.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define DRAW_UNIT_ID_TFT_FILL	50
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    lv_draw_task_t *task;   /*Claimed task until it is dispatched, NULL afterwards*/
+    lv_area_t area;         /*Clipped fill area, always the full width of the layer*/
+    lv_color_t color;
+} fill_band_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static int32_t evaluate_cb(lv_draw_unit_t *draw_unit, lv_draw_task_t *task);
+static int32_t dispatch_cb(lv_draw_unit_t *draw_unit, lv_layer_t *layer);
+static void band_revert(lv_layer_t *layer, fill_band_t *band);
+static void band_remove(uint32_t idx);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_display_t *fill_disp;
+static fill_band_t bands[TFT_FILL_MAX_BANDS];
+static uint32_t band_cnt;
+static tft_fill_stats_t fill_stats;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Register the direct fill draw unit for a display
+ * @param disp the display flushed by tft_flush(), must render in partial mode
+ */
+void tft_fill_init(lv_display_t *disp)
+{
+    lv_draw_unit_t *unit = lv_draw_create_unit(sizeof(lv_draw_unit_t));
+
+    unit->evaluate_cb = evaluate_cb;
+    unit->dispatch_cb = dispatch_cb;
+    unit->name = "TFT_FILL";
+
+    fill_disp = disp;
+}
+
+/**
+ * Flush a rendered area, painting the claimed bands as solid fills
+ * @param area the area being flushed
+ * @param px_map the draw buffer of the area
+ * @param done_cb called once the draw buffer can be reused
+ * @return true if the area was handled, false if it has no claimed band
+ */
+bool tft_fill_flush(const lv_area_t *area, uint8_t *px_map, lcd_xfer_done_cb_t done_cb)
+{
+    lv_area_t spans[TFT_FILL_MAX_BANDS + 1];
+    uint32_t span_cnt = 0;
+    uint32_t width = lv_area_get_width(area);
+    int32_t y = area->y1;
+    uint32_t i, j;
+
+    if(band_cnt == 0) return false;
+
+    /*Sort the bands top to bottom*/
+    for(i = 1; i < band_cnt; i++) {
+        fill_band_t tmp = bands[i];
+        for(j = i; j > 0 && bands[j - 1].area.y1 > tmp.area.y1; j--) {
+            bands[j] = bands[j - 1];
+        }
+        bands[j] = tmp;
+    }
+
+    /*Solid bands go first as they don't read the draw buffer*/
+    for(i = 0; i < band_cnt; i++) {
+        lv_area_t *a = &bands[i].area;
+
+#if TFT_HW_SCROLL
+        tft_scroll_fill_area(a, lv_color_to_u32(bands[i].color) & 0xFFFFFFUL);
+#else
+        lcd_fill_rect_fast(lv_color_to_u32(bands[i].color) & 0xFFFFFFUL,
+                           a->x1, lv_area_get_width(a), a->y1, lv_area_get_height(a));
+#endif
+        fill_stats.claimed++;
+
+        if(a->y1 > y) {
+            lv_area_set(&spans[span_cnt++], area->x1, y, area->x2, a->y1 - 1);
+        }
+        y = a->y2 + 1;
+    }
+    if(y <= area->y2) {
+        lv_area_set(&spans[span_cnt++], area->x1, y, area->x2, area->y2);
+    }
+    band_cnt = 0;
+
+    /*Rows between the bands come from the draw buffer*/
+    for(i = 0; i < span_cnt; i++) {
+        uint8_t *src = px_map + (spans[i].y1 - area->y1) * width * 2;
+
+#if TFT_HW_SCROLL
+        tft_scroll_write_area(&spans[i], src, (i == span_cnt - 1) ? done_cb : NULL);
+#else
+        lcd_set_gram_window(spans[i].x1, spans[i].x2, spans[i].y1, spans[i].y2);
+        lcd_write_async(src, lv_area_get_size(&spans[i]) * 2, (i == span_cnt - 1) ? done_cb : NULL);
+#endif
+    }
+
+    if(span_cnt == 0 && done_cb) {
+        done_cb();
+    }
+
+    return true;
+}
+
+/**
+ * Copy the fill counters and clear them
+ * @param stats destination of the counters
+ */
+void tft_fill_take_stats(tft_fill_stats_t *stats)
+{
+    *stats = fill_stats;
+    fill_stats.claimed = 0;
+    fill_stats.passed = 0;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Called for every new draw task. Hands back the bands the task draws over,
+ * then claims the task if it is an opaque, unrounded, full-width fill.
+ */
+static int32_t evaluate_cb(lv_draw_unit_t *draw_unit, lv_draw_task_t *task)
+{
+    lv_draw_dsc_base_t *base = task->draw_dsc;
+    lv_layer_t *layer = base->layer;
+    lv_draw_fill_dsc_t *dsc;
+    lv_area_t a;
+    uint32_t i;
+
+    LV_UNUSED(draw_unit);
+
+    /*Only the draw buffer of the display itself is flushed row by row*/
+    if(lv_refr_get_disp_refreshing() != fill_disp || layer != fill_disp->layer_head) return 0;
+
+    for(i = 0; i < band_cnt; ) {
+        if(lv_area_is_on(&task->_real_area, &bands[i].area)) {
+            band_revert(layer, &bands[i]);
+            band_remove(i);
+            fill_stats.passed++;
+        }
+        else {
+            i++;
+        }
+    }
+
+    if(task->type != LV_DRAW_TASK_TYPE_FILL) return 0;
+
+    dsc = task->draw_dsc;
+    if(band_cnt >= TFT_FILL_MAX_BANDS ||
+       fill_disp->render_mode != LV_DISPLAY_RENDER_MODE_PARTIAL ||
+       layer->color_format != LV_COLOR_FORMAT_RGB565 ||
+       dsc->opa < LV_OPA_MAX || dsc->radius != 0 || dsc->grad.dir != LV_GRAD_DIR_NONE ||
+       !lv_area_intersect(&a, &task->area, &task->clip_area) ||
+       a.x1 > layer->buf_area.x1 || a.x2 < layer->buf_area.x2) {
+        fill_stats.passed++;
+        return 0;
+    }
+
+    bands[band_cnt].task = task;
+    bands[band_cnt].area = a;
+    bands[band_cnt].color = dsc->color;
+    band_cnt++;
+
+    task->preferred_draw_unit_id = DRAW_UNIT_ID_TFT_FILL;
+    task->preference_score = 0;
+
+    return 0;
+}
+
+/**
+ * Take a claimed fill once the tasks below it are done. There is nothing to
+ * draw, tft_fill_flush() sends the pixels.
+ */
+static int32_t dispatch_cb(lv_draw_unit_t *draw_unit, lv_layer_t *layer)
+{
+    lv_draw_task_t *t = NULL;
+    uint32_t i;
+
+    /*Skip the tasks of the software renderer, they are also "available" for this unit*/
+    do {
+        t = lv_draw_get_next_available_task(layer, t, DRAW_UNIT_ID_TFT_FILL);
+    } while(t && t->preferred_draw_unit_id != DRAW_UNIT_ID_TFT_FILL);
+
+    if(t == NULL) return LV_DRAW_UNIT_IDLE;
+
+    for(i = 0; i < band_cnt; i++) {
+        if(bands[i].task == t) bands[i].task = NULL;
+    }
+
+    t->draw_unit = draw_unit;
+    t->state = LV_DRAW_TASK_STATE_FINISHED;
+    lv_draw_dispatch_request();
+
+    return 1;
+}
+
+/**
+ * Put a band back into the draw buffer
+ */
+static void band_revert(lv_layer_t *layer, fill_band_t *band)
+{
+    lv_area_t *a = &band->area;
+    uint16_t color = lv_color_to_u16(band->color);
+    int32_t x, y;
+
+    if(band->task) {
+        /*Not taken yet, the software renderer can draw it*/
+        band->task->preferred_draw_unit_id = LV_DRAW_UNIT_NONE;
+        band->task->preference_score = 100;
+        return;
+    }
+
+    for(y = a->y1; y <= a->y2; y++) {
+        uint16_t *px = lv_draw_layer_go_to_xy(layer, a->x1 - layer->buf_area.x1, y - layer->buf_area.y1);
+        for(x = a->x1; x <= a->x2; x++) {
+            *px++ = color;
+        }
+    }
+}
+
+static void band_remove(uint32_t idx)
+{
+    band_cnt--;
+    bands[idx] = bands[band_cnt];
+}
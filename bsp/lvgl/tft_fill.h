@@ -0,0 +1,41 @@
+/**
+ * @file tft_fill.h
+ *
+ */
+
+#ifndef TFT_FILL_H
+#define TFT_FILL_H
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl.h"
+#include "lcd.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TFT_FILL_MAX_BANDS	4		/*Solid bands kept per rendered area*/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint32_t claimed;       /*Fill tasks sent to the panel as a solid fill*/
+    uint32_t passed;        /*Fill tasks rasterized into the draw buffer*/
+} tft_fill_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void tft_fill_init(lv_display_t *disp);
+bool tft_fill_flush(const lv_area_t *area, uint8_t *px_map, lcd_xfer_done_cb_t done_cb);
+void tft_fill_take_stats(tft_fill_stats_t *stats);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif
@@ -0,0 +1,266 @@
+/**
+ * @file tft_flush_test.c
+ *
+ * Host-runnable test of the asynchronous flush. A small display flushes
+ * through the LCD transfer engine (lcd_xfer.c) like tft_flush() does, but
+ * into a mock DMA: it finishes the segments one at a time from the
+ * LV_EVENT_FLUSH_WAIT_START event, the way HAL_SPI_TxCpltCallback() does
+ * from the DMA interrupt. The mock segments are short, so every flush is
+ * a chain of several.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "tft_flush_test.h"
+
+#if TFT_FLUSH_TEST
+
+#include "lvgl.h"
+#include "lcd_xfer.h"
+#include "debug_test.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TEST_HOR_RES        120
+#define TEST_VER_RES        40
+#define TEST_BUF_LINES      10
+#define TEST_SEGMENT_WORDS  256     /*A 120 x 10 chunk is sent in 5 segments*/
+
+/*Checks in the callbacks keep the first failure, LVGL carries on*/
+#define TEST_EXPECT(c)  do{ if(!(c) && mock.failed_line == 0) mock.failed_line = __LINE__; }while(0)
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t test_layout(bool double_buf);
+static uint32_t test_frames(bool double_buf);
+static void test_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map);
+static void test_flush_done(void);
+static void test_wait_cb(lv_event_t *e);
+static void mock_dma_start(const uint16_t *src, uint16_t words);
+static void mock_dma_end(void);
+static void mock_dma_irq(void);
+static void mock_dma_drain(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static struct {
+    lv_display_t *disp;
+    uint32_t failed_line;       /*First failed TEST_EXPECT(), 0 if none*/
+    bool running;               /*A segment is on the wire*/
+    const uint16_t *expect;     /*Where the next segment has to start*/
+    const uint8_t *px_map;      /*Buffer of the flush in progress*/
+    uint32_t flush_words;       /*Words of the flush in progress*/
+    uint32_t sent_words;        /*Words of it handed to the mock DMA*/
+    uint32_t segments;          /*Segments of it*/
+    uint32_t flushes;           /*flush_cb calls*/
+    uint32_t readies;           /*lv_display_flush_ready() calls*/
+    uint32_t ends;              /*CS releases*/
+    uint32_t chained;           /*Flushes sent in more than one segment*/
+    uint32_t overlaps;          /*Waits that found LVGL rendering into the other buffer*/
+} mock;
+
+static const lcd_xfer_port_t mock_dma_port = {
+    .start = mock_dma_start,
+    .end = mock_dma_end,
+    .max_words = TEST_SEGMENT_WORDS,
+};
+
+static uint8_t test_buf1[TEST_HOR_RES * TEST_BUF_LINES * 2] __attribute__((aligned(4)));
+static uint8_t test_buf2[TEST_HOR_RES * TEST_BUF_LINES * 2] __attribute__((aligned(4)));
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Render two frames on a temporary display with one and with two buffers.
+ * Every flush has to be reported to LVGL exactly once, after its last
+ * segment, and with two buffers LVGL has to render while the other one is
+ * still on the wire. Puts the LCD's DMA port back when done.
+ * Call it outside of lv_timer_handler().
+ * @return 0 if all checks passed, else the line of the first failed one
+ */
+uint32_t tft_flush_test(void)
+{
+    const lcd_xfer_port_t *port;
+    uint32_t line;
+
+    /*Don't take the engine away from a running transfer*/
+    while(lcd_xfer_is_busy());
+
+    port = lcd_xfer_get_port();
+    lcd_xfer_set_port(&mock_dma_port);
+
+    line = test_layout(false);
+    if(line == 0) line = test_layout(true);
+
+    lcd_xfer_set_port(port);
+
+    return line;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/*Runs the frames on a temporary display, it is deleted again even if a check failed*/
+static uint32_t test_layout(bool double_buf)
+{
+    lv_display_t *def = lv_display_get_default();
+    uint32_t line;
+
+    lv_memzero(&mock, sizeof(mock));
+
+    /*lv_display_create() makes the display the default only if there is none*/
+    mock.disp = lv_display_create(TEST_HOR_RES, TEST_VER_RES);
+    lv_display_set_default(def);
+    lv_display_set_color_format(mock.disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(mock.disp, test_buf1, double_buf ? test_buf2 : NULL,
+                           sizeof(test_buf1), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(mock.disp, test_flush_cb);
+    lv_display_add_event_cb(mock.disp, test_wait_cb, LV_EVENT_FLUSH_WAIT_START, NULL);
+
+    line = test_frames(double_buf);
+
+    lv_display_delete(mock.disp);
+    mock.disp = NULL;
+
+    return line;
+}
+
+static uint32_t test_frames(bool double_buf)
+{
+    uint32_t chunks = TEST_VER_RES / TEST_BUF_LINES;
+    lv_obj_t *box;
+
+    box = lv_obj_create(lv_display_get_screen_active(mock.disp));
+    lv_obj_set_size(box, 40, 8);
+    lv_obj_set_pos(box, 10, 12);
+
+    /*The whole screen, one flush per chunk*/
+    lv_refr_now(mock.disp);
+    /*LVGL doesn't wait for the last flush of a frame, it is still on the wire*/
+    TEST_CHECK(lcd_xfer_is_busy());
+    mock_dma_drain();
+    if(mock.failed_line) return mock.failed_line;
+    TEST_CHECK(mock.flushes == chunks);
+    TEST_CHECK(mock.readies == mock.flushes);
+    TEST_CHECK(mock.ends == mock.flushes);
+    TEST_CHECK(mock.chained == mock.flushes);
+    TEST_CHECK(!lcd_xfer_is_busy());
+    if(double_buf) TEST_CHECK(mock.overlaps >= chunks - 1);
+    else TEST_CHECK(mock.overlaps == 0);
+
+    /*A small area crossing a chunk border*/
+    lv_obj_set_pos(box, 30, 6);
+    lv_refr_now(mock.disp);
+    /*LVGL doesn't wait for the last flush of a frame, it is still on the wire*/
+    TEST_CHECK(lcd_xfer_is_busy());
+    mock_dma_drain();
+    if(mock.failed_line) return mock.failed_line;
+    TEST_CHECK(mock.flushes > chunks);
+    TEST_CHECK(mock.readies == mock.flushes);
+    TEST_CHECK(mock.ends == mock.flushes);
+    TEST_CHECK(!lcd_xfer_is_busy());
+
+    return 0;
+}
+
+/*Starts the transfer and returns with it on the wire, like tft_flush()*/
+static void test_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    LV_UNUSED(disp);
+
+    /*LVGL waited for the previous flush, which was reported once*/
+    TEST_EXPECT(!lcd_xfer_is_busy());
+    TEST_EXPECT(mock.readies == mock.flushes);
+
+    mock.flushes++;
+    mock.px_map = px_map;
+    mock.expect = (const uint16_t *)px_map;
+    mock.flush_words = lv_area_get_size(area);
+    mock.sent_words = 0;
+    mock.segments = 0;
+
+    lcd_xfer_begin((const uint16_t *)px_map, mock.flush_words, true, test_flush_done);
+
+    TEST_EXPECT(lcd_xfer_is_busy());
+    TEST_EXPECT(mock.readies < mock.flushes);
+}
+
+/*The transfer is done, tft_flush_done() in the firmware*/
+static void test_flush_done(void)
+{
+    /*Only after the last segment left the mock DMA*/
+    TEST_EXPECT(!mock.running);
+    TEST_EXPECT(mock.sent_words == mock.flush_words);
+    TEST_EXPECT(mock.segments == (mock.flush_words + TEST_SEGMENT_WORDS - 1) / TEST_SEGMENT_WORDS);
+    TEST_EXPECT(mock.ends == mock.flushes);
+
+    if(mock.segments > 1) mock.chained++;
+    mock.readies++;
+    TEST_EXPECT(mock.readies == mock.flushes);
+
+    lv_display_flush_ready(mock.disp);
+}
+
+/*LVGL is about to wait for the flush: play the DMA interrupts*/
+static void test_wait_cb(lv_event_t *e)
+{
+    LV_UNUSED(e);
+
+    if(!lcd_xfer_is_busy()) return;
+
+    if(lv_display_get_buf_active(mock.disp)->data != mock.px_map) mock.overlaps++;
+
+    mock_dma_drain();
+}
+
+static void mock_dma_start(const uint16_t *src, uint16_t words)
+{
+    TEST_EXPECT(!mock.running);
+    TEST_EXPECT(src == mock.expect);
+    TEST_EXPECT(words > 0 && words <= TEST_SEGMENT_WORDS);
+
+    mock.running = true;
+    mock.expect = src + words;
+    mock.sent_words += words;
+    mock.segments++;
+}
+
+static void mock_dma_end(void)
+{
+    TEST_EXPECT(!mock.running);
+    mock.ends++;
+}
+
+/*Transfer complete interrupt of the mock DMA, HAL_SPI_TxCpltCallback()*/
+static void mock_dma_irq(void)
+{
+    mock.running = false;
+    lcd_xfer_segment_done();
+}
+
+/*Finishes the segments of the flush in progress one by one*/
+static void mock_dma_drain(void)
+{
+    while(mock.running) {
+        TEST_EXPECT(mock.readies < mock.flushes);
+        mock_dma_irq();
+    }
+
+    TEST_EXPECT(!lcd_xfer_is_busy());
+    TEST_EXPECT(mock.readies == mock.flushes);
+
+    /*Don't leave LVGL spinning on a lost completion*/
+    if(mock.readies < mock.flushes) {
+        mock.readies = mock.flushes;
+        lv_display_flush_ready(mock.disp);
+    }
+}
+
+#endif /*TFT_FLUSH_TEST*/
@@ -0,0 +1,29 @@
+/**
+ * @file tft_flush_test.h
+ *
+ */
+
+#ifndef TFT_FLUSH_TEST_H
+#define TFT_FLUSH_TEST_H
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+/*1: tft_flush_test() is built, it runs the asynchronous flush against a mock DMA*/
+#ifndef TFT_FLUSH_TEST
+#define TFT_FLUSH_TEST	0
+#endif
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+#if TFT_FLUSH_TEST
+uint32_t tft_flush_test(void);
+#endif
+
+#endif
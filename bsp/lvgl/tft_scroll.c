@@ -0,0 +1,255 @@
+/**
+ * @file tft_scroll.c
+ *
+ * Vertical scrolling of one full-width container with the ILI9341 scroll
+ * area. The container's rows are kept in GRAM as a ring: scrolling moves
+ * the ring start with VSCRSADD and only the newly exposed rows are
+ * rendered and flushed. All other flushes are mapped into the ring too.
+ *
+ * The container must not move on screen and nothing may be drawn over it.
+ * Its border, radius and scrollbar would scroll with the content, so they
+ * should not be used either.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "tft_scroll.h"
+#include "tft.h"
+#include "lvgl/src/lvgl_private.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void scroll_event_cb(lv_event_t *e);
+static void scroll_delete_cb(lv_event_t *e);
+static void invalidate_cb(lv_event_t *e);
+static void render_start_cb(lv_event_t *e);
+static int32_t map_rows(int32_t y, int32_t y2, int32_t *gram_y);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_display_t *scroll_disp;
+static lv_obj_t *scroll_cont;
+static int32_t scroll_top;          /*First screen row of the scroll area*/
+static int32_t scroll_height;       /*0 while no container is attached*/
+static int32_t scroll_offset;       /*Ring start sent to the panel*/
+static int32_t scroll_pending;      /*Rows scrolled since the last render*/
+static int32_t scroll_y_last;
+static bool scroll_trim;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Hook the scroll mapping into a display
+ * @param disp the display flushed by tft_flush()
+ */
+void tft_scroll_init(lv_display_t *disp)
+{
+    scroll_disp = disp;
+    lv_display_add_event_cb(disp, invalidate_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+    lv_display_add_event_cb(disp, render_start_cb, LV_EVENT_RENDER_START, NULL);
+}
+
+/**
+ * Scroll a container with the panel's scroll area. Only one container can
+ * be attached, it is detached automatically when deleted. Portrait only.
+ * @param cont a full-width container with a fixed position on the screen
+ */
+void tft_scroll_attach(lv_obj_t *cont)
+{
+    lv_area_t coords;
+
+    if(scroll_disp == NULL || scroll_cont != NULL) {
+        LV_LOG_WARN("hardware scroll is not available");
+        return;
+    }
+
+#if LCD_ORIENTATION != PORTRAIT
+    /*The panel scrolls along its GRAM rows, which are screen rows in portrait only*/
+    LV_UNUSED(coords);
+    LV_LOG_WARN("hardware scroll needs LCD_ORIENTATION PORTRAIT");
+    return;
+#else
+
+    lv_obj_update_layout(cont);
+    lv_obj_get_coords(cont, &coords);
+    if(coords.x1 > 0 || coords.x2 < TFT_HOR_RES - 1) {
+        LV_LOG_WARN("hardware scroll needs a full-width container");
+        return;
+    }
+
+    scroll_top = LV_MAX(coords.y1, 0);
+    scroll_height = LV_MIN(coords.y2, TFT_VER_RES - 1) - scroll_top + 1;
+    if(scroll_height <= 0) {
+        scroll_height = 0;
+        return;
+    }
+
+    scroll_cont = cont;
+    scroll_offset = 0;
+    scroll_pending = 0;
+    scroll_trim = false;
+    scroll_y_last = lv_obj_get_scroll_y(cont);
+
+    lv_obj_set_scrollbar_mode(cont, LV_SCROLLBAR_MODE_OFF);
+    lv_obj_add_event_cb(cont, scroll_event_cb, LV_EVENT_SCROLL, NULL);
+    lv_obj_add_event_cb(cont, scroll_delete_cb, LV_EVENT_DELETE, NULL);
+
+    lcd_scroll_set_area(scroll_top, scroll_height);
+#endif
+}
+
+/**
+ * Send a rendered area to its GRAM rows, the last write calls done_cb
+ * @param area screen area of the pixels
+ * @param px_map RGB565 pixels of the area
+ * @param done_cb called once px_map can be reused
+ */
+void tft_scroll_write_area(const lv_area_t *area, uint8_t *px_map, lcd_xfer_done_cb_t done_cb)
+{
+    uint32_t width = lv_area_get_width(area);
+    int32_t y = area->y1;
+    int32_t gram_y;
+    int32_t rows;
+
+    while(y <= area->y2) {
+        rows = map_rows(y, area->y2, &gram_y);
+
+        lcd_set_gram_window(area->x1, area->x2, gram_y, gram_y + rows - 1);
+        lcd_write_async(px_map + (y - area->y1) * width * 2, rows * width * 2,
+                        (y + rows > area->y2) ? done_cb : NULL);
+        y += rows;
+    }
+}
+
+/**
+ * Fill a screen area with a solid color in its GRAM rows
+ * @param area screen area to fill
+ * @param rgb888 the color
+ */
+void tft_scroll_fill_area(const lv_area_t *area, uint32_t rgb888)
+{
+    int32_t y = area->y1;
+    int32_t gram_y;
+    int32_t rows;
+
+    while(y <= area->y2) {
+        rows = map_rows(y, area->y2, &gram_y);
+        lcd_fill_rect_fast(rgb888, area->x1, lv_area_get_width(area), gram_y, rows);
+        y += rows;
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Find where screen row y is kept in GRAM
+ * @param y first screen row
+ * @param y2 last screen row of the area
+ * @param gram_y the GRAM row of y
+ * @return the number of rows from y on which are contiguous in GRAM
+ */
+static int32_t map_rows(int32_t y, int32_t y2, int32_t *gram_y)
+{
+    int32_t bottom = scroll_top + scroll_height;
+    int32_t ring_y;
+
+    *gram_y = y;
+    if(scroll_height == 0 || y >= bottom) return y2 - y + 1;
+    if(y < scroll_top) return LV_MIN(y2, scroll_top - 1) - y + 1;
+
+    ring_y = scroll_top + (y - scroll_top + scroll_offset) % scroll_height;
+    *gram_y = ring_y;
+
+    return LV_MIN(LV_MIN(y2, bottom - 1) - y + 1, bottom - ring_y);
+}
+
+/* The content moved: the panel scrolls at the next render, only the rows
+ * it exposes have to be redrawn */
+static void scroll_event_cb(lv_event_t *e)
+{
+    int32_t y = lv_obj_get_scroll_y(scroll_cont);
+
+    LV_UNUSED(e);
+
+    /*Hidden: the rows belong to something else, it must not scroll*/
+    if(!lv_obj_is_visible(scroll_cont)) {
+        scroll_y_last = y;
+        return;
+    }
+
+    scroll_pending += y - scroll_y_last;
+    scroll_y_last = y;
+
+    /*lv_obj_invalidate() of the container follows right after this event*/
+    scroll_trim = LV_ABS(scroll_pending) < scroll_height;
+}
+
+static void scroll_delete_cb(lv_event_t *e)
+{
+    lv_area_t area;
+
+    LV_UNUSED(e);
+
+    /*The rows are rotated in GRAM, redraw them in place*/
+    lv_area_set(&area, 0, scroll_top, TFT_HOR_RES - 1, scroll_top + scroll_height - 1);
+
+    scroll_cont = NULL;
+    scroll_height = 0;
+    scroll_offset = 0;
+    scroll_pending = 0;
+    scroll_trim = false;
+
+    lcd_scroll_set_area(0, TFT_VER_RES);
+    lv_inv_area(scroll_disp, &area);
+}
+
+/* Shrink the container's invalidation to the exposed rows */
+static void invalidate_cb(lv_event_t *e)
+{
+    lv_area_t *area = lv_event_get_param(e);
+    int32_t rows;
+
+    if(!scroll_trim) return;
+    scroll_trim = false;
+
+    if(area->y1 > scroll_top || area->y2 < scroll_top + scroll_height - 1) return;
+
+    rows = LV_MAX(LV_ABS(scroll_pending), 1);
+    area->x1 = 0;
+    area->x2 = TFT_HOR_RES - 1;
+    if(scroll_pending > 0) {
+        area->y2 = scroll_top + scroll_height - 1;
+        area->y1 = area->y2 - rows + 1;
+    }
+    else {
+        area->y1 = scroll_top;
+        area->y2 = scroll_top + rows - 1;
+    }
+}
+
+/* Move the ring start before the exposed rows are flushed */
+static void render_start_cb(lv_event_t *e)
+{
+    LV_UNUSED(e);
+
+    if(scroll_height == 0 || scroll_pending == 0) return;
+
+    scroll_offset = ((scroll_offset + scroll_pending) % scroll_height + scroll_height) % scroll_height;
+    scroll_pending = 0;
+    lcd_scroll_set_offset(scroll_offset);
+}
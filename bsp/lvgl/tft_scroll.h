@@ -0,0 +1,36 @@
+/**
+ * @file tft_scroll.h
+ *
+ */
+
+#ifndef TFT_SCROLL_H
+#define TFT_SCROLL_H
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include "lvgl.h"
+#include "lcd.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void tft_scroll_init(lv_display_t *disp);
+void tft_scroll_attach(lv_obj_t *cont);
+void tft_scroll_write_area(const lv_area_t *area, uint8_t *px_map, lcd_xfer_done_cb_t done_cb);
+void tft_scroll_fill_area(const lv_area_t *area, uint32_t rgb888);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif
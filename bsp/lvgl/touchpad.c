@@ -7,6 +7,7 @@
  *      INCLUDES
  *********************/
 #include "tft.h"
+#include "touchpad.h"
 #include "lvgl/lvgl.h"
 
 #include "stm32f4xx.h"
@@ -23,10 +24,14 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static void touchpad_read(lv_indev_t * indev, lv_indev_data_t * data);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+static lv_timer_t * read_timer;
+static uint32_t idle_reads;
+static bool read_paused;
 
 /**********************
  *      MACROS
@@ -46,8 +51,58 @@ void touchpad_init(void)
   // Create a new input device
   lv_indev_t * indev = lv_indev_create();
   lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
-  lv_indev_set_read_cb(indev, xpt2046_read);
+  lv_indev_set_read_cb(indev, touchpad_read);
 
+  read_timer = lv_indev_get_read_timer(indev);
+}
+
+/**
+ * Wake the touch reads when a new touch was sampled.
+ * Call it from the main loop before lv_timer_handler().
+ */
+void touchpad_handler(void)
+{
+#if USE_TSC_PENIRQ
+    if(read_paused && xpt2046_has_samples()) {
+        read_paused = false;
+        lv_timer_set_period(read_timer, TOUCHPAD_ACTIVE_MS);
+        lv_timer_resume(read_timer);
+        lv_timer_ready(read_timer);
+    }
+#endif
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Read the touch and adapt the read period: fast while touched, then back
+ * off. With PENIRQ the reads stop until touchpad_handler() sees a new touch.
+ */
+static void touchpad_read(lv_indev_t * indev, lv_indev_data_t * data)
+{
+    xpt2046_read(indev, data);
+
+    if(data->state == LV_INDEV_STATE_PRESSED || data->continue_reading) {
+        idle_reads = 0;
+        lv_timer_set_period(read_timer, TOUCHPAD_ACTIVE_MS);
+        return;
+    }
+
+    if(idle_reads < TOUCHPAD_IDLE_READS) {
+        idle_reads++;
+        return;
+    }
+
+#if USE_TSC_PENIRQ
+    if(!xpt2046_has_samples()) {
+        read_paused = true;
+        lv_timer_pause(read_timer);
+    }
+#else
+    lv_timer_set_period(read_timer, TOUCHPAD_IDLE_MS);
+#endif
 }
 
 
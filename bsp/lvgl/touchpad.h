@@ -15,6 +15,9 @@
 /*********************
  *      DEFINES
  *********************/
+#define TOUCHPAD_ACTIVE_MS		10		/*Read period while touched*/
+#define TOUCHPAD_IDLE_MS		100		/*Read period while idle, if PENIRQ can't wake the reads*/
+#define TOUCHPAD_IDLE_READS		3		/*Released reads before backing off*/
 
 /**********************
  *      TYPEDEFS
@@ -24,6 +27,7 @@
  * GLOBAL PROTOTYPES
  **********************/
 void touchpad_init(void);
+void touchpad_handler(void);
 
 /**********************
  *      MACROS
@@ -0,0 +1,234 @@
+/**
+ * @file touchpad_cal.c
+ *
+ * Touch calibration screen. The user taps TOUCHPAD_CAL_POINTS targets, the
+ * averaged raw readings are fitted to an affine matrix, which is handed to
+ * the XPT2046 driver and saved to flash.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "touchpad_cal.h"
+#include "lvgl/lvgl.h"
+
+#include "../lcd/tsc/XPT2046.h"
+#include "../lcd/tsc/touch_calib.h"
+#include "../lcd/tsc/touch_cal_flash.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#if TOUCHPAD_CAL_POINTS < 3 || TOUCHPAD_CAL_POINTS > 5
+#error "TOUCHPAD_CAL_POINTS must be 3, 4 or 5"
+#endif
+
+#define CROSS_LEN       15
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void cal_target_pos(uint8_t i, int32_t * x, int32_t * y);
+static void cal_show_target(void);
+static void cal_finish(void);
+static void cal_event_cb(lv_event_t * e);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_obj_t * cal_scr;
+static lv_obj_t * prev_scr;
+static lv_obj_t * cross_h;
+static lv_obj_t * cross_v;
+static lv_obj_t * info;
+
+static touch_cal_point_t points[TOUCHPAD_CAL_POINTS];
+static uint8_t point_idx;
+static int32_t sum_x;
+static int32_t sum_y;
+static uint32_t reads;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Give the XPT2046 driver the calibration saved in flash
+ * @return false if there is none, the compile time range stays in use
+ */
+bool touchpad_cal_load(void)
+{
+    touch_cal_t cal;
+
+    if(!touch_cal_load(&cal)) return false;
+
+    xpt2046_set_cal(&cal);
+    return true;
+}
+
+/**
+ * Show the calibration screen on top of the active one.
+ * That one is loaded again when the calibration is done.
+ */
+void touchpad_cal_start(void)
+{
+    if(cal_scr) return;
+
+    prev_scr = lv_screen_active();
+
+    cal_scr = lv_obj_create(NULL);
+    lv_obj_remove_flag(cal_scr, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_style_bg_color(cal_scr, lv_color_black(), 0);
+    lv_obj_add_event_cb(cal_scr, cal_event_cb, LV_EVENT_ALL, NULL);
+
+    info = lv_label_create(cal_scr);
+    lv_obj_set_style_text_color(info, lv_color_white(), 0);
+    lv_obj_set_style_text_align(info, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_align(info, LV_ALIGN_CENTER, 0, -40);
+
+    cross_h = lv_obj_create(cal_scr);
+    cross_v = lv_obj_create(cal_scr);
+    lv_obj_set_size(cross_h, CROSS_LEN * 2 + 1, 1);
+    lv_obj_set_size(cross_v, 1, CROSS_LEN * 2 + 1);
+
+    lv_obj_t * cross[2] = {cross_h, cross_v};
+    uint8_t i;
+    for(i = 0; i < 2; i++) {
+        lv_obj_remove_style_all(cross[i]);
+        lv_obj_set_style_bg_opa(cross[i], LV_OPA_COVER, 0);
+        lv_obj_set_style_bg_color(cross[i], lv_palette_main(LV_PALETTE_RED), 0);
+        lv_obj_remove_flag(cross[i], LV_OBJ_FLAG_CLICKABLE);
+    }
+
+    point_idx = 0;
+    cal_show_target();
+
+    lv_screen_load(cal_scr);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void cal_target_pos(uint8_t i, int32_t * x, int32_t * y)
+{
+    int32_t hor = lv_display_get_horizontal_resolution(NULL);
+    int32_t ver = lv_display_get_vertical_resolution(NULL);
+    int32_t l = TOUCHPAD_CAL_INSET;
+    int32_t r = hor - 1 - TOUCHPAD_CAL_INSET;
+    int32_t t = TOUCHPAD_CAL_INSET;
+    int32_t b = ver - 1 - TOUCHPAD_CAL_INSET;
+
+#if TOUCHPAD_CAL_POINTS == 3
+    /*Spread over the screen, not on one line*/
+    const int32_t tx[3] = {l, r, hor / 2};
+    const int32_t ty[3] = {t, ver / 2, b};
+#else
+    /*The corners, then the center*/
+    const int32_t tx[5] = {l, r, r, l, hor / 2};
+    const int32_t ty[5] = {t, t, b, b, ver / 2};
+#endif
+
+    *x = tx[i];
+    *y = ty[i];
+}
+
+static void cal_show_target(void)
+{
+    int32_t x, y;
+
+    cal_target_pos(point_idx, &x, &y);
+    lv_obj_set_pos(cross_h, x - CROSS_LEN, y);
+    lv_obj_set_pos(cross_v, x, y - CROSS_LEN);
+
+    lv_label_set_text_fmt(info, "Touch calibration\nTap the cross %d/%d",
+                          point_idx + 1, TOUCHPAD_CAL_POINTS);
+
+    sum_x = 0;
+    sum_y = 0;
+    reads = 0;
+}
+
+/**
+ * Fit the matrix and check it against the targets. A fit that misses one
+ * of them by more than TOUCHPAD_CAL_MAX_ERR starts the calibration over.
+ */
+static void cal_finish(void)
+{
+    touch_cal_t cal;
+    uint8_t i;
+
+    if(!touch_cal_solve(&cal, points, TOUCHPAD_CAL_POINTS)) {
+        LV_LOG_WARN("touch calibration: the points don't fit a mapping");
+        point_idx = 0;
+        cal_show_target();
+        return;
+    }
+
+    for(i = 0; i < TOUCHPAD_CAL_POINTS; i++) {
+        int16_t x = points[i].raw_x;
+        int16_t y = points[i].raw_y;
+
+        touch_cal_apply(&cal, &x, &y);
+        if(LV_ABS(x - points[i].x) > TOUCHPAD_CAL_MAX_ERR ||
+           LV_ABS(y - points[i].y) > TOUCHPAD_CAL_MAX_ERR) {
+            LV_LOG_WARN("touch calibration: target %d is off by (%d,%d)",
+                        i, x - points[i].x, y - points[i].y);
+            point_idx = 0;
+            cal_show_target();
+            return;
+        }
+    }
+
+    xpt2046_set_cal(&cal);
+    if(!touch_cal_save(&cal)) LV_LOG_WARN("touch calibration: saving to flash failed");
+
+    LV_LOG_USER("touch calibration: %ld %ld %ld / %ld %ld %ld",
+                (long)cal.a, (long)cal.b, (long)cal.c, (long)cal.d, (long)cal.e, (long)cal.f);
+
+    lv_screen_load(prev_scr);
+    lv_obj_delete_async(cal_scr);
+    cal_scr = NULL;
+}
+
+static void cal_event_cb(lv_event_t * e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+
+    if(code == LV_EVENT_PRESSING) {
+        int16_t x, y;
+
+        /*The driver has already mapped it with the old matrix, take the raw one*/
+        xpt2046_get_raw(&x, &y);
+        sum_x += x;
+        sum_y += y;
+        reads++;
+    }
+    else if(code == LV_EVENT_RELEASED) {
+        int32_t x, y;
+
+        /*A tap too short to be averaged, wait for another one*/
+        if(reads < TOUCHPAD_CAL_MIN_READS) {
+            cal_show_target();
+            return;
+        }
+
+        cal_target_pos(point_idx, &x, &y);
+        points[point_idx].raw_x = (int16_t)(sum_x / (int32_t)reads);
+        points[point_idx].raw_y = (int16_t)(sum_y / (int32_t)reads);
+        points[point_idx].x = (int16_t)x;
+        points[point_idx].y = (int16_t)y;
+
+        point_idx++;
+        if(point_idx < TOUCHPAD_CAL_POINTS) cal_show_target();
+        else cal_finish();
+    }
+}
@@ -0,0 +1,36 @@
+/**
+ * @file touchpad_cal.h
+ *
+ */
+
+#ifndef TOUCHPAD_CAL_H
+#define TOUCHPAD_CAL_H
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TOUCHPAD_CAL_POINTS		5		/*3: exact fit, 4..5: least squares*/
+#define TOUCHPAD_CAL_INSET		20		/*Distance of the targets from the edges [px]*/
+#define TOUCHPAD_CAL_MIN_READS	5		/*Reads a target needs to count*/
+#define TOUCHPAD_CAL_MAX_ERR	8		/*Retry if a target is off by more [px]*/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+bool touchpad_cal_load(void);
+void touchpad_cal_start(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif
@@ -0,0 +1,37 @@
+/**
+ * @file test_main.c
+ * Host runner for one module self-test, see CMakeLists.txt.
+ * TEST_FUNC names the test function, the exit code is 0 when it passes.
+ */
+
+#include <stdio.h>
+#include "debug_test.h"
+
+#define TEST_STR_(x)    #x
+#define TEST_STR(x)     TEST_STR_(x)
+
+uint32_t TEST_FUNC(void);
+
+/*The host stands in for the HAL_PICO tick, the tests install their own clock*/
+uint32_t tick_timer(void)
+{
+    return 0;
+}
+
+void debug_test_report(const char * name, uint32_t failed_line)
+{
+    if(failed_line == 0) {
+        printf("%s passed\n", name);
+    }
+    else {
+        printf("%s FAILED at line %lu\n", name, (unsigned long)failed_line);
+    }
+}
+
+int main(void)
+{
+    uint32_t failed_line = TEST_FUNC();
+
+    debug_test_report(TEST_STR(TEST_FUNC), failed_line);
+    return failed_line == 0 ? 0 : 1;
+}